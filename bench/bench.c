@@ -0,0 +1,201 @@
+/*
+ * This file, `bench.c`, contains the harness of the benchmark suite.
+ *
+ * NOTE:
+ *  The harness does not depend on SDL, so that the benchmarks of the game
+ *  core can run on machines without SDL or without a display.
+ */
+
+#include "stdbool.h"
+#include "stdint.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+
+#if defined(_WIN32)
+#include "windows.h"
+#endif
+
+#include "bench.h"
+
+uint64_t bench_now_ns(void) {
+    /*
+     * A function that returns the time of a monotonic, high resolution clock,
+     * in nanoseconds.
+     */
+
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) ((double) counter.QuadPart * 1e9 / (double) frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+#endif
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int count, double fraction) {
+    /*
+     * A helper function that returns the nearest-rank percentile of the
+     * `sorted` samples.
+     */
+
+    int rank = (int) (fraction * count + 0.5);
+    if (rank < 1)
+        rank = 1;
+    if (rank > count)
+        rank = count;
+    return sorted[rank - 1];
+}
+
+void bench_suite_init(BenchSuite *suite, const char *filter, int number_of_samples) {
+    suite->filter = filter;
+    suite->number_of_samples = number_of_samples > 0 ? number_of_samples : DEFAULT_NUMBER_OF_SAMPLES;
+    suite->number_of_results = 0;
+}
+
+bool bench_is_selected(const BenchSuite *suite, const char *name) {
+    /*
+     * A function that checks whether the benchmark `name` is selected by the
+     * filter of the suite, so that expensive setups can be skipped.
+     */
+    return !suite->filter || strstr(name, suite->filter) != NULL;
+}
+
+static uint64_t time_operations(BenchOperation operation, void *context, long count) {
+    uint64_t start = bench_now_ns();
+    for (long i=0; i<count; i++) {
+        operation(context);
+    }
+    return bench_now_ns() - start;
+}
+
+bool bench_run(BenchSuite *suite, const char *name, BenchOperation operation, void *context) {
+    /*
+     * A function that times `operation` and adds its result to the suite.
+     *
+     * params
+     *      BenchSuite *suite
+     *          A pointer to the struct BenchSuite that receives the result
+     *      const char *name
+     *          The name of the benchmark, e.g. "generate_board/foods=2"
+     *      BenchOperation operation
+     *          The operation to be timed
+     *      void *context
+     *          Passed to every call of `operation`
+     * returns
+     *      false if the benchmark was not selected, or there is no room left
+     *      for its result
+     *
+     * NOTE:
+     *  The number of operations per sample is doubled until a sample takes
+     *  at least MIN_SAMPLE_DURATION_NS. This also warms up the caches and
+     *  the branch predictor before the timed samples. The percentiles are
+     *  taken over the samples, i.e. over the average of each batch.
+     */
+
+    if (!bench_is_selected(suite, name) || suite->number_of_results >= MAX_NUMBER_OF_BENCHMARKS)
+        return false;
+
+    long operations_per_sample = 1;
+    while (time_operations(operation, context, operations_per_sample) < MIN_SAMPLE_DURATION_NS) {
+        operations_per_sample *= 2;
+    }
+
+    int number_of_samples = suite->number_of_samples;
+    double *samples = malloc(sizeof(double) * number_of_samples);
+    uint64_t total_ns = 0;
+
+    for (int i=0; i<number_of_samples; i++) {
+        uint64_t elapsed = time_operations(operation, context, operations_per_sample);
+        total_ns += elapsed;
+        samples[i] = (double) elapsed / (double) operations_per_sample;
+    }
+    qsort(samples, number_of_samples, sizeof(double), compare_doubles);
+
+    BenchResult *result = &suite->results[suite->number_of_results++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->number_of_samples = number_of_samples;
+    result->operations_per_sample = operations_per_sample;
+    result->mean_ns = (double) total_ns / ((double) number_of_samples * operations_per_sample);
+    result->min_ns = samples[0];
+    result->p50_ns = percentile(samples, number_of_samples, 0.50);
+    result->p90_ns = percentile(samples, number_of_samples, 0.90);
+    result->p99_ns = percentile(samples, number_of_samples, 0.99);
+    result->max_ns = samples[number_of_samples - 1];
+    result->operations_per_second = result->mean_ns > 0 ? 1e9 / result->mean_ns : 0;
+    result->draw_calls = -1;
+
+    free(samples);
+
+    // Show progress, since some benchmarks take a few seconds
+    fprintf(stderr, "%-40s %12.1f ns/op\n", result->name, result->mean_ns);
+    return true;
+}
+
+void bench_record_draw_calls(BenchSuite *suite, int draw_calls) {
+    /*
+     * A function that records the number of draw calls of the benchmark that
+     * was run last, for benchmarks that draw a frame.
+     */
+
+    if (suite->number_of_results > 0)
+        suite->results[suite->number_of_results - 1].draw_calls = draw_calls;
+}
+
+void bench_print_table(const BenchSuite *suite, FILE *file) {
+    /*
+     * A function that prints the results as a table that is easy to read.
+     */
+
+    fprintf(file, "\n%-40s %12s %12s %12s %12s %14s %8s\n", "benchmark", "ns/op", "p50", "p90", "p99", "ops/s", "draws");
+    for (int i=0; i<suite->number_of_results; i++) {
+        const BenchResult *result = &suite->results[i];
+        fprintf(file, "%-40s %12.1f %12.1f %12.1f %12.1f %14.0f", result->name, result->mean_ns,
+                result->p50_ns, result->p90_ns, result->p99_ns, result->operations_per_second);
+        if (result->draw_calls >= 0)
+            fprintf(file, " %8d\n", result->draw_calls);
+        else
+            fprintf(file, " %8s\n", "-");
+    }
+}
+
+void bench_write_json(const BenchSuite *suite, FILE *file) {
+    /*
+     * A function that writes the results as JSON, so that runs can be
+     * compared over time by other tools.
+     *
+     * NOTE:
+     *  Benchmark names never contain characters that must be escaped.
+     */
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"schema\": \"ghostless-pacman-bench/1\",\n");
+    fprintf(file, "  \"timestamp\": %lld,\n", (long long) time(NULL));
+    fprintf(file, "  \"samples_per_benchmark\": %d,\n", suite->number_of_samples);
+    fprintf(file, "  \"benchmarks\": [");
+
+    for (int i=0; i<suite->number_of_results; i++) {
+        const BenchResult *result = &suite->results[i];
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"samples\": %d, \"ops_per_sample\": %ld, "
+                      "\"ns_per_op\": %.2f, \"min_ns\": %.2f, \"p50_ns\": %.2f, \"p90_ns\": %.2f, "
+                      "\"p99_ns\": %.2f, \"max_ns\": %.2f, \"ops_per_sec\": %.1f",
+                i == 0 ? "" : ",", result->name, result->number_of_samples, result->operations_per_sample,
+                result->mean_ns, result->min_ns, result->p50_ns, result->p90_ns,
+                result->p99_ns, result->max_ns, result->operations_per_second);
+        if (result->draw_calls >= 0)
+            fprintf(file, ", \"draw_calls\": %d", result->draw_calls);
+        fprintf(file, "}");
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+}
@@ -0,0 +1,80 @@
+/*
+ *  This file, 'bench.h', declares the harness of the benchmark suite. It
+ *  times an operation over many samples and reports the time per operation,
+ *  the throughput and the percentiles of every benchmark.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "stdbool.h"
+#include "stdint.h"
+#include "stdio.h"
+
+// The most benchmarks a single run can report
+#define MAX_NUMBER_OF_BENCHMARKS 64
+#define MAX_BENCHMARK_NAME_LENGTH 64
+
+// The default number of timed samples per benchmark
+#define DEFAULT_NUMBER_OF_SAMPLES 200
+
+// Each sample runs the operation enough times to take at least this long, so
+// that the resolution of the clock does not matter
+#define MIN_SAMPLE_DURATION_NS 50000
+
+/*
+ * BenchOperation is a single operation to be timed, such as generating one
+ * board. `context` holds whatever state the operation needs between calls.
+ */
+typedef void (*BenchOperation)(void *context);
+
+/*
+ * BenchResult holds the timings of a single benchmark. All times are in
+ * nanoseconds per operation.
+ */
+typedef struct BenchResult {
+    char            name[MAX_BENCHMARK_NAME_LENGTH];
+    int             number_of_samples;
+    long            operations_per_sample;
+    double          mean_ns;
+    double          min_ns;
+    double          p50_ns;
+    double          p90_ns;
+    double          p99_ns;
+    double          max_ns;
+    double          operations_per_second;
+    // The draw calls of the last operation, or -1 if it draws nothing
+    int             draw_calls;
+} BenchResult;
+
+/*
+ * BenchSuite holds the options of a run, and the results of every
+ * benchmark that was run so far.
+ */
+typedef struct BenchSuite {
+    // Only benchmarks whose name contains `filter` are run, unless NULL
+    const char      *filter;
+    int             number_of_samples;
+    BenchResult     results[MAX_NUMBER_OF_BENCHMARKS];
+    int             number_of_results;
+} BenchSuite;
+
+uint64_t bench_now_ns(void);
+
+void bench_suite_init(BenchSuite *suite, const char *filter, int number_of_samples);
+
+bool bench_is_selected(const BenchSuite *suite, const char *name);
+
+bool bench_run(BenchSuite *suite, const char *name, BenchOperation operation, void *context);
+
+void bench_record_draw_calls(BenchSuite *suite, int draw_calls);
+
+void bench_print_table(const BenchSuite *suite, FILE *file);
+
+void bench_write_json(const BenchSuite *suite, FILE *file);
+
+void run_core_benchmarks(BenchSuite *suite);
+
+bool run_frontend_benchmarks(BenchSuite *suite);
+
+#endif // !BENCH_H
@@ -0,0 +1,160 @@
+/*
+ * This file, `bench_core.c`, contains the benchmarks of the headless game
+ * core: generating, solving and playing boards.
+ */
+
+#include "stdbool.h"
+#include "stdint.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+#include "bench.h"
+#include "core/board.h"
+#include "core/route_table.h"
+#include "core/solver.h"
+
+// The number of different boards each benchmark cycles through
+#define CORPUS_SIZE 64
+
+// Every benchmark run uses the same boards
+#define CORPUS_SEED 20211203u
+
+/*
+ * BoardCorpus is a fixed set of boards, each with the moves of an optimal
+ * route, so that moves can be replayed without losing the game.
+ */
+typedef struct BoardCorpus {
+    Board           boards[CORPUS_SIZE];
+    enum PacmanMove routes[CORPUS_SIZE][BOARD_NUMBER_OF_CELLS * 2];
+    int             route_lengths[CORPUS_SIZE];
+    // The board and move the next operation works on
+    Board           board;
+    int             current_board;
+    int             current_move;
+    int             current_cell;
+} BoardCorpus;
+
+static RouteTable route_table;
+
+static void build_corpus(BoardCorpus *corpus, int number_of_foods) {
+    /*
+     * A helper function that generates the boards of the corpus and records
+     * an optimal route for each of them.
+     */
+
+    for (int i=0; i<CORPUS_SIZE; i++) {
+        Board *board = &corpus->boards[i];
+        generate_board(board, number_of_foods, CORPUS_SEED + (uint64_t) i);
+
+        Board replay = *board;
+        build_route_table(&route_table, &replay);
+        replay.route_table = &route_table;
+
+        corpus->route_lengths[i] = 0;
+        enum GameState game_state = GAME_IN_PROGRESS;
+        enum PacmanMove move;
+        while (game_state == GAME_IN_PROGRESS && route_table_next_step(&route_table, replay.pacman_position, &move)) {
+            corpus->routes[i][corpus->route_lengths[i]++] = move;
+            game_state = resolve_move(&replay, move).game_state;
+        }
+    }
+
+    corpus->board = corpus->boards[0];
+    corpus->current_board = 0;
+    corpus->current_move = 0;
+    corpus->current_cell = 0;
+}
+
+static Board* next_corpus_board(BoardCorpus *corpus) {
+    corpus->current_board = (corpus->current_board + 1) % CORPUS_SIZE;
+    return &corpus->boards[corpus->current_board];
+}
+
+static void restart_route_if_finished(BoardCorpus *corpus) {
+    /*
+     * A helper function that moves on to the next board of the corpus once
+     * every move of the current route was made.
+     *
+     * NOTE:
+     *  Copying the board is part of the timed operation, but happens only
+     *  once every 10 to 40 moves.
+     */
+
+    if (corpus->current_move < corpus->route_lengths[corpus->current_board])
+        return;
+
+    corpus->board = *next_corpus_board(corpus);
+    corpus->current_move = 0;
+}
+
+typedef struct GenerateContext {
+    Board       board;
+    int         number_of_foods;
+    uint64_t    seed;
+} GenerateContext;
+
+static void bench_generate_board(void *context) {
+    GenerateContext *generate = context;
+    generate_board(&generate->board, generate->number_of_foods, generate->seed++);
+}
+
+static void bench_solve_board(void *context) {
+    BoardSolution solution;
+    solve_board(next_corpus_board(context), &solution);
+}
+
+static void bench_build_route_table(void *context) {
+    build_route_table(&route_table, next_corpus_board(context));
+}
+
+static void bench_count_impassable_neighbors(void *context) {
+    BoardCorpus *corpus = context;
+
+    int cell = corpus->current_cell;
+    corpus->current_cell = (cell + 1) % BOARD_NUMBER_OF_CELLS;
+    if (corpus->current_cell == 0)
+        next_corpus_board(corpus);
+
+    count_impassable_neighbors(&corpus->boards[corpus->current_board], cell / BOARD_SIZE, cell % BOARD_SIZE);
+}
+
+static void bench_resolve_move(void *context) {
+    BoardCorpus *corpus = context;
+    restart_route_if_finished(corpus);
+    resolve_move(&corpus->board, corpus->routes[corpus->current_board][corpus->current_move++]);
+}
+
+void run_core_benchmarks(BenchSuite *suite) {
+    /*
+     * A function that runs every benchmark of the game core that is selected
+     * by the filter of the suite.
+     */
+
+    char name[MAX_BENCHMARK_NAME_LENGTH];
+
+    for (int number_of_foods=MIN_NUMBER_OF_FOOD; number_of_foods<=MAX_NUMBER_OF_FOOD; number_of_foods++) {
+        GenerateContext generate = {.number_of_foods=number_of_foods, .seed=CORPUS_SEED};
+        snprintf(name, sizeof(name), "generate_board/foods=%d", number_of_foods);
+        bench_run(suite, name, bench_generate_board, &generate);
+    }
+
+    BoardCorpus *corpus = malloc(sizeof(BoardCorpus));
+
+    for (int number_of_foods=MIN_NUMBER_OF_FOOD; number_of_foods<=MAX_NUMBER_OF_FOOD; number_of_foods++) {
+        snprintf(name, sizeof(name), "solve_board/foods=%d", number_of_foods);
+        if (bench_is_selected(suite, name)) {
+            build_corpus(corpus, number_of_foods);
+            bench_run(suite, name, bench_solve_board, corpus);
+        }
+    }
+
+    // The remaining benchmarks use boards with the most food pieces
+    build_corpus(corpus, MAX_NUMBER_OF_FOOD);
+    bench_run(suite, "build_route_table", bench_build_route_table, corpus);
+    bench_run(suite, "count_impassable_neighbors", bench_count_impassable_neighbors, corpus);
+
+    build_corpus(corpus, MAX_NUMBER_OF_FOOD);
+    bench_run(suite, "resolve_move", bench_resolve_move, corpus);
+
+    free(corpus);
+}
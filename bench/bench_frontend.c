@@ -0,0 +1,256 @@
+/*
+ * This file, `bench_frontend.c`, contains the benchmarks of the SDL
+ * frontend: loading the assets, starting a game, moving Pacman and rendering.
+ *
+ * NOTE:
+ *  Unless SDL_VIDEODRIVER and SDL_AUDIODRIVER are set, SDL's dummy drivers
+ *  are used, and the scene is drawn by the software renderer. This lets the
+ *  benchmarks run headless, e.g. on a build server. Run the benchmarks from
+ *  the bin/ folder, like the game, so that the assets are found.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+#include "bench.h"
+#include "assets.h"
+#include "declarations.h"
+#include "logic.h"
+#include "render_queue.h"
+#include "state.h"
+#include "utils.h"
+#include "core/random.h"
+#include "core/route_table.h"
+
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_mixer.h"
+
+// The texture memory the atlas pages may use, like in the game
+#define TEXTURE_BUDGET ((size_t) DEFAULT_TEXTURE_BUDGET_MB * 1024 * 1024)
+
+/*
+ * FrontendContext holds everything the frontend needs to run a game.
+ */
+typedef struct FrontendContext {
+    SDL_Window      *window;
+    SDL_Renderer    *renderer;
+    RenderQueue     *render_queue;
+    Assets          assets;
+    States          states;
+    Board           board;
+    // An optimal route through `start`, which `move_pacman` replays
+    Board           start;
+    RouteTable      start_route_table;
+    enum PacmanMove route[BOARD_NUMBER_OF_CELLS * 2];
+    int             route_length;
+    int             current_move;
+} FrontendContext;
+
+static void init_states(States *states) {
+    /*
+     * A helper function that sets up the states just like `main`, but
+     * without a board worker, so that every board is generated on demand.
+     */
+
+    states->player_state = PLAYER_IN_GAME;
+    states->game_state = GAME_IN_PROGRESS;
+    states->current_tutorial_page = 0;
+    states->wrong_input_state = WRONG_INPUT_NONE;
+    states->current_number_of_foods_picked = MAX_NUMBER_OF_FOOD;
+    states->current_menu_choice = PLAYER_CHOSE_NONE;
+    states->show_quit_confirmation = false;
+    states->player_wants_to_quit = false;
+    states->wrong_input_time = 0;
+    states->board_worker = NULL;
+    states->has_requested_seed = false;
+    states->show_hint = false;
+    states->quiet = true;
+    states->number_of_boards = 0;
+    states->board_generation_attempts = 0;
+    seed_random_generator(&states->seed_generator, 20211203u);
+}
+
+static void record_route(FrontendContext *frontend) {
+    /*
+     * A helper function that records an optimal route through the current
+     * board, and keeps a copy of the board to replay it on.
+     */
+
+    frontend->start = frontend->board;
+    frontend->route_length = 0;
+    frontend->current_move = 0;
+    build_route_table(&frontend->start_route_table, &frontend->start);
+
+    Board replay = frontend->start;
+    frontend->states.route_table = frontend->start_route_table;
+    replay.route_table = &frontend->states.route_table;
+
+    enum GameState game_state = GAME_IN_PROGRESS;
+    enum PacmanMove move;
+    while (game_state == GAME_IN_PROGRESS &&
+           route_table_next_step(&frontend->states.route_table, replay.pacman_position, &move)) {
+        frontend->route[frontend->route_length++] = move;
+        game_state = resolve_move(&replay, move).game_state;
+    }
+
+    // Set the game back to the start of the route
+    frontend->current_move = frontend->route_length;
+}
+
+static void bench_load_all_assets(void *context) {
+    FrontendContext *frontend = context;
+    Assets *assets = malloc(sizeof(Assets));
+    load_all_assets(assets, frontend->render_queue, TEXTURE_BUDGET);
+    free_all_assets(assets);
+    free(assets);
+}
+
+static void bench_first_frame(void *context) {
+    FrontendContext *frontend = context;
+    Assets *assets = malloc(sizeof(Assets));
+
+    // NOTE:
+    //  Like `main`, draw frames until the menu can be shown, then show it.
+    //  The assets that are still loading by then are cancelled.
+    start_loading_assets(assets, frontend->render_queue, TEXTURE_BUDGET);
+    States states = frontend->states;
+    states.player_state = PLAYER_IN_MENU;
+    do {
+        update_asset_loading(assets);
+        SDL_RenderClear(frontend->renderer);
+        render_state(&states, &frontend->board, assets);
+        SDL_RenderPresent(frontend->renderer);
+    } while (!is_menu_ready(assets));
+
+    free_all_assets(assets);
+    free(assets);
+}
+
+static void bench_init_board(void *context) {
+    FrontendContext *frontend = context;
+    init_board(&frontend->board, &frontend->assets, &frontend->states);
+}
+
+static void bench_move_pacman(void *context) {
+    FrontendContext *frontend = context;
+
+    // NOTE:
+    //  Start the route over once the game was won. Copying the board and its
+    //  route is part of the timed operation, but happens only once per game.
+    if (frontend->current_move >= frontend->route_length) {
+        frontend->board = frontend->start;
+        frontend->states.route_table = frontend->start_route_table;
+        frontend->board.route_table = &frontend->states.route_table;
+        frontend->states.game_state = GAME_IN_PROGRESS;
+        frontend->current_move = 0;
+    }
+
+    move_pacman(frontend->route[frontend->current_move++], &frontend->assets, &frontend->board, &frontend->states);
+}
+
+static void bench_render_board(void *context) {
+    FrontendContext *frontend = context;
+    render_board(&frontend->board, &frontend->assets);
+    flush_render_queue(frontend->render_queue);
+}
+
+static void bench_render_state(void *context) {
+    FrontendContext *frontend = context;
+    SDL_RenderClear(frontend->renderer);
+    render_state(&frontend->states, &frontend->board, &frontend->assets);
+}
+
+static void bench_render_frame(void *context) {
+    FrontendContext *frontend = context;
+    SDL_RenderClear(frontend->renderer);
+    render_state(&frontend->states, &frontend->board, &frontend->assets);
+    SDL_RenderPresent(frontend->renderer);
+}
+
+bool run_frontend_benchmarks(BenchSuite *suite) {
+    /*
+     * A function that runs every benchmark of the frontend that is selected
+     * by the filter of the suite.
+     *
+     * returns
+     *      false if SDL could not be started
+     */
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+    init_SDL(AUDIO_CHUNK_SIZE);
+
+    FrontendContext *frontend = malloc(sizeof(FrontendContext));
+    frontend->window = create_window();
+    if (!frontend->window) {
+        free(frontend);
+        return false;
+    }
+
+    // NOTE:
+    //  The software renderer is used instead of `create_renderer`, since it
+    //  works without a display and is not throttled by vsync.
+    frontend->renderer = SDL_CreateRenderer(frontend->window, -1, SDL_RENDERER_SOFTWARE);
+    if (!frontend->renderer) {
+        printf("Error creating renderer: %s\n", SDL_GetError());
+        SDL_DestroyWindow(frontend->window);
+        free(frontend);
+        return false;
+    }
+    SDL_SetRenderDrawColor(frontend->renderer, 24, 28, 36, 1);
+
+    frontend->render_queue = create_render_queue(frontend->renderer);
+    load_all_assets(&frontend->assets, frontend->render_queue, TEXTURE_BUDGET);
+    init_states(&frontend->states);
+
+    // Loading every image and sound is most of the time it takes to start,
+    // but the menu is shown as soon as its own images are loaded
+    bench_run(suite, "load_all_assets", bench_load_all_assets, frontend);
+    bench_run(suite, "first_frame", bench_first_frame, frontend);
+
+    char name[MAX_BENCHMARK_NAME_LENGTH];
+    for (int number_of_foods=MIN_NUMBER_OF_FOOD; number_of_foods<=MAX_NUMBER_OF_FOOD; number_of_foods++) {
+        frontend->states.current_number_of_foods_picked = number_of_foods;
+        snprintf(name, sizeof(name), "init_board/foods=%d", number_of_foods);
+        bench_run(suite, name, bench_init_board, frontend);
+    }
+
+    // Play on a board with the most food pieces from here on
+    frontend->states.current_number_of_foods_picked = MAX_NUMBER_OF_FOOD;
+    init_board(&frontend->board, &frontend->assets, &frontend->states);
+    record_route(frontend);
+
+    bench_run(suite, "move_pacman", bench_move_pacman, frontend);
+
+    // Render the board as it is at the start of the game
+    frontend->board = frontend->start;
+    frontend->states.route_table = frontend->start_route_table;
+    frontend->board.route_table = &frontend->states.route_table;
+
+    frontend->states.player_state = PLAYER_IN_GAME;
+    frontend->states.game_state = GAME_IN_PROGRESS;
+    if (bench_run(suite, "render_board", bench_render_board, frontend))
+        bench_record_draw_calls(suite, frontend->render_queue->draw_calls);
+    if (bench_run(suite, "render_state/game", bench_render_state, frontend))
+        bench_record_draw_calls(suite, frontend->render_queue->draw_calls);
+    if (bench_run(suite, "render_frame/game", bench_render_frame, frontend))
+        bench_record_draw_calls(suite, frontend->render_queue->draw_calls);
+
+    frontend->states.player_state = PLAYER_IN_MENU;
+    if (bench_run(suite, "render_state/menu", bench_render_state, frontend))
+        bench_record_draw_calls(suite, frontend->render_queue->draw_calls);
+    if (bench_run(suite, "render_frame/menu", bench_render_frame, frontend))
+        bench_record_draw_calls(suite, frontend->render_queue->draw_calls);
+
+    free_all_assets(&frontend->assets);
+    destroy_render_queue(frontend->render_queue);
+    SDL_DestroyRenderer(frontend->renderer);
+    SDL_DestroyWindow(frontend->window);
+    free(frontend);
+    Mix_CloseAudio();
+    IMG_Quit();
+    SDL_Quit();
+    return true;
+}
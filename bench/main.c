@@ -0,0 +1,66 @@
+/*
+ * This file, 'main.c', runs the benchmark suite.
+ *
+ * usage
+ *      ghostless-pacman-bench [--filter <text>] [--samples <n>] [--output <file>]
+ *
+ *      --filter    only run the benchmarks whose name contains <text>
+ *      --samples   the number of timed samples per benchmark (default 200)
+ *      --output    write the JSON results to <file> instead of stdout
+ *
+ * The JSON results go to stdout, while the progress and a readable table
+ * of the results go to stderr.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "bench.h"
+
+int main(int argc, char *argv[]) {
+    const char *filter = NULL;
+    const char *output = NULL;
+    int number_of_samples = DEFAULT_NUMBER_OF_SAMPLES;
+
+    for (int i=1; i<argc; i++) {
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "--filter") == 0 && has_value)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--samples") == 0 && has_value)
+            number_of_samples = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--output") == 0 && has_value)
+            output = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--filter <text>] [--samples <n>] [--output <file>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BenchSuite *suite = malloc(sizeof(BenchSuite));
+    bench_suite_init(suite, filter, number_of_samples);
+
+    run_core_benchmarks(suite);
+
+#ifdef BENCH_WITH_FRONTEND
+    if (!run_frontend_benchmarks(suite))
+        fprintf(stderr, "Skipped the frontend benchmarks, since SDL could not be started\n");
+#endif
+
+    bench_print_table(suite, stderr);
+
+    FILE *file = output ? fopen(output, "w") : stdout;
+    if (!file) {
+        fprintf(stderr, "Error opening %s\n", output);
+        free(suite);
+        return 1;
+    }
+    bench_write_json(suite, file);
+    if (output)
+        fclose(file);
+
+    free(suite);
+    return 0;
+}
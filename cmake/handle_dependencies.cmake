@@ -1,18 +1,22 @@
 
 include(FetchContent)
 
+# The SDL libraries are attached to this target, which the frontend of the game
+# and the tools that need SDL link to.
+add_library(${PROJECT_NAME}-sdl INTERFACE)
+
 # Handle Dependencies for MacOS
 if (APPLE) 
 
   # Add the include directory for SDL2
-  target_include_directories(${PROJECT_NAME} PRIVATE /opt/homebrew/include)
+  target_include_directories(${PROJECT_NAME}-sdl INTERFACE /opt/homebrew/include)
 
   # Define the _THREAD_SAFE macro
-  target_compile_definitions(${PROJECT_NAME} PRIVATE _THREAD_SAFE)
+  target_compile_definitions(${PROJECT_NAME}-sdl INTERFACE _THREAD_SAFE)
 
   # Link with the SDL2 library
-  target_link_directories(${PROJECT_NAME} PRIVATE /opt/homebrew/lib)
-  target_link_libraries(${PROJECT_NAME} PRIVATE SDL2 SDL2_image SDL2_mixer)
+  target_link_directories(${PROJECT_NAME}-sdl INTERFACE /opt/homebrew/lib)
+  target_link_libraries(${PROJECT_NAME}-sdl INTERFACE SDL2 SDL2_image SDL2_mixer)
 endif ()
 
 # Handle Dependencies for Linux
@@ -38,7 +42,7 @@ if (LINUX)
         ${SDL2_IMAGE_INCLUDE_DIRS}
         ${SDL2_MIXER_INCLUDE_DIRS}
     )
-    target_link_libraries(${PROJECT_NAME} 
+    target_link_libraries(${PROJECT_NAME}-sdl INTERFACE
         ${SDL2_LIBRARIES} 
         ${SDL2_IMAGE_LIBRARIES}
         ${SDL2_MIXER_LIBRARIES}
@@ -86,7 +90,7 @@ if (WIN32)
         ${PROJECT_SOURCE_DIR}/external/SDL2/${ARCH}/include/SDL2
         )
     target_link_libraries(
-        ${PROJECT_NAME}
+        ${PROJECT_NAME}-sdl INTERFACE
         ${PROJECT_SOURCE_DIR}/external/SDL2/${ARCH}/lib/libSDL2.dll.a
         ${PROJECT_SOURCE_DIR}/external/SDL2/${ARCH}/lib/libSDL2main.a
         ${PROJECT_SOURCE_DIR}/external/SDL2_image/${ARCH}/lib/libSDL2_image.dll.a
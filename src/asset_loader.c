@@ -0,0 +1,306 @@
+/*
+ *  This file, `asset_loader.c`, contains the pool of worker threads that
+ *  decode the images and sounds while the game starts, so that the render
+ *  thread only has to upload the decoded images into textures.
+ *
+ *  NOTE:
+ *      The jobs are taken by the workers in the order they were added, so the
+ *      assets the menu needs are added first. A job is handed back to the
+ *      render thread once it is decoded, in any order, through
+ *      `take_decoded_asset_job`.
+ */
+
+#include "stdio.h"
+#include "stdbool.h"
+#include "string.h"
+
+#include "asset_pack.h"
+#include "atlas.h"
+#include "trace.h"
+#include "declarations.h"
+#include "asset_loader.h"
+
+#include "SDL2/SDL.h"
+
+static Mix_Chunk* load_sound(const AssetPack *pack, const char *filename) {
+    /*
+     * A helper function that loads a sound from the asset pack, or from its
+     * WAV file if it is not in the pack.
+     *
+     * NOTE:
+     *  The sound plays straight from the mapped pack, without being copied.
+     *  The pack holds the samples in the format the audio device is asked
+     *  for, so the WAV file is used instead if the device got another one.
+     */
+
+    TraceZone zone = begin_trace_zone("load_sound");
+    const AssetPackEntry *entry = find_asset(pack, filename, ASSET_SOUND);
+
+    int frequency, channels;
+    Uint16 format;
+    if (entry && Mix_QuerySpec(&frequency, &format, &channels) &&
+        entry->frequency == (uint32_t) frequency && entry->audio_format == format && entry->channels == (uint32_t) channels) {
+        // Read the samples now, so that the first time the sound plays does
+        // not wait on the disk
+        touch_asset_data(pack, entry);
+
+        // SDL_mixer never writes to the samples of a chunk
+        Mix_Chunk *chunk = Mix_QuickLoad_RAW((Uint8 *) get_asset_data(pack, entry), (Uint32) entry->size);
+        if (chunk) {
+            end_trace_zone(zone);
+            return chunk;
+        }
+    }
+
+    Mix_Chunk *chunk = Mix_LoadWAV(filename);
+    if (!chunk)
+        printf("Error loading %s: %s\n", filename, Mix_GetError());
+    end_trace_zone(zone);
+    return chunk;
+}
+
+static Mix_Music* load_music(const AssetPack *pack, const char *filename) {
+    /*
+     * A helper function that opens the music from the asset pack, or from
+     * its own file if it is not in the pack.
+     *
+     * NOTE:
+     *  The music is streamed straight from the pack while it plays, so the
+     *  pack must stay open until the music is freed.
+     */
+
+    TraceZone zone = begin_trace_zone("load_music");
+    const AssetPackEntry *entry = find_asset(pack, filename, ASSET_MUSIC);
+    if (entry) {
+        SDL_RWops *stream = SDL_RWFromConstMem(get_asset_data(pack, entry), (int) entry->size);
+        Mix_Music *music = stream ? Mix_LoadMUS_RW(stream, 1) : NULL;
+        if (music) {
+            end_trace_zone(zone);
+            return music;
+        }
+    }
+
+    Mix_Music *music = Mix_LoadMUS(filename);
+    if (!music)
+        printf("Error loading %s: %s\n", filename, Mix_GetError());
+    end_trace_zone(zone);
+    return music;
+}
+
+static void decode_asset_job(const AssetPack *pack, AssetJob *job) {
+    /*
+     * A helper function that decodes the asset of a job, on whichever thread
+     * calls it, and marks the job as decoded.
+     */
+
+    switch (job->type) {
+        case ASSET_JOB_ATLAS_PAGE: {
+            TraceZone zone = begin_trace_zone("decode_atlas_page");
+            job->decoded_page = decode_atlas_page(pack, job->page);
+            end_trace_zone(zone);
+            break;
+        }
+        case ASSET_JOB_SOUND:
+            job->decoded_chunk = load_sound(pack, job->filename);
+            break;
+        case ASSET_JOB_MUSIC:
+            job->decoded_music = load_music(pack, job->filename);
+            break;
+    }
+
+    SDL_AtomicSet(&job->is_decoded, 1);
+}
+
+static int run_asset_worker(void *data) {
+    /*
+     * The function run by every worker thread. It decodes the next job that
+     * no other worker took, until there are none left or the loader is
+     * stopped.
+     *
+     * params
+     *      void *data
+     *          A pointer to the struct AssetLoader that owns the thread
+     */
+
+    AssetLoader *loader = data;
+
+    while (!SDL_AtomicGet(&loader->is_cancelled)) {
+        int index = SDL_AtomicAdd(&loader->next_job, 1);
+        if (index >= loader->number_of_jobs)
+            break;
+
+        decode_asset_job(loader->pack, &loader->jobs[index]);
+        SDL_SemPost(loader->job_decoded);
+    }
+    return 0;
+}
+
+void init_asset_loader(AssetLoader *loader, const AssetPack *pack) {
+    /*
+     * A function that prepares a loader without any jobs or workers.
+     *
+     * params
+     *      AssetLoader *loader
+     *          A pointer to the struct AssetLoader, which must not move until
+     *          `stop_asset_loader` is called
+     *      const AssetPack *pack
+     *          A pointer to the struct AssetPack the assets are loaded from
+     */
+
+    memset(loader, 0, sizeof(AssetLoader));
+    loader->pack = pack;
+    SDL_AtomicSet(&loader->next_job, 0);
+    SDL_AtomicSet(&loader->is_cancelled, 0);
+}
+
+AssetJob* add_asset_job(AssetLoader *loader, enum AssetJobType type, bool is_needed_by_menu) {
+    /*
+     * A function that adds a job to a loader that was not started yet.
+     *
+     * params
+     *      AssetLoader *loader
+     *          A pointer to the struct AssetLoader
+     *      enum AssetJobType type
+     *          The kind of asset to be decoded
+     *      bool is_needed_by_menu
+     *          Whether the menu waits for this asset
+     * returns
+     *      the new job, whose asset is then filled in by the caller, or NULL
+     *      if the loader has no room left
+     */
+
+    if (loader->number_of_jobs == MAX_ASSET_JOBS) {
+        printf("Error adding asset job: there are more than %d assets\n", MAX_ASSET_JOBS);
+        return NULL;
+    }
+
+    AssetJob *job = &loader->jobs[loader->number_of_jobs++];
+    memset(job, 0, sizeof(AssetJob));
+    job->type = type;
+    job->is_needed_by_menu = is_needed_by_menu;
+    SDL_AtomicSet(&job->is_decoded, 0);
+
+    if (is_needed_by_menu)
+        loader->number_of_menu_jobs_left++;
+    return job;
+}
+
+void start_asset_loader(AssetLoader *loader) {
+    /*
+     * A function that starts the workers, which begin decoding the jobs
+     * right away. It does not wait for any of them.
+     *
+     * NOTE:
+     *  One core is left to the render thread. Without any worker, e.g. when
+     *  no thread can be created, every job is decoded when it is taken.
+     */
+
+    int number_of_workers = SDL_GetCPUCount() - 1;
+    if (number_of_workers > MAX_ASSET_WORKERS)
+        number_of_workers = MAX_ASSET_WORKERS;
+    if (number_of_workers > loader->number_of_jobs)
+        number_of_workers = loader->number_of_jobs;
+    if (number_of_workers < 1)
+        number_of_workers = 1;
+
+    loader->job_decoded = SDL_CreateSemaphore(0);
+    if (!loader->job_decoded) {
+        printf("Error creating asset workers: %s\n", SDL_GetError());
+        return;
+    }
+
+    for (int i=0; i<number_of_workers; i++) {
+        SDL_Thread *worker = SDL_CreateThread(run_asset_worker, "asset_worker", loader);
+        if (!worker) {
+            printf("Error creating asset worker: %s\n", SDL_GetError());
+            break;
+        }
+        loader->workers[loader->number_of_workers++] = worker;
+    }
+}
+
+AssetJob* take_decoded_asset_job(AssetLoader *loader, bool wait) {
+    /*
+     * A function that takes a decoded job, so that its asset can be handed
+     * over on the render thread.
+     *
+     * params
+     *      AssetLoader *loader
+     *          A pointer to the struct AssetLoader
+     *      bool wait
+     *          Whether to wait for a job to be decoded when none is ready
+     * returns
+     *      the job, which is marked as done, or NULL if none is ready or
+     *      every job was already taken
+     */
+
+    if (loader->number_of_jobs_done == loader->number_of_jobs)
+        return NULL;
+
+    if (loader->number_of_workers == 0) {
+        // Nothing decodes in the background, so decode the next job now
+        int index = SDL_AtomicAdd(&loader->next_job, 1);
+        decode_asset_job(loader->pack, &loader->jobs[index]);
+    } else if (wait) {
+        SDL_SemWait(loader->job_decoded);
+    } else if (SDL_SemTryWait(loader->job_decoded) != 0) {
+        return NULL;
+    }
+
+    // NOTE:
+    //  The semaphore is posted once per decoded job, so a decoded job that
+    //  was not taken yet is always found here. The assets of the menu are
+    //  taken first.
+    AssetJob *taken = NULL;
+    for (int i=0; i<loader->number_of_jobs; i++) {
+        AssetJob *job = &loader->jobs[i];
+        if (job->is_done || !SDL_AtomicGet(&job->is_decoded))
+            continue;
+        if (!taken || (job->is_needed_by_menu && !taken->is_needed_by_menu))
+            taken = job;
+    }
+
+    if (!taken)
+        return NULL;
+
+    taken->is_done = true;
+    loader->number_of_jobs_done++;
+    if (taken->is_needed_by_menu)
+        loader->number_of_menu_jobs_left--;
+    return taken;
+}
+
+void stop_asset_loader(AssetLoader *loader) {
+    /*
+     * A function that stops the workers, waiting for the jobs they already
+     * started, and releases the assets of every job that was decoded but
+     * never taken.
+     */
+
+    SDL_AtomicSet(&loader->is_cancelled, 1);
+    for (int i=0; i<loader->number_of_workers; i++) {
+        SDL_WaitThread(loader->workers[i], NULL);
+    }
+    loader->number_of_workers = 0;
+
+    for (int i=0; i<loader->number_of_jobs; i++) {
+        AssetJob *job = &loader->jobs[i];
+        if (job->is_done || !SDL_AtomicGet(&job->is_decoded))
+            continue;
+        if (job->decoded_page)
+            SDL_FreeSurface(job->decoded_page);
+        if (job->decoded_chunk)
+            Mix_FreeChunk(job->decoded_chunk);
+        if (job->decoded_music)
+            Mix_FreeMusic(job->decoded_music);
+        job->is_done = true;
+    }
+
+    // Nothing is left to take
+    loader->number_of_jobs_done = loader->number_of_jobs;
+    loader->number_of_menu_jobs_left = 0;
+
+    if (loader->job_decoded)
+        SDL_DestroySemaphore(loader->job_decoded);
+    loader->job_decoded = NULL;
+}
@@ -0,0 +1,16 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "declarations.h"
+
+void init_asset_loader(AssetLoader *loader, const AssetPack *pack);
+
+AssetJob* add_asset_job(AssetLoader *loader, enum AssetJobType type, bool is_needed_by_menu);
+
+void start_asset_loader(AssetLoader *loader);
+
+AssetJob* take_decoded_asset_job(AssetLoader *loader, bool wait);
+
+void stop_asset_loader(AssetLoader *loader);
+
+#endif // !ASSET_LOADER_H
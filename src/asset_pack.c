@@ -0,0 +1,249 @@
+/*
+ *  This file, `asset_pack.c`, contains functions that map the asset pack
+ *  into memory and find the assets in it.
+ *
+ *  NOTE:
+ *      The pack is mapped rather than read, so only the pages of the file
+ *      that are actually used are loaded, straight from the page cache of
+ *      the operating system. The textures and sounds are created directly
+ *      from the mapped memory. When the pack is embedded into the
+ *      executable, it is used in place, and no file is opened at all.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "string.h"
+
+#ifdef _WIN32
+#include "windows.h"
+#else
+#include "fcntl.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "unistd.h"
+#endif
+
+#include "asset_pack.h"
+#include "embedded_assets.h"
+#include "declarations.h"
+
+static bool map_file(AssetPack *pack, const char *filename) {
+    /*
+     * A helper function that maps the whole file read-only into memory.
+     */
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    void *data = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping)
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (!data) {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    pack->file = file;
+    pack->mapping = mapping;
+    pack->data = data;
+    pack->size = (size_t) size.QuadPart;
+    return true;
+#else
+    int file = open(filename, O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat status;
+    void *data = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+        data = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // The mapping stays valid after the file is closed
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+
+    pack->data = data;
+    pack->size = (size_t) status.st_size;
+    return true;
+#endif
+}
+
+bool open_asset_pack(AssetPack *pack, const char *filename) {
+    /*
+     * A function that maps the asset pack into memory and checks it.
+     *
+     * params
+     *      AssetPack *pack
+     *          A pointer to the struct AssetPack that receives the pack
+     *      const char *filename
+     *          The filename of the pack, which is only opened if no pack
+     *          was embedded into the executable
+     * returns
+     *      false if the pack is missing or damaged, in which case `pack`
+     *      is empty and every asset has to be loaded from its own file
+     */
+
+    pack->data = NULL;
+    pack->size = 0;
+    pack->entries = NULL;
+    pack->number_of_entries = 0;
+    pack->is_embedded = get_embedded_asset_pack(&pack->data, &pack->size);
+
+    if (pack->is_embedded) {
+        filename = "embedded into the executable";
+    } else if (!map_file(pack, filename)) {
+        printf("Asset pack %s not found, loading every asset from its own file\n", filename);
+        return false;
+    }
+
+    const AssetPackHeader *header = (const AssetPackHeader *) pack->data;
+    bool is_valid = pack->size >= sizeof(AssetPackHeader) &&
+                    memcmp(header->magic, ASSET_PACK_MAGIC, sizeof(header->magic)) == 0 &&
+                    header->version == ASSET_PACK_VERSION &&
+                    header->number_of_entries <= (pack->size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry);
+
+    const AssetPackEntry *entries = (const AssetPackEntry *) (pack->data + sizeof(AssetPackHeader));
+    for (uint32_t i=0; is_valid && i<header->number_of_entries; i++) {
+        is_valid = entries[i].offset <= pack->size && entries[i].size <= pack->size - entries[i].offset &&
+                   memchr(entries[i].name, '\0', MAX_ASSET_NAME_LENGTH) != NULL;
+    }
+
+    if (!is_valid) {
+        printf("Asset pack %s is damaged, loading every asset from its own file\n", filename);
+        close_asset_pack(pack);
+        return false;
+    }
+
+    pack->entries = entries;
+    pack->number_of_entries = (int) header->number_of_entries;
+    return true;
+}
+
+const AssetPackEntry* find_asset(const AssetPack *pack, const char *name, enum AssetType type) {
+    /*
+     * A function that finds an asset in the pack.
+     *
+     * returns
+     *      the AssetPackEntry of the asset, or NULL if it is not in the pack
+     */
+
+    for (int i=0; i<pack->number_of_entries; i++) {
+        if (pack->entries[i].type == (uint32_t) type && strcmp(pack->entries[i].name, name) == 0)
+            return &pack->entries[i];
+    }
+    return NULL;
+}
+
+const void* get_asset_data(const AssetPack *pack, const AssetPackEntry *entry) {
+    /*
+     * A function that returns the data of an asset, inside the mapped pack.
+     */
+
+    return pack->data + entry->offset;
+}
+
+bool unpack_asset_image(const AssetPack *pack, const AssetPackEntry *entry, void *pixels) {
+    /*
+     * A function that decodes the pixels of a run-length encoded image.
+     *
+     * params
+     *      const AssetPack *pack
+     *          A pointer to the struct AssetPack
+     *      const AssetPackEntry *entry
+     *          The image, in 32 bit pixels
+     *      void *pixels
+     *          Receives the `height` rows of `pitch` bytes of the image
+     * returns
+     *      false if the image is not run-length encoded, or its runs do not
+     *      add up to its size
+     */
+
+    if (entry->compression != ASSET_COMPRESSION_RLE || entry->pitch != entry->width * 4)
+        return false;
+
+    const unsigned char *runs = get_asset_data(pack, entry);
+    unsigned char *output = pixels;
+    uint64_t input_size = entry->size;
+    uint64_t output_size = (uint64_t) entry->pitch * entry->height;
+    uint64_t read = 0, written = 0;
+
+    while (written < output_size) {
+        if (read >= input_size)
+            return false;
+
+        unsigned int header = runs[read++];
+        uint64_t size = ((uint64_t) (header & ~ASSET_RLE_REPEAT) + 1) * 4;
+        if (written + size > output_size)
+            return false;
+
+        if (header & ASSET_RLE_REPEAT) {
+            if (read + 4 > input_size)
+                return false;
+            uint32_t pixel;
+            memcpy(&pixel, runs + read, 4);
+            for (uint64_t i=0; i<size; i+=4) {
+                memcpy(output + written + i, &pixel, 4);
+            }
+            read += 4;
+        } else {
+            if (read + size > input_size)
+                return false;
+            memcpy(output + written, runs + read, (size_t) size);
+            read += size;
+        }
+        written += size;
+    }
+    return read == input_size;
+}
+
+unsigned int touch_asset_data(const AssetPack *pack, const AssetPackEntry *entry) {
+    /*
+     * A function that reads one byte of every memory page of an asset, so
+     * that the pages are read from the disk by the thread that calls it,
+     * rather than by whichever thread uses the asset first.
+     *
+     * returns
+     *      a checksum of the bytes read, which only keeps the reads from
+     *      being optimized away
+     */
+
+    const volatile unsigned char *data = pack->data + entry->offset;
+    unsigned int checksum = 0;
+    for (uint64_t i=0; i<entry->size; i+=ASSET_PACK_PAGE_SIZE) {
+        checksum += data[i];
+    }
+    return checksum;
+}
+
+void close_asset_pack(AssetPack *pack) {
+    /*
+     * A function that unmaps the pack. Nothing created from its memory, such
+     * as sounds, may be used afterwards. The embedded pack is left as it is.
+     */
+
+    if (pack->data && !pack->is_embedded) {
+#ifdef _WIN32
+        UnmapViewOfFile(pack->data);
+        CloseHandle(pack->mapping);
+        CloseHandle(pack->file);
+#else
+        munmap((void *) pack->data, pack->size);
+#endif
+    }
+
+    pack->data = NULL;
+    pack->size = 0;
+    pack->entries = NULL;
+    pack->number_of_entries = 0;
+    pack->is_embedded = false;
+}
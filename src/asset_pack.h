@@ -0,0 +1,98 @@
+/*
+ *  This file, 'asset_pack.h', declares the asset pack, a single file that
+ *  holds the atlas pages as run-length encoded pixels, the sounds as raw
+ *  samples, in the format of the audio device, and the music as it is. It is written by
+ *  `tools/asset_packer.c` when the game is built, and either embedded into
+ *  the executable or mapped into memory when the game starts, so that
+ *  nothing has to be decoded and at most one file is opened.
+ *
+ *  The file starts with an AssetPackHeader, followed by an AssetPackEntry
+ *  for every asset, followed by the data of the assets. All numbers are in
+ *  the byte order of the machine that built the pack.
+ */
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#include "declarations.h"
+
+#define ASSET_PACK_MAGIC "GPACPAK"
+#define ASSET_PACK_VERSION 2
+
+// The data of every asset starts at a multiple of this many bytes
+#define ASSET_PACK_ALIGNMENT 64
+
+// The smallest memory page of the systems the game runs on
+#define ASSET_PACK_PAGE_SIZE 4096
+
+#define MAX_ASSET_NAME_LENGTH 64
+
+// A run-length encoded image is a sequence of runs, each starting with a
+// byte. With ASSET_RLE_REPEAT set, the pixel after it is repeated, otherwise
+// that many different pixels follow. The lower bits hold the number of
+// pixels, minus one.
+#define ASSET_RLE_REPEAT 0x80
+#define ASSET_RLE_MAX_PIXELS 128
+
+enum AssetType {
+    ASSET_IMAGE = 1,
+    ASSET_SOUND = 2,
+    // A music file, which is streamed from the pack while it plays
+    ASSET_MUSIC = 3,
+};
+
+/*
+ * AssetCompression is how the pixels of an image are stored. Only images that
+ * do not get smaller are stored as they are.
+ */
+enum AssetCompression {
+    ASSET_COMPRESSION_NONE = 0,
+    ASSET_COMPRESSION_RLE = 1,
+};
+
+typedef struct AssetPackHeader {
+    // ASSET_PACK_MAGIC, including its terminating zero
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    number_of_entries;
+} AssetPackHeader;
+
+/*
+ * AssetPackEntry describes one asset. Its name is the filename the game
+ * would otherwise load it from, e.g. "atlas/atlas_0.png".
+ */
+typedef struct AssetPackEntry {
+    char        name[MAX_ASSET_NAME_LENGTH];
+    uint32_t    type;
+    // Images, as rows of `pitch` bytes in an SDL pixel format
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    pitch;
+    uint32_t    pixel_format;
+    // An AssetCompression
+    uint32_t    compression;
+    // Sounds, as interleaved samples in an SDL audio format
+    uint32_t    frequency;
+    uint32_t    channels;
+    uint32_t    audio_format;
+    // Where the data is, from the start of the file
+    uint64_t    offset;
+    uint64_t    size;
+} AssetPackEntry;
+
+bool open_asset_pack(AssetPack *pack, const char *filename);
+
+const AssetPackEntry* find_asset(const AssetPack *pack, const char *name, enum AssetType type);
+
+const void* get_asset_data(const AssetPack *pack, const AssetPackEntry *entry);
+
+bool unpack_asset_image(const AssetPack *pack, const AssetPackEntry *entry, void *pixels);
+
+unsigned int touch_asset_data(const AssetPack *pack, const AssetPackEntry *entry);
+
+void close_asset_pack(AssetPack *pack);
+
+#endif // !ASSET_PACK_H
@@ -7,28 +7,135 @@
 
 #include "stdio.h"
 
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "atlas.h"
+#include "texture_cache.h"
 #include "utils.h"
+#include "voices.h"
 #include "declarations.h"
 #include "logic.h"
 #include "assets.h"
 
 
-Assets load_all_assets(SDL_Renderer *renderer) { 
+static int list_all_sprites(Assets *assets, Sprite **sprites) {
    /*
-    * A function that handles the loading of all assets required for the game, such as various images and sounds.
-    * This includes loading various images and sounds for the application.
+    * A helper function that lists every sprite in `assets`.
     *
     * params
-    *      SDL_Renderer *renderer
-    *          A pointer to the struct SDL_Renderer which handles the rendering of every element
-    *          in the screen.
-    *
+    *      Assets *assets
+    *          A pointer to the struct Assets
+    *      Sprite **sprites
+    *          Receives a pointer to every sprite, and must have room for
+    *          MAX_NUMBER_OF_SPRITES of them
     * returns
-    *     Assets assets
-    *         A struct containing all the assets required in the application.
+    *      the number of sprites
+    */
+
+    int number_of_sprites = 0;
+
+    sprites[number_of_sprites++] = &assets->game.pacman;
+    sprites[number_of_sprites++] = &assets->game.main;
+    sprites[number_of_sprites++] = &assets->game.exit;
+
+    sprites[number_of_sprites++] = &assets->menu.player_chose_start;
+    sprites[number_of_sprites++] = &assets->menu.player_chose_tutorial;
+    sprites[number_of_sprites++] = &assets->menu.player_chose_exit;
+    sprites[number_of_sprites++] = &assets->menu.player_chose_about;
+    sprites[number_of_sprites++] = &assets->menu.player_chose_none;
+
+    sprites[number_of_sprites++] = &assets->prompt.game_lost_hit_block;
+    sprites[number_of_sprites++] = &assets->prompt.game_lost_hit_border;
+    sprites[number_of_sprites++] = &assets->prompt.game_lost_insufficient_food;
+    sprites[number_of_sprites++] = &assets->prompt.game_won;
+
+    sprites[number_of_sprites++] = &assets->misc.about_screen;
+    sprites[number_of_sprites++] = &assets->misc.quit_confirmation_prompt;
+    for (int i=0; i<NUMBER_OF_PAGES_IN_TUTORIAL; i++) {
+        sprites[number_of_sprites++] = &assets->misc.tutorial_pages[i];
+    }
+    for (int i=0; i<NUMBER_OF_FOOD_INPUT_PROMPTS; i++) {
+        sprites[number_of_sprites++] = &assets->misc.food_input_prompts[i];
+    }
+    for (int i=0; i<NUMBER_OF_SCORE_VISUALS; i++) {
+        sprites[number_of_sprites++] = &assets->misc.score_visuals[i];
+    }
+    for (int i=0; i<NUMBER_OF_BLOCKS; i++) {
+        sprites[number_of_sprites++] = &assets->game.blocks[i];
+    }
+    for (int i=0; i<MAX_NUMBER_OF_FOOD; i++) {
+        sprites[number_of_sprites++] = &assets->game.foods[i];
+    }
+
+    sprites[number_of_sprites++] = &assets->reminders.wrong_input_in_menu;
+    sprites[number_of_sprites++] = &assets->reminders.wrong_input_in_tutorial;
+    sprites[number_of_sprites++] = &assets->reminders.wrong_input_in_about_game;
+    sprites[number_of_sprites++] = &assets->reminders.wrong_input_in_food_input;
+    sprites[number_of_sprites++] = &assets->reminders.wrong_input_in_game;
+    sprites[number_of_sprites++] = &assets->reminders.wrong_input_in_game_prompts;
+
+    return number_of_sprites;
+}
+
+static void hand_over_asset(Assets *assets, AssetJob *job) {
+   /*
+    * A helper function that puts a decoded asset where the game uses it.
+    * An atlas page is uploaded into the texture cache.
+    */
+
+    switch (job->type) {
+        case ASSET_JOB_SOUND:
+            *job->chunk = job->decoded_chunk;
+            return;
+        case ASSET_JOB_MUSIC:
+            *job->music = job->decoded_music;
+            return;
+        case ASSET_JOB_ATLAS_PAGE:
+            break;
+    }
+
+    // A page that cannot be uploaded is loaded again when it is drawn
+    if (job->decoded_page) {
+        insert_atlas_page(&assets->texture_cache, job->page, job->decoded_page);
+        SDL_FreeSurface(job->decoded_page);
+    }
+    job->decoded_page = NULL;
+}
+
+static void add_sound_job(AssetLoader *loader, const char *filename, Mix_Chunk **chunk) {
+   /*
+    * A helper function that adds a sound to be loaded into `chunk`, which
+    * stays NULL until then.
     */
 
-    Assets assets;
+    *chunk = NULL;
+    AssetJob *job = add_asset_job(loader, ASSET_JOB_SOUND, false);
+    if (!job)
+        return;
+    job->filename = filename;
+    job->chunk = chunk;
+}
+
+void start_loading_assets(Assets *assets, RenderQueue *render_queue, size_t texture_budget) {
+   /*
+    * A function that starts loading all assets required for the game, such as various images and sounds.
+    * It returns right away, while the images and sounds are decoded in the background.
+    *
+    * params
+    *      Assets *assets
+    *          A pointer to the struct Assets that receives the assets-> It must not move until
+    *          `free_all_assets` is called.
+    *      RenderQueue *render_queue
+    *          A pointer to the struct RenderQueue which every sprite is drawn through. Its
+    *          renderer handles the rendering of every element in the screen.
+    *      size_t texture_budget
+    *          The most memory, in bytes, the loaded atlas pages may use
+    *
+    * NOTE:
+    *  The sprites are set up right away, but the atlas pages are only loaded when they are
+    *  first drawn, except for the pages of the menu, which are decoded in the background and
+    *  uploaded by `update_asset_loading`. Likewise, a sound stays NULL until it is loaded.
+    */
 
     // SDL_Rect is a struct that holds the `x` and `y` position
     // as well as the `h` height and `w` width of any element rendered on the
@@ -45,31 +152,44 @@ Assets load_all_assets(SDL_Renderer *renderer) {
     SDL_Rect reminder_rect      = {.x=43,   .y=700, .h=98,  .w=554};
     SDL_Rect quit_rect          = {.x=36,   .y=193, .h=253, .w=567};
 
+    assets->render_queue = render_queue;
+    init_voice_manager(&assets->voices);
+
+    // Map the asset pack, which holds the atlas pages and the sounds already
+    // decoded. Assets missing from it are loaded from their own files.
+    open_asset_pack(&assets->asset_pack, ASSET_PACK_FILENAME);
+
+    // Find the atlas pages first, since most sprites point into them. The
+    // pages are loaded through the texture cache.
+    prepare_atlas(&assets->asset_pack, &assets->atlas);
+    init_texture_cache(&assets->texture_cache, render_queue->renderer, &assets->asset_pack,
+                       &assets->atlas, texture_budget);
+
     // Load all sprites used for running the game
-    assets.game.pacman = load_sprite(renderer, "../assets/game_elements/pacman.png", 40, 10, pacman_rect);
-    assets.game.main   = load_sprite(renderer, "../assets/game_elements/main.png", 0, 1, fullscreen_rect);
-    assets.game.exit   = load_sprite(renderer, "../assets/game_elements/exit.png", 0, 1, exit_rect);
+    assets->game.pacman = load_sprite(render_queue, &assets->texture_cache, "../assets/game_elements/pacman.png", 40, 10, pacman_rect);
+    assets->game.main   = load_sprite(render_queue, &assets->texture_cache, "../assets/game_elements/main.png", 0, 1, fullscreen_rect);
+    assets->game.exit   = load_sprite(render_queue, &assets->texture_cache, "../assets/game_elements/exit.png", 0, 1, exit_rect);
 
     // Load menu highlights, based on the current menu option the user chooses
-    assets.menu.player_chose_start         = load_sprite(renderer, "../assets/menu/highlight_start.png", 0, 1, fullscreen_rect);
-    assets.menu.player_chose_tutorial      = load_sprite(renderer, "../assets/menu/highlight_tutorial.png", 0, 1, fullscreen_rect);
-    assets.menu.player_chose_exit          = load_sprite(renderer, "../assets/menu/highlight_exit.png", 0, 1, fullscreen_rect);
-    assets.menu.player_chose_about         = load_sprite(renderer, "../assets/menu/highlight_about.png", 0, 1, fullscreen_rect);
-    assets.menu.player_chose_none          = load_sprite(renderer, "../assets/menu/highlight_none.png", 0, 1, fullscreen_rect);
+    assets->menu.player_chose_start         = load_sprite(render_queue, &assets->texture_cache, "../assets/menu/highlight_start.png", 0, 1, fullscreen_rect);
+    assets->menu.player_chose_tutorial      = load_sprite(render_queue, &assets->texture_cache, "../assets/menu/highlight_tutorial.png", 0, 1, fullscreen_rect);
+    assets->menu.player_chose_exit          = load_sprite(render_queue, &assets->texture_cache, "../assets/menu/highlight_exit.png", 0, 1, fullscreen_rect);
+    assets->menu.player_chose_about         = load_sprite(render_queue, &assets->texture_cache, "../assets/menu/highlight_about.png", 0, 1, fullscreen_rect);
+    assets->menu.player_chose_none          = load_sprite(render_queue, &assets->texture_cache, "../assets/menu/highlight_none.png", 0, 1, fullscreen_rect);
 
     /// Game Prompts
     // Load game prompts, based on the game results
-    assets.prompt.game_lost_hit_block         = load_sprite(renderer, "../assets/results/block_hit.png", 0, 1, prompt_rect);
-    assets.prompt.game_lost_hit_border        = load_sprite(renderer, "../assets/results/border_hit.png", 0, 1, prompt_rect);
-    assets.prompt.game_lost_insufficient_food = load_sprite(renderer, "../assets/results/food_miss.png", 0, 1, prompt_rect);
-    assets.prompt.game_won                    = load_sprite(renderer, "../assets/results/won.png", 0, 1, prompt_rect);
+    assets->prompt.game_lost_hit_block         = load_sprite(render_queue, &assets->texture_cache, "../assets/results/block_hit.png", 0, 1, prompt_rect);
+    assets->prompt.game_lost_hit_border        = load_sprite(render_queue, &assets->texture_cache, "../assets/results/border_hit.png", 0, 1, prompt_rect);
+    assets->prompt.game_lost_insufficient_food = load_sprite(render_queue, &assets->texture_cache, "../assets/results/food_miss.png", 0, 1, prompt_rect);
+    assets->prompt.game_won                    = load_sprite(render_queue, &assets->texture_cache, "../assets/results/won.png", 0, 1, prompt_rect);
 
 
     /// Miscellaneous
     // Load screen upon choosing About the Game from the menu
-    assets.misc.about_screen               = load_sprite(renderer, "../assets/misc/about_game.png", 0, 1, fullscreen_rect);
+    assets->misc.about_screen               = load_sprite(render_queue, &assets->texture_cache, "../assets/misc/about_game.png", 0, 1, fullscreen_rect);
     // Load prompt upon choosing Exit from the menu
-    assets.misc.quit_confirmation_prompt =  load_sprite(renderer, "../assets/misc/quit_confirmation.png", 0, 1, quit_rect);
+    assets->misc.quit_confirmation_prompt =  load_sprite(render_queue, &assets->texture_cache, "../assets/misc/quit_confirmation.png", 0, 1, quit_rect);
 
 
     char filename[35];
@@ -77,56 +197,204 @@ Assets load_all_assets(SDL_Renderer *renderer) {
     // Populate the sprite array with tutorial pages
     for (int i = 0; i < NUMBER_OF_PAGES_IN_TUTORIAL; i++) {
         sprintf(filename, "../assets/tutorial/page_%d.png", i+1);
-        assets.misc.tutorial_pages[i] = load_sprite(renderer, filename, 0, 1, fullscreen_rect);
+        assets->misc.tutorial_pages[i] = load_sprite(render_queue, &assets->texture_cache, filename, 0, 1, fullscreen_rect);
     }
 
     // Populate the sprite array with food input prompts
     for (int i = 0; i < 9; i++) {
         sprintf(filename, "../assets/food_input_prompts/%d.png", i);
-        assets.misc.food_input_prompts[i] = load_sprite(renderer, filename, 0, 1, food_input_rect);
+        assets->misc.food_input_prompts[i] = load_sprite(render_queue, &assets->texture_cache, filename, 0, 1, food_input_rect);
     };
 
     // Populate the sprite array with score visualization
     for (int i = 0; i < 10; i++) {
         sprintf(filename, "../assets/score_visuals/%d.png", i);
-        assets.misc.score_visuals[i] = load_sprite(renderer, filename, 0, 1, score_visuals_rect);
+        assets->misc.score_visuals[i] = load_sprite(render_queue, &assets->texture_cache, filename, 0, 1, score_visuals_rect);
     };
 
     // Populate the sprite array with blocks
     for (int i=0; i<NUMBER_OF_BLOCKS; i++) {
-        assets.game.blocks[i] = load_sprite(renderer, "../assets/game_elements/box.png", 0 , 1, block_rect);
+        assets->game.blocks[i] = load_sprite(render_queue, &assets->texture_cache, "../assets/game_elements/box.png", 0 , 1, block_rect);
     }
 
     // Populate the sprite array with food
     for (int i=0; i<MAX_NUMBER_OF_FOOD; i++) {
-        assets.game.foods[i] = load_sprite(renderer, "../assets/game_elements/food.png", 40 , 5, food_rect);
+        assets->game.foods[i] = load_sprite(render_queue, &assets->texture_cache, "../assets/game_elements/food.png", 40 , 5, food_rect);
         // randomize the start of the animation by setting the current frame to different values
-        assets.game.foods[i].current_frame = i;
+        assets->game.foods[i].current_frame = i;
     }
 
     // Load reminders for wrong user input at various instances
                  
-    assets.reminders.wrong_input_in_menu          = load_sprite(renderer, "../assets/reminders/wrong_input_in_menu.png", 0, 1, reminder_rect);
-    assets.reminders.wrong_input_in_tutorial      = load_sprite(renderer, "../assets/reminders/wrong_input_in_tutorial.png", 0, 1, reminder_rect);
-    assets.reminders.wrong_input_in_about_game    = load_sprite(renderer, "../assets/reminders/wrong_input_in_about.png", 0, 1, reminder_rect);
-    assets.reminders.wrong_input_in_food_input    = load_sprite(renderer, "../assets/reminders/wrong_input_in_food_input.png", 0, 1, reminder_rect);
-    assets.reminders.wrong_input_in_game          = load_sprite(renderer, "../assets/reminders/wrong_input_in_game.png", 0, 1, reminder_rect);
-    assets.reminders.wrong_input_in_game_prompts  = load_sprite(renderer, "../assets/reminders/wrong_input_in_game_prompts.png", 0, 1, reminder_rect);
-
-    // Load game sounds
-    assets.sounds.background_music     = Mix_LoadMUS("../assets/sounds/background_muzic.mp3");
-    assets.sounds.pacman_munch         = Mix_LoadWAV("../assets/sounds/munch.wav");
-    assets.sounds.pacman_step          = Mix_LoadWAV("../assets/sounds/step.wav");
-    assets.sounds.game_notification    = Mix_LoadWAV("../assets/sounds/notif.wav");
-    assets.sounds.option_select        = Mix_LoadWAV("../assets/sounds/select.wav");
-    assets.sounds.option_confirm       = Mix_LoadWAV("../assets/sounds/confirm.wav");
-    assets.sounds.open_about_game      = Mix_LoadWAV("../assets/sounds/open_about.wav");
-    assets.sounds.quit_sound           = Mix_LoadWAV("../assets/sounds/quit.wav");
-    assets.sounds.start_game           = Mix_LoadWAV("../assets/sounds/start_game.wav");
-    assets.sounds.game_win             = Mix_LoadWAV("../assets/sounds/win.wav");
-    assets.sounds.game_over            = Mix_LoadWAV("../assets/sounds/game_over.wav");    
-
-    return assets;
+    assets->reminders.wrong_input_in_menu          = load_sprite(render_queue, &assets->texture_cache, "../assets/reminders/wrong_input_in_menu.png", 0, 1, reminder_rect);
+    assets->reminders.wrong_input_in_tutorial      = load_sprite(render_queue, &assets->texture_cache, "../assets/reminders/wrong_input_in_tutorial.png", 0, 1, reminder_rect);
+    assets->reminders.wrong_input_in_about_game    = load_sprite(render_queue, &assets->texture_cache, "../assets/reminders/wrong_input_in_about.png", 0, 1, reminder_rect);
+    assets->reminders.wrong_input_in_food_input    = load_sprite(render_queue, &assets->texture_cache, "../assets/reminders/wrong_input_in_food_input.png", 0, 1, reminder_rect);
+    assets->reminders.wrong_input_in_game          = load_sprite(render_queue, &assets->texture_cache, "../assets/reminders/wrong_input_in_game.png", 0, 1, reminder_rect);
+    assets->reminders.wrong_input_in_game_prompts  = load_sprite(render_queue, &assets->texture_cache, "../assets/reminders/wrong_input_in_game_prompts.png", 0, 1, reminder_rect);
+
+    // Draw the elements of the board above the board itself, and the score,
+    // the reminders and the quit confirmation prompt above everything else
+    assets->game.pacman.layer = RENDER_LAYER_BOARD;
+    assets->game.exit.layer   = RENDER_LAYER_BOARD;
+    for (int i=0; i<NUMBER_OF_BLOCKS; i++) {
+        assets->game.blocks[i].layer = RENDER_LAYER_BOARD;
+    }
+    for (int i=0; i<MAX_NUMBER_OF_FOOD; i++) {
+        assets->game.foods[i].layer = RENDER_LAYER_BOARD;
+    }
+    for (int i=0; i<NUMBER_OF_SCORE_VISUALS; i++) {
+        assets->misc.score_visuals[i].layer = RENDER_LAYER_OVERLAY;
+    }
+    assets->reminders.wrong_input_in_menu.layer         = RENDER_LAYER_REMINDER;
+    assets->reminders.wrong_input_in_tutorial.layer     = RENDER_LAYER_REMINDER;
+    assets->reminders.wrong_input_in_about_game.layer   = RENDER_LAYER_REMINDER;
+    assets->reminders.wrong_input_in_food_input.layer   = RENDER_LAYER_REMINDER;
+    assets->reminders.wrong_input_in_game.layer         = RENDER_LAYER_REMINDER;
+    assets->reminders.wrong_input_in_game_prompts.layer = RENDER_LAYER_REMINDER;
+    assets->misc.quit_confirmation_prompt.layer         = RENDER_LAYER_DIALOG;
+
+    // Decode the atlas pages the menu shows first, then the sounds and the
+    // music. The other pages are loaded when they are first drawn.
+    AssetLoader *loader = &assets->loader;
+    init_asset_loader(loader, &assets->asset_pack);
+
+    Sprite *menu_sprites[] = {
+        &assets->menu.player_chose_start,
+        &assets->menu.player_chose_tutorial,
+        &assets->menu.player_chose_exit,
+        &assets->menu.player_chose_about,
+        &assets->menu.player_chose_none,
+        &assets->reminders.wrong_input_in_menu,
+        &assets->misc.quit_confirmation_prompt,
+    };
+    bool is_page_added[MAX_ATLAS_PAGES] = {false};
+    for (size_t i=0; i<sizeof(menu_sprites) / sizeof(menu_sprites[0]); i++) {
+        int page = menu_sprites[i]->atlas_page;
+        if (page < 0 || is_page_added[page])
+            continue;
+        AssetJob *job = add_asset_job(loader, ASSET_JOB_ATLAS_PAGE, true);
+        if (job)
+            job->page = page;
+        is_page_added[page] = true;
+    }
+
+    add_sound_job(loader, "../assets/sounds/munch.wav",      &assets->sounds.pacman_munch);
+    add_sound_job(loader, "../assets/sounds/step.wav",       &assets->sounds.pacman_step);
+    add_sound_job(loader, "../assets/sounds/notif.wav",      &assets->sounds.game_notification);
+    add_sound_job(loader, "../assets/sounds/select.wav",     &assets->sounds.option_select);
+    add_sound_job(loader, "../assets/sounds/confirm.wav",    &assets->sounds.option_confirm);
+    add_sound_job(loader, "../assets/sounds/open_about.wav", &assets->sounds.open_about_game);
+    add_sound_job(loader, "../assets/sounds/quit.wav",       &assets->sounds.quit_sound);
+    add_sound_job(loader, "../assets/sounds/start_game.wav", &assets->sounds.start_game);
+    add_sound_job(loader, "../assets/sounds/win.wav",        &assets->sounds.game_win);
+    add_sound_job(loader, "../assets/sounds/game_over.wav",  &assets->sounds.game_over);
+
+    assets->sounds.background_music = NULL;
+    AssetJob *music_job = add_asset_job(loader, ASSET_JOB_MUSIC, false);
+    if (music_job) {
+        music_job->filename = "../assets/sounds/background_muzic.mp3";
+        music_job->music = &assets->sounds.background_music;
+    }
+
+    start_asset_loader(loader);
+}
+
+bool update_asset_loading(Assets *assets) {
+   /*
+    * A function that hands over the assets decoded since it was last called. It must be
+    * called on the thread that renders, e.g. once per frame.
+    *
+    * params
+    *      Assets *assets
+    *          A pointer to the struct Assets that is being loaded
+    * returns
+    *      true if an asset was handed over, i.e. the screen may look different
+    *
+    * NOTE:
+    *  Uploading an atlas page takes a while, so once the menu is shown, at most one page is
+    *  uploaded per call, which keeps the frames that are drawn while loading short.
+    */
+
+    bool is_updated = false;
+    int number_of_pages_uploaded = 0;
+
+    while (!are_all_assets_loaded(assets)) {
+        if (number_of_pages_uploaded > 0 && is_menu_ready(assets))
+            break;
+
+        AssetJob *job = take_decoded_asset_job(&assets->loader, false);
+        if (!job)
+            break;
+
+        hand_over_asset(assets, job);
+        is_updated = true;
+        if (job->type == ASSET_JOB_ATLAS_PAGE)
+            number_of_pages_uploaded++;
+    }
+    return is_updated;
+}
+
+void finish_loading_assets(Assets *assets) {
+   /*
+    * A function that waits for every asset that is still loading, and hands it over.
+    */
+
+    while (!are_all_assets_loaded(assets)) {
+        AssetJob *job = take_decoded_asset_job(&assets->loader, true);
+        if (job)
+            hand_over_asset(assets, job);
+    }
+}
+
+void load_all_assets(Assets *assets, RenderQueue *render_queue, size_t texture_budget) {
+   /*
+    * A function that loads all assets required for the game, and waits until every one of
+    * them is loaded. See `start_loading_assets`.
+    */
+
+    start_loading_assets(assets, render_queue, texture_budget);
+    finish_loading_assets(assets);
+}
+
+bool is_menu_ready(const Assets *assets) {
+   /*
+    * A function that checks whether every asset the menu shows is loaded.
+    */
+
+    return assets->loader.number_of_menu_jobs_left == 0;
+}
+
+bool are_all_assets_loaded(const Assets *assets) {
+   /*
+    * A function that checks whether every asset was handed over.
+    */
+
+    return assets->loader.number_of_jobs_done == assets->loader.number_of_jobs;
+}
+
+int get_loading_percentage(const Assets *assets) {
+   /*
+    * A function that returns how much of the assets was loaded, from 0 to 100.
+    */
+
+    if (assets->loader.number_of_jobs == 0)
+        return 100;
+    return assets->loader.number_of_jobs_done * 100 / assets->loader.number_of_jobs;
+}
+
+void free_sprite(Sprite* sprite) {
+   /*
+    * A function that handles the release of the texture of a sprite. The
+    * atlas pages are shared, so they are released by `free_atlas` instead.
+    *
+    * params:
+    *     Sprite* sprite
+    *         - Pointer to a sprite
+    */
+    if (sprite->atlas_page < 0 && sprite->texture)
+        SDL_DestroyTexture(sprite->texture);
+    sprite->texture = NULL;
 }
 
 void free_sprite_array(Sprite* sprite_array, int length_of_array) {
@@ -141,7 +409,7 @@ void free_sprite_array(Sprite* sprite_array, int length_of_array) {
     *         - The length of the array
     */
     for (int i=0; i<length_of_array; i++) {
-        SDL_DestroyTexture(sprite_array[i].texture);
+        free_sprite(&sprite_array[i]);
     }
 }
 
@@ -157,30 +425,19 @@ void free_all_assets(Assets *assets) {
     *         - Pointer to a assets struct
     */
 
-    // Free all sprites
-    SDL_DestroyTexture(assets->game.pacman.texture);
-    SDL_DestroyTexture(assets->game.exit.texture);
-    SDL_DestroyTexture(assets->game.main.texture);
-
-    SDL_DestroyTexture(assets->menu.player_chose_about.texture);
-    SDL_DestroyTexture(assets->menu.player_chose_start.texture);
-    SDL_DestroyTexture(assets->menu.player_chose_tutorial.texture);
-    SDL_DestroyTexture(assets->menu.player_chose_exit.texture);
-    SDL_DestroyTexture(assets->menu.player_chose_none.texture);
-
-    SDL_DestroyTexture(assets->prompt.game_lost_hit_block.texture);
-    SDL_DestroyTexture(assets->prompt.game_lost_insufficient_food.texture);
-    SDL_DestroyTexture(assets->prompt.game_won.texture);
-
-    SDL_DestroyTexture(assets->misc.quit_confirmation_prompt.texture);
+    // Stop decoding first, since the workers write into the assets
+    stop_asset_loader(&assets->loader);
 
-    free_sprite_array(assets->misc.tutorial_pages, NUMBER_OF_PAGES_IN_TUTORIAL);
-    free_sprite_array(assets->misc.food_input_prompts, NUMBER_OF_FOOD_INPUT_PROMPTS);
-    free_sprite_array(assets->misc.score_visuals, NUMBER_OF_SCORE_VISUALS);
-    free_sprite_array(assets->game.foods, MAX_NUMBER_OF_FOOD);
-    free_sprite_array(assets->game.blocks, NUMBER_OF_BLOCKS);
+    // Free all sprites
+    Sprite *sprites[MAX_NUMBER_OF_SPRITES];
+    int number_of_sprites = list_all_sprites(assets, sprites);
+    for (int i=0; i<number_of_sprites; i++) {
+        free_sprite(sprites[i]);
+    }
+    free_atlas(&assets->atlas);
 
     // Free all sounds
+    stop_voice_manager(&assets->voices);
     Mix_FreeMusic(assets->sounds.background_music);
     Mix_FreeChunk(assets->sounds.pacman_munch);
     Mix_FreeChunk(assets->sounds.pacman_step);
@@ -192,4 +449,7 @@ void free_all_assets(Assets *assets) {
     Mix_FreeChunk(assets->sounds.quit_sound);
     Mix_FreeChunk(assets->sounds.open_about_game);
     Mix_FreeChunk(assets->sounds.start_game);
+
+    // The sounds may still point into the pack, so close it last
+    close_asset_pack(&assets->asset_pack);
 }
@@ -3,9 +3,13 @@
 
 #include "declarations.h"
 
-Assets load_all_assets(SDL_Renderer *renderer);
+void start_loading_assets(Assets *assets, RenderQueue *render_queue, size_t texture_budget);
+bool update_asset_loading(Assets *assets);
+void finish_loading_assets(Assets *assets);
+void load_all_assets(Assets *assets, RenderQueue *render_queue, size_t texture_budget);
+bool is_menu_ready(const Assets *assets);
+bool are_all_assets_loaded(const Assets *assets);
+int get_loading_percentage(const Assets *assets);
 void free_all_assets(Assets *assets);
 
 #endif // !ASSETS_H
-
-
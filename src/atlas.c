@@ -0,0 +1,192 @@
+/*
+ *  This file, `atlas.c`, contains functions that handle the loading and
+ *  freeing of the atlas pages, which hold the images of most sprites.
+ *
+ *  NOTE:
+ *      Drawing sprites that share a texture lets the renderer draw them
+ *      without switching textures, and every image is uploaded once, even
+ *      when many sprites use it. The images are packed into the pages by
+ *      `tools/atlas_packer.c` when the game is built.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "string.h"
+
+#include "asset_pack.h"
+#include "atlas.h"
+#include "declarations.h"
+
+static bool is_file_readable(const char *filename) {
+    /*
+     * A helper function that checks whether a file can be opened.
+     */
+
+    SDL_RWops *file = SDL_RWFromFile(filename, "rb");
+    if (!file)
+        return false;
+    SDL_RWclose(file);
+    return true;
+}
+
+void prepare_atlas(const AssetPack *pack, Atlas *atlas) {
+    /*
+     * A function that finds out which atlas pages can be loaded, without
+     * loading any of them yet.
+     *
+     * params
+     *      const AssetPack *pack
+     *          A pointer to the struct AssetPack, which holds the decoded pages
+     *      Atlas *atlas
+     *          A pointer to the struct Atlas whose pages are loaded later, by
+     *          `decode_atlas_page` and `upload_atlas_page`
+     *
+     * NOTE:
+     *  A page is available when it is in the asset pack or has a PNG file.
+     *  The sprites on a page that is not available are loaded from their
+     *  own images instead.
+     */
+
+    atlas->number_of_pages = NUMBER_OF_ATLAS_PAGES;
+    if (atlas->number_of_pages > MAX_ATLAS_PAGES)
+        atlas->number_of_pages = MAX_ATLAS_PAGES;
+
+    for (int page=0; page<atlas->number_of_pages; page++) {
+        atlas->pages[page] = NULL;
+        atlas->is_page_available[page] = find_asset(pack, ATLAS_PAGE_FILENAMES[page], ASSET_IMAGE) ||
+                                         is_file_readable(ATLAS_PAGE_FILENAMES[page]);
+        if (!atlas->is_page_available[page])
+            printf("Error loading atlas page %s\n", ATLAS_PAGE_FILENAMES[page]);
+    }
+}
+
+SDL_Surface* decode_atlas_page(const AssetPack *pack, int page) {
+    /*
+     * A function that decodes an atlas page into RGBA pixels. It does not
+     * use the renderer, so it may run on any thread.
+     *
+     * params
+     *      const AssetPack *pack
+     *          A pointer to the struct AssetPack, which holds the decoded pages
+     *      int page
+     *          The index of the page
+     * returns
+     *      the pixels of the page, to be released with SDL_FreeSurface, or
+     *      NULL if the page cannot be loaded
+     *
+     * NOTE:
+     *  A page in the asset pack is usually run-length encoded, which only
+     *  takes copying its runs into a new surface to undo. A page that is
+     *  stored as it is is already decoded, so the surface points straight
+     *  into the mapped pack. Its memory is only read here, so that the disk
+     *  is not waited on when the page is uploaded.
+     */
+
+    const AssetPackEntry *entry = find_asset(pack, ATLAS_PAGE_FILENAMES[page], ASSET_IMAGE);
+    if (entry && entry->compression == ASSET_COMPRESSION_RLE) {
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, (int) entry->width, (int) entry->height, 32,
+                                                              entry->pixel_format);
+        if (surface && surface->pitch == (int) entry->pitch && unpack_asset_image(pack, entry, surface->pixels))
+            return surface;
+        printf("Error decoding atlas page %s\n", ATLAS_PAGE_FILENAMES[page]);
+        SDL_FreeSurface(surface);
+    } else if (entry) {
+        touch_asset_data(pack, entry);
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom((void *) get_asset_data(pack, entry),
+                                                                  (int) entry->width, (int) entry->height, 32,
+                                                                  (int) entry->pitch, entry->pixel_format);
+        if (surface)
+            return surface;
+        printf("Error creating surface: %s\n", SDL_GetError());
+    }
+
+    SDL_Surface *loaded = IMG_Load(ATLAS_PAGE_FILENAMES[page]);
+    if (!loaded) {
+        printf("Error loading atlas page %s\n", ATLAS_PAGE_FILENAMES[page]);
+        return NULL;
+    }
+
+    // Convert the page here, rather than when it is uploaded
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!converted)
+        printf("Error converting atlas page %s: %s\n", ATLAS_PAGE_FILENAMES[page], SDL_GetError());
+    return converted;
+}
+
+bool upload_atlas_page(SDL_Renderer *renderer, Atlas *atlas, int page, SDL_Surface *surface) {
+    /*
+     * A function that uploads a decoded atlas page into a texture. It must
+     * run on the thread that renders.
+     *
+     * params
+     *      SDL_Renderer *renderer
+     *          A pointer to the struct SDL_Renderer which the pages are drawn with
+     *      Atlas *atlas
+     *          A pointer to the struct Atlas that receives the page
+     *      int page
+     *          The index of the page
+     *      SDL_Surface *surface
+     *          The pixels returned by `decode_atlas_page`, which are not released
+     * returns
+     *      false if the texture could not be created
+     */
+
+    SDL_Texture *texture = SDL_CreateTexture(renderer, surface->format->format, SDL_TEXTUREACCESS_STATIC,
+                                             surface->w, surface->h);
+    if (!texture) {
+        printf("Error creating texture: %s\n", SDL_GetError());
+        return false;
+    }
+
+    if (SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch) != 0) {
+        printf("Error updating texture: %s\n", SDL_GetError());
+        SDL_DestroyTexture(texture);
+        return false;
+    }
+
+    // The pages are transparent around the sprites
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    atlas->pages[page] = texture;
+    return true;
+}
+
+const AtlasEntry* find_atlas_entry(const Atlas *atlas, const char *filename) {
+    /*
+     * A function that finds where an image is in the atlas.
+     *
+     * params
+     *      const Atlas *atlas
+     *          A pointer to the struct Atlas
+     *      const char *filename
+     *          The filename of the image
+     * returns
+     *      the AtlasEntry of the image, or NULL if the image is not on an
+     *      available page
+     */
+
+    for (int i=0; i<NUMBER_OF_ATLAS_ENTRIES; i++) {
+        const AtlasEntry *entry = &ATLAS_ENTRIES[i];
+        if (strcmp(entry->filename, filename) != 0)
+            continue;
+
+        if (entry->page < atlas->number_of_pages && atlas->is_page_available[entry->page])
+            return entry;
+        return NULL;
+    }
+    return NULL;
+}
+
+void free_atlas(Atlas *atlas) {
+    /*
+     * A function that releases the textures of the atlas pages.
+     */
+
+    for (int page=0; page<atlas->number_of_pages; page++) {
+        if (atlas->pages[page])
+            SDL_DestroyTexture(atlas->pages[page]);
+        atlas->pages[page] = NULL;
+        atlas->is_page_available[page] = false;
+    }
+    atlas->number_of_pages = 0;
+}
@@ -0,0 +1,32 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "declarations.h"
+
+/*
+ * AtlasEntry is where an image was placed when it was packed into the atlas.
+ */
+typedef struct AtlasEntry {
+    // The filename the image is loaded with, e.g. "../assets/game_elements/pacman.png"
+    const char          *filename;
+    int                 page;
+    SDL_Rect            rect;
+} AtlasEntry;
+
+// The table generated by `tools/atlas_packer.c` when the game is built
+extern const int NUMBER_OF_ATLAS_PAGES;
+extern const char *const ATLAS_PAGE_FILENAMES[];
+extern const int NUMBER_OF_ATLAS_ENTRIES;
+extern const AtlasEntry ATLAS_ENTRIES[];
+
+void prepare_atlas(const AssetPack *pack, Atlas *atlas);
+
+SDL_Surface* decode_atlas_page(const AssetPack *pack, int page);
+
+bool upload_atlas_page(SDL_Renderer *renderer, Atlas *atlas, int page, SDL_Surface *surface);
+
+const AtlasEntry* find_atlas_entry(const Atlas *atlas, const char *filename);
+
+void free_atlas(Atlas *atlas);
+
+#endif // !ATLAS_H
@@ -0,0 +1,131 @@
+/*
+ *  This file, `board_worker.c`, contains the background thread that keeps the
+ *  queue of pregenerated boards filled, so that starting or restarting a game
+ *  only has to take a ready board instead of generating one on the render
+ *  thread.
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdbool.h"
+
+#include "declarations.h"
+#include "board_worker.h"
+#include "core/board_queue.h"
+
+#include "SDL2/SDL.h"
+
+// The longest time, in milliseconds, the worker sleeps when the queue is full
+// before it checks the queue again.
+#define BOARD_WORKER_IDLE_TIMEOUT 250
+
+static int run_board_worker(void *data) {
+    /*
+     * The function run by the worker thread. It refills the queue until it
+     * is full, then sleeps until a board is taken or it is told to stop.
+     *
+     * params
+     *      void *data
+     *          A pointer to the struct BoardWorker that owns the thread
+     */
+
+    BoardWorker *worker = data;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+
+    while (SDL_AtomicGet(&worker->running)) {
+        if (board_queue_refill(&worker->queue) == 0)
+            SDL_SemWaitTimeout(worker->wakeup, BOARD_WORKER_IDLE_TIMEOUT);
+    }
+    return 0;
+}
+
+BoardWorker* start_board_worker(uint64_t seed) {
+    /*
+     * A function that creates the queue of pregenerated boards and starts the
+     * thread that fills it.
+     *
+     * params
+     *      uint64_t seed
+     *          The seed from which the seeds of all pregenerated boards
+     *          are drawn
+     *
+     * returns
+     *      BoardWorker *worker
+     *          A pointer to the struct BoardWorker, which must be released
+     *          with `stop_board_worker`, or NULL if the worker or its
+     *          thread cannot be created, in which case every board is
+     *          generated when it is needed
+     */
+
+    BoardWorker *worker = malloc(sizeof(BoardWorker));
+    if (!worker) {
+        printf("Error creating board worker: out of memory\n");
+        return NULL;
+    }
+    board_queue_init(&worker->queue, seed);
+    SDL_AtomicSet(&worker->running, 1);
+
+    // NOTE:
+    //  Without a semaphore the worker could not sleep while the queue is
+    //  full, and without a thread the queue would stay empty, so in both
+    //  cases there is no worker, and every board is generated when it is
+    //  needed, just like before.
+    worker->wakeup = SDL_CreateSemaphore(0);
+    if (!worker->wakeup) {
+        printf("Error creating board worker: %s\n", SDL_GetError());
+        free(worker);
+        return NULL;
+    }
+
+    worker->thread = SDL_CreateThread(run_board_worker, "board_worker", worker);
+    if (!worker->thread) {
+        printf("Error creating board worker: %s\n", SDL_GetError());
+        SDL_DestroySemaphore(worker->wakeup);
+        free(worker);
+        return NULL;
+    }
+    return worker;
+}
+
+bool take_pregenerated_board(BoardWorker *worker, Board *board, int number_of_foods) {
+    /*
+     * A function that takes a ready board with `number_of_foods` food pieces
+     * out of the queue, and wakes the worker so it can replace it.
+     *
+     * params
+     *      BoardWorker *worker
+     *          A pointer to the struct BoardWorker
+     *      Board *board
+     *          Receives the board, if one is ready
+     *      int number_of_foods
+     *          The number of food pieces, from 2 to 9
+     * returns
+     *      true if a board was ready
+     */
+
+    bool is_ready = board_queue_pop(&worker->queue, number_of_foods, board);
+    SDL_SemPost(worker->wakeup);
+    return is_ready;
+}
+
+void stop_board_worker(BoardWorker *worker) {
+    /*
+     * A function that stops the worker thread, reports how often a board
+     * was ready when one was needed, and releases the worker.
+     */
+
+    if (!worker)
+        return;
+
+    SDL_AtomicSet(&worker->running, 0);
+    SDL_SemPost(worker->wakeup);
+    SDL_WaitThread(worker->thread, NULL);
+
+    BoardQueueStats stats = board_queue_stats(&worker->queue);
+    printf("Pregenerated boards: %lu generated, %lu hits, %lu misses\n",
+           stats.boards_generated, stats.hits, stats.misses);
+
+    SDL_DestroySemaphore(worker->wakeup);
+    free(worker);
+}
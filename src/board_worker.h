@@ -0,0 +1,10 @@
+#ifndef BOARD_WORKER_H
+#define BOARD_WORKER_H
+
+#include "declarations.h"
+
+BoardWorker* start_board_worker(uint64_t seed);
+bool take_pregenerated_board(BoardWorker *worker, Board *board, int number_of_foods);
+void stop_board_worker(BoardWorker *worker);
+
+#endif // !BOARD_WORKER_H
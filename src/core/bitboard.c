@@ -0,0 +1,333 @@
+/*
+ * This file, `bitboard.c`, contains the mask operations and the rules of the
+ * game for the BitBoard representation of the board. The rules behave
+ * exactly like the ones in `board.c`.
+ */
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#include "board.h"
+#include "bitboard.h"
+
+// NOTE:
+//  The following masks were generated for a 10-by-10 board where the cell at
+//  (row, col) is stored in bit `row * 10 + col`.
+static const BoardMask FULL_MASK     = {0xffffffffffffffffULL, 0x0000000fffffffffULL};
+static const BoardMask COLUMN_0_MASK = {0x1004010040100401ULL, 0x0000000004010040ULL};
+static const BoardMask COLUMN_9_MASK = {0x0802008020080200ULL, 0x0000000802008020ULL};
+// The cells that do not touch the border, i.e. rows and columns 1 to 8
+static const BoardMask INTERIOR_MASK = {0xe7f9fe7f9fe7f800ULL, 0x0000000001fe7f9fULL};
+
+static BoardMask shift_mask_left(BoardMask mask, int bits) {
+    /*
+     * A helper function that shifts the 128-bit `mask` towards the higher
+     * bits by `bits`, where 0 < bits < 64.
+     */
+    BoardMask shifted;
+    shifted.high = (mask.high << bits) | (mask.low >> (64 - bits));
+    shifted.low  = mask.low << bits;
+    return board_mask_and(shifted, FULL_MASK);
+}
+
+static BoardMask shift_mask_right(BoardMask mask, int bits) {
+    /*
+     * A helper function that shifts the 128-bit `mask` towards the lower
+     * bits by `bits`, where 0 < bits < 64.
+     */
+    BoardMask shifted;
+    shifted.low  = (mask.low >> bits) | (mask.high << (64 - bits));
+    shifted.high = mask.high >> bits;
+    return shifted;
+}
+
+BoardMask board_mask_shift(BoardMask mask, enum PacmanMove direction) {
+    /*
+     * A function that moves every cell of `mask` one step in `direction`.
+     * Cells that would leave the board are dropped instead of wrapping
+     * around to the next row.
+     *
+     * params
+     *      BoardMask mask
+     *          The set of cells to be moved
+     *      enum PacmanMove direction
+     *          The direction of the move
+     * returns
+     *      BoardMask
+     *          The moved set of cells
+     */
+
+    switch (direction) {
+        case MOVE_PACMAN_UP:
+            return shift_mask_right(mask, BOARD_SIZE);
+        case MOVE_PACMAN_DOWN:
+            return shift_mask_left(mask, BOARD_SIZE);
+        case MOVE_PACMAN_LEFT:
+            return shift_mask_right(board_mask_and_not(mask, COLUMN_0_MASK), 1);
+        case MOVE_PACMAN_RIGHT:
+            return shift_mask_left(board_mask_and_not(mask, COLUMN_9_MASK), 1);
+    }
+    return board_mask_empty();
+}
+
+BoardMask board_mask_neighbors(BoardMask mask) {
+    /*
+     * A function that returns the cells surrounding `mask`, including the
+     * diagonals. For a single cell, this is its 8 adjacent neighbors that
+     * lie inside the board.
+     */
+
+    BoardMask up    = board_mask_shift(mask, MOVE_PACMAN_UP);
+    BoardMask down  = board_mask_shift(mask, MOVE_PACMAN_DOWN);
+    BoardMask rows  = board_mask_or(mask, board_mask_or(up, down));
+
+    BoardMask left  = board_mask_shift(rows, MOVE_PACMAN_LEFT);
+    BoardMask right = board_mask_shift(rows, MOVE_PACMAN_RIGHT);
+
+    return board_mask_or(board_mask_or(up, down), board_mask_or(left, right));
+}
+
+static int lowest_bit_index(uint64_t bits) {
+    /*
+     * A helper function that returns the index of the lowest set bit of a
+     * non-zero `bits`.
+     */
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+BoardMask board_mask_interior(void) {
+    return INTERIOR_MASK;
+}
+
+BoardMask board_mask_full(void) {
+    return FULL_MASK;
+}
+
+int board_mask_first_position(BoardMask mask, BoardPosition *position) {
+    /*
+     * A function that finds the lowest cell in `mask`.
+     *
+     * params
+     *      BoardMask mask
+     *          The set of cells
+     *      BoardPosition *position
+     *          Receives the row and column of the cell, if there is one
+     * returns
+     *      the bit index of the cell, or -1 if `mask` is empty
+     */
+
+    int bit;
+    if (mask.low)
+        bit = lowest_bit_index(mask.low);
+    else if (mask.high)
+        bit = 64 + lowest_bit_index(mask.high);
+    else
+        return -1;
+
+    position->row = bit / BOARD_SIZE;
+    position->col = bit % BOARD_SIZE;
+    return bit;
+}
+
+void bitboard_from_board(BitBoard *bitboard, const Board *board) {
+    /*
+     * A function that converts a Board into a BitBoard.
+     */
+
+    bitboard->blocks = board_mask_empty();
+    bitboard->foods  = board_mask_empty();
+    bitboard->exit   = board_mask_empty();
+    bitboard->pacman = board_mask_empty();
+
+    for (int row=0; row<BOARD_SIZE; row++) {
+        for (int col=0; col<BOARD_SIZE; col++) {
+            BoardMask cell = board_mask_from_position(row, col);
+            switch (board->array[row][col]) {
+                case EMPTY:
+                    break;
+                case PACMAN:
+                    bitboard->pacman = board_mask_or(bitboard->pacman, cell);
+                    break;
+                case FOOD:
+                    bitboard->foods = board_mask_or(bitboard->foods, cell);
+                    break;
+                case BLOCK:
+                    bitboard->blocks = board_mask_or(bitboard->blocks, cell);
+                    break;
+                case EXIT:
+                    bitboard->exit = board_mask_or(bitboard->exit, cell);
+                    break;
+            }
+        }
+    }
+
+    bitboard->number_of_foods = board->number_of_foods;
+    bitboard->total_player_score = board->total_player_score;
+}
+
+void bitboard_to_board(const BitBoard *bitboard, Board *board) {
+    /*
+     * A function that converts a BitBoard back into a Board.
+     */
+
+    for (int row=0; row<BOARD_SIZE; row++) {
+        for (int col=0; col<BOARD_SIZE; col++) {
+            if (board_mask_test(bitboard->pacman, row, col)) {
+                board->array[row][col] = PACMAN;
+                board->pacman_position.row = row;
+                board->pacman_position.col = col;
+            }
+            else if (board_mask_test(bitboard->foods, row, col))
+                board->array[row][col] = FOOD;
+            else if (board_mask_test(bitboard->blocks, row, col))
+                board->array[row][col] = BLOCK;
+            else if (board_mask_test(bitboard->exit, row, col))
+                board->array[row][col] = EXIT;
+            else
+                board->array[row][col] = EMPTY;
+        }
+    }
+
+    board->number_of_foods = bitboard->number_of_foods;
+    board->number_of_blocks = board_mask_popcount(bitboard->blocks);
+    board->total_player_score = bitboard->total_player_score;
+}
+
+bool bitboard_all_foods_eaten(const BitBoard *bitboard) {
+    return board_mask_is_empty(bitboard->foods);
+}
+
+MoveResult bitboard_resolve_move(BitBoard *bitboard, enum PacmanMove pacman_move) {
+
+    /*
+     * A function that applies a single move of Pacman to the bitboard. It
+     * follows the same rules as `resolve_move`.
+     *
+     * params
+     *      BitBoard *bitboard
+     *          A pointer to the struct BitBoard which holds the game
+     *      enum PacmanMove pacman_move
+     *          An enum that represents the pacman move
+     * returns
+     *      MoveResult
+     *          The resulting GameState together with the BoardEvent flags
+     *          that describe what happened during the move.
+     */
+
+    MoveResult result;
+    result.events = BOARD_EVENT_NONE;
+
+    board_mask_first_position(bitboard->pacman, &result.next_position);
+    switch (pacman_move) {
+        case MOVE_PACMAN_UP:    result.next_position.row--; break;
+        case MOVE_PACMAN_DOWN:  result.next_position.row++; break;
+        case MOVE_PACMAN_LEFT:  result.next_position.col--; break;
+        case MOVE_PACMAN_RIGHT: result.next_position.col++; break;
+    }
+
+    BoardMask next = board_mask_shift(bitboard->pacman, pacman_move);
+
+    // Pacman left the board, since the shift dropped it
+    if (board_mask_is_empty(next)) {
+        result.game_state = GAME_LOST_HIT_BORDER;
+        return result;
+    }
+
+    if (!board_mask_is_empty(board_mask_and(next, bitboard->exit))) {
+        result.game_state = bitboard_all_foods_eaten(bitboard) ? GAME_WON : GAME_LOST_INSUFFICIENT_FOOD;
+        return result;
+    }
+
+    if (!board_mask_is_empty(board_mask_and(next, bitboard->blocks))) {
+        result.game_state = GAME_LOST_HIT_BLOCK;
+        return result;
+    }
+
+    if (!board_mask_is_empty(board_mask_and(next, bitboard->foods))) {
+        bitboard->foods = board_mask_and_not(bitboard->foods, next);
+        bitboard->total_player_score++;
+        result.events |= BOARD_EVENT_FOOD_EATEN;
+    }
+
+    bitboard->pacman = next;
+    result.events |= BOARD_EVENT_PACMAN_STEP;
+    result.game_state = GAME_IN_PROGRESS;
+    return result;
+}
+
+int bitboard_count_impassable_neighbors(const BitBoard *bitboard, int row, int col) {
+    /*
+     * A function that counts the impassable neighbors of a cell, just like
+     * `count_impassable_neighbors`, using a single popcount.
+     *
+     * NOTE:
+     *  A neighbor is passable only when it lies inside the board, does not
+     *  touch the border, and holds neither a block nor the exit. Every one of
+     *  the 8 neighbors that is not passable counts as impassable, including
+     *  those beyond the border.
+     */
+
+    BoardMask impassable = board_mask_or(bitboard->blocks, bitboard->exit);
+    BoardMask passable   = board_mask_and_not(INTERIOR_MASK, impassable);
+    BoardMask neighbors  = board_mask_neighbors(board_mask_from_position(row, col));
+
+    return 8 - board_mask_popcount(board_mask_and(neighbors, passable));
+}
+
+BoardMask bitboard_reachable_cells(const BitBoard *bitboard) {
+    /*
+     * A function that finds every cell Pacman can walk to from its current
+     * position without hitting a block and without stepping into the exit.
+     *
+     * NOTE:
+     *  This is a flood fill that grows the whole frontier at once: every
+     *  iteration shifts the reached cells in all 4 directions and keeps the
+     *  ones that are passable. It stops as soon as nothing new is reached,
+     *  which takes at most as many iterations as the longest path.
+     */
+
+    BoardMask passable = board_mask_and_not(FULL_MASK, board_mask_or(bitboard->blocks, bitboard->exit));
+    BoardMask reached  = bitboard->pacman;
+
+    while (true) {
+        BoardMask grown = reached;
+        grown = board_mask_or(grown, board_mask_shift(reached, MOVE_PACMAN_UP));
+        grown = board_mask_or(grown, board_mask_shift(reached, MOVE_PACMAN_DOWN));
+        grown = board_mask_or(grown, board_mask_shift(reached, MOVE_PACMAN_LEFT));
+        grown = board_mask_or(grown, board_mask_shift(reached, MOVE_PACMAN_RIGHT));
+        grown = board_mask_and(grown, passable);
+
+        if (board_mask_equals(grown, reached))
+            return reached;
+        reached = grown;
+    }
+}
+
+bool bitboard_is_solvable(const BitBoard *bitboard) {
+    /*
+     * A function that checks whether the game can be won, i.e. every food is
+     * reachable from Pacman and the exit is next to a reachable cell.
+     */
+
+    BoardMask reached = bitboard_reachable_cells(bitboard);
+
+    bool all_foods_reachable = board_mask_is_empty(board_mask_and_not(bitboard->foods, reached));
+
+    // The exit can be entered from any reachable cell next to it
+    BoardMask exit_entrances = board_mask_or(
+        board_mask_or(board_mask_shift(reached, MOVE_PACMAN_UP), board_mask_shift(reached, MOVE_PACMAN_DOWN)),
+        board_mask_or(board_mask_shift(reached, MOVE_PACMAN_LEFT), board_mask_shift(reached, MOVE_PACMAN_RIGHT))
+    );
+    bool exit_reachable = !board_mask_is_empty(board_mask_and(exit_entrances, bitboard->exit));
+
+    return all_foods_reachable && exit_reachable;
+}
@@ -0,0 +1,115 @@
+/*
+ *  This file, 'bitboard.h', declares an alternative representation of the
+ *  board that stores each kind of BoardElement as a 100-bit occupancy mask
+ *  instead of one enum per cell.
+ *
+ *  The cell at (`row`, `col`) is stored in bit `row * BOARD_SIZE + col`.
+ *  A whole game fits in a few words, neighbors are counted with a popcount
+ *  and Pacman moves by shifting its mask, which makes generating, solving
+ *  and simulating boards in bulk much cheaper than scanning `Board.array`.
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#include "board.h"
+
+/*
+ * BoardMask is a set of cells. Bits 0 to 63 live in `low` and
+ * bits 64 to 99 live in `high`.
+ */
+typedef struct BoardMask {
+    uint64_t low;
+    uint64_t high;
+} BoardMask;
+
+/*
+ * BitBoard holds the same game as the struct Board, one mask per element.
+ */
+typedef struct BitBoard {
+    BoardMask blocks;
+    BoardMask foods;
+    BoardMask exit;
+    BoardMask pacman;
+    // The total number of foods generated in the board
+    int number_of_foods;
+    // Current score of the player
+    int total_player_score;
+} BitBoard;
+
+static inline BoardMask board_mask_empty(void) {
+    BoardMask mask = {0, 0};
+    return mask;
+}
+
+static inline BoardMask board_mask_from_position(int row, int col) {
+    BoardMask mask = {0, 0};
+    int bit = row * BOARD_SIZE + col;
+    if (bit < 64)
+        mask.low = (uint64_t) 1 << bit;
+    else
+        mask.high = (uint64_t) 1 << (bit - 64);
+    return mask;
+}
+
+static inline bool board_mask_test(BoardMask mask, int row, int col) {
+    int bit = row * BOARD_SIZE + col;
+    if (bit < 64)
+        return (mask.low >> bit) & 1;
+    return (mask.high >> (bit - 64)) & 1;
+}
+
+static inline BoardMask board_mask_or(BoardMask a, BoardMask b) {
+    BoardMask mask = {a.low | b.low, a.high | b.high};
+    return mask;
+}
+
+static inline BoardMask board_mask_and(BoardMask a, BoardMask b) {
+    BoardMask mask = {a.low & b.low, a.high & b.high};
+    return mask;
+}
+
+static inline BoardMask board_mask_and_not(BoardMask a, BoardMask b) {
+    BoardMask mask = {a.low & ~b.low, a.high & ~b.high};
+    return mask;
+}
+
+static inline bool board_mask_is_empty(BoardMask mask) {
+    return (mask.low | mask.high) == 0;
+}
+
+static inline bool board_mask_equals(BoardMask a, BoardMask b) {
+    return a.low == b.low && a.high == b.high;
+}
+
+static inline int board_mask_popcount(BoardMask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(mask.low) + __builtin_popcountll(mask.high);
+#else
+    int count = 0;
+    for (uint64_t bits = mask.low; bits; bits &= bits - 1) count++;
+    for (uint64_t bits = mask.high; bits; bits &= bits - 1) count++;
+    return count;
+#endif
+}
+
+BoardMask board_mask_shift(BoardMask mask, enum PacmanMove direction);
+BoardMask board_mask_neighbors(BoardMask mask);
+BoardMask board_mask_interior(void);
+BoardMask board_mask_full(void);
+int board_mask_first_position(BoardMask mask, BoardPosition *position);
+
+void bitboard_from_board(BitBoard *bitboard, const Board *board);
+void bitboard_to_board(const BitBoard *bitboard, Board *board);
+
+MoveResult bitboard_resolve_move(BitBoard *bitboard, enum PacmanMove pacman_move);
+int bitboard_count_impassable_neighbors(const BitBoard *bitboard, int row, int col);
+bool bitboard_all_foods_eaten(const BitBoard *bitboard);
+
+BoardMask bitboard_reachable_cells(const BitBoard *bitboard);
+bool bitboard_is_solvable(const BitBoard *bitboard);
+
+#endif // !BITBOARD_H
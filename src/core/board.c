@@ -0,0 +1,561 @@
+/*
+ * This file, `board.c`, contains the rules of the game and the generation
+ * of new boards. It does not depend on SDL, so it can be used without a
+ * window, a renderer or any loaded assets.
+ */
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+#include "board.h"
+#include "bitboard.h"
+#include "random.h"
+#include "route_table.h"
+#include "solver.h"
+
+static bool is_within_borders(BoardPosition position) {
+    /*
+     * A helper function that checks whether a `position` lies inside the board.
+     */
+
+    bool within_horizontal_borders = position.col >= 0 && position.col < BOARD_SIZE;
+    bool within_vertical_borders   = position.row >= 0 && position.row < BOARD_SIZE;
+    return within_horizontal_borders && within_vertical_borders;
+}
+
+static BoardPosition calculate_next_position(BoardPosition current_position, enum PacmanMove pacman_move) {
+    /*
+     * A helper function that calculates the position Pacman moves into.
+     *
+     * params
+     *      BoardPosition current_position
+     *          The current position of Pacman
+     *      enum PacmanMove pacman_move
+     *          An enum that represents the pacman move
+     * returns
+     *      BoardPosition
+     *          the next position of Pacman, which may lie outside the board
+     */
+
+    BoardPosition next_position = current_position;
+    switch (pacman_move) {
+        case MOVE_PACMAN_UP:
+            next_position.row -= 1;
+            break;
+        case MOVE_PACMAN_DOWN:
+            next_position.row += 1;
+            break;
+        case MOVE_PACMAN_LEFT:
+            next_position.col -= 1;
+            break;
+        case MOVE_PACMAN_RIGHT:
+            next_position.col += 1;
+            break;
+    }
+    return next_position;
+}
+
+static enum GameState check_player_status(BoardPosition next_position, Board *board, unsigned int *events) {
+
+    /*
+     * A function that checks the state of the game based on the
+     * current player status, specifically involving the blocks,
+     * borders and food
+     *
+     * params
+     *      BoardPosition next_position
+     *          A struct holding the next position of Pacman
+     *      Board *board
+     *          A pointer to the struct board which stores all the variables
+     *          related to the game itself.
+     *      unsigned int *events
+     *          The BoardEvent flags of the current move
+     *
+     * returns
+     *      enum GameState
+     *          the `state` of the game when Pacman moves into the `next_position`.
+     *
+     * example
+     *      If Pacman moves into a block on its `next_position`, this function
+     *      will return a `GAME_LOST_HIT_BLOCK` enum.
+     */
+
+    // NOTE:
+    //  The borders must be checked before reading `board->array`, since the
+    //  `next_position` is outside of the array when Pacman leaves the board.
+    if (!is_within_borders(next_position))
+        return GAME_LOST_HIT_BORDER;
+
+    int row = next_position.row;
+    int col = next_position.col;
+
+    switch (board->array[row][col]) {
+        case FOOD:
+            board->total_player_score++;
+            board->array[row][col] = EMPTY;
+            *events |= BOARD_EVENT_FOOD_EATEN;
+
+            if (board->route_table)
+                route_table_eat_food(board->route_table, next_position);
+            break;
+        case BLOCK:
+            return GAME_LOST_HIT_BLOCK;
+        default:
+            break;
+    }
+
+    return GAME_IN_PROGRESS;
+}
+
+static enum GameState check_if_player_won(Board *board) {
+
+    /*
+     * A function that checks if the player won the game, given that
+     * Pacman moves into the exit.
+     *
+     * params
+     *      Board *board
+     *          A pointer to the struct board which stores all the variables
+     *          related to the game itself.
+     * returns
+     *      enum GameState
+     *          GAME_WON if Pacman has eaten all the food pieces, otherwise
+     *          GAME_LOST_INSUFFICIENT_FOOD.
+     */
+
+    if (board->total_player_score == board->number_of_foods)
+        return GAME_WON;
+
+    return GAME_LOST_INSUFFICIENT_FOOD;
+}
+
+MoveResult resolve_move(Board *board, enum PacmanMove pacman_move) {
+
+    /*
+     * A function that applies a single move of Pacman to the board.
+     *
+     * params
+     *      Board *board
+     *          A pointer to the struct board which stores all the variables
+     *          related to the game itself.
+     *      enum PacmanMove pacman_move
+     *          An enum that represents the pacman move
+     * returns
+     *      MoveResult
+     *          The resulting GameState together with the BoardEvent flags
+     *          that describe what happened during the move.
+     *
+     * example
+     *      If Pacman moves into a block, the result will hold a
+     *      `GAME_LOST_HIT_BLOCK` game state and the board is left untouched.
+     */
+
+    BoardPosition current_position = board->pacman_position;
+    board->number_of_moves++;
+
+    MoveResult result;
+    result.next_position = calculate_next_position(current_position, pacman_move);
+    result.events = BOARD_EVENT_NONE;
+
+    BoardPosition next_position = result.next_position;
+
+    if (is_within_borders(next_position) && board->array[next_position.row][next_position.col] == EXIT) {
+        result.game_state = check_if_player_won(board);
+        return result;
+    }
+
+    result.game_state = check_player_status(next_position, board, &result.events);
+    if (result.game_state != GAME_IN_PROGRESS)
+        return result;
+
+    board->array[current_position.row][current_position.col] = EMPTY;
+    board->array[next_position.row][next_position.col] = PACMAN;
+    board->pacman_position = next_position;
+    result.events |= BOARD_EVENT_PACMAN_STEP;
+
+    return result;
+}
+
+int count_impassable_neighbors(const Board* board, int row, int col) {
+    /*
+     * A function that calculates the number of impassable neighbors
+     * there are in a given `row` and `col` variables.
+     *
+     * params
+     *      const Board *board
+     *            A pointer to the struct `Board` which
+     *            contains the variables regarding the game.
+     *      int row
+     *            A variable corresponding to the row index of the
+     *            10-by-10 array.
+     *      int col
+     *            A variable corresponding to the column index of the
+     *            10-by-10 array.
+     * returns
+     *       the number of impassable neighbors adjacent to the
+     *       given row and column.
+     *
+     *  NOTE:
+     *
+     *  We define `impassable_adjacent_neighbors` as the number of
+     *  adjacent spaces around a food piece or an exit that is impossible
+     *  to be passed through. This includes adjacent block or touching the
+     *  borders.
+     *
+     *  Legend:
+     *      - x : block
+     *      - * : food
+     *      - - : border
+     *
+     *  Example:
+     *      x
+     *       *
+     *      ---
+     *  This amounts to 4 impassable_adjacent_neighbors.
+     */
+
+    int impassable_adjacent_neighbors = 0;
+
+    // Loop through all the adjacent neighbors of the row and col
+    for (int i=-1; i<=1; i++) {
+        for (int j=-1; j<=1; j++) {
+
+            if (i == 0 && j == 0) continue;
+
+            int neighbor_row = row + i;
+            int neighbor_col = col + j;
+
+            // Counts the number of adjacent spaces touching or beyond the border
+            if (neighbor_row <= 0 || neighbor_row >= BOARD_SIZE - 1 ||
+                neighbor_col <= 0 || neighbor_col >= BOARD_SIZE - 1) {
+                impassable_adjacent_neighbors++;
+            // Counts the number of adjacent blocks or exit
+            } else if (board->array[neighbor_row][neighbor_col] == BLOCK ||
+                       board->array[neighbor_row][neighbor_col] == EXIT) {
+                impassable_adjacent_neighbors++;
+            }
+        }
+    }
+    return impassable_adjacent_neighbors;
+}
+
+/*
+ * PlacementGrid keeps track of the cells where a board element may still be
+ * placed while a board is generated.
+ *
+ * NOTE:
+ *  Instead of drawing random cells until one happens to be legal, the grid
+ *  keeps the number of impassable neighbors of every cell up to date as
+ *  blocks and the exit are placed, and lists the cells that are currently
+ *  legal. Elements are then drawn straight from that list, so placing them
+ *  takes a bounded amount of time, and an impossible placement is noticed
+ *  as soon as the list runs out.
+ */
+typedef struct PlacementGrid {
+    // The number of impassable neighbors of every cell, as counted by
+    // `count_impassable_neighbors`
+    int impassable_neighbors[BOARD_NUMBER_OF_CELLS];
+    // The cells that are currently legal, in no particular order
+    int eligible_cells[BOARD_NUMBER_OF_CELLS];
+    int number_of_eligible_cells;
+} PlacementGrid;
+
+static bool is_touching_border(int row, int col) {
+    return row <= 0 || row >= BOARD_SIZE - 1 || col <= 0 || col >= BOARD_SIZE - 1;
+}
+
+// NOTE:
+//  The number of impassable neighbors of every cell of an empty board, i.e.
+//  the neighbors that touch or lie beyond the border. This was generated with
+//  `count_impassable_neighbors`.
+static const int BORDER_IMPASSABLE_NEIGHBORS[BOARD_NUMBER_OF_CELLS] = {
+    7, 6, 5, 5, 5, 5, 5, 5, 6, 7,
+    6, 5, 3, 3, 3, 3, 3, 3, 5, 6,
+    5, 3, 0, 0, 0, 0, 0, 0, 3, 5,
+    5, 3, 0, 0, 0, 0, 0, 0, 3, 5,
+    5, 3, 0, 0, 0, 0, 0, 0, 3, 5,
+    5, 3, 0, 0, 0, 0, 0, 0, 3, 5,
+    5, 3, 0, 0, 0, 0, 0, 0, 3, 5,
+    5, 3, 0, 0, 0, 0, 0, 0, 3, 5,
+    6, 5, 3, 3, 3, 3, 3, 3, 5, 6,
+    7, 6, 5, 5, 5, 5, 5, 5, 6, 7,
+};
+
+static void init_placement_grid(PlacementGrid *grid) {
+    /*
+     * A helper function that resets the impassable neighbor counts to the
+     * ones of an empty board.
+     */
+
+    for (int cell=0; cell<BOARD_NUMBER_OF_CELLS; cell++) {
+        grid->impassable_neighbors[cell] = BORDER_IMPASSABLE_NEIGHBORS[cell];
+    }
+    grid->number_of_eligible_cells = 0;
+}
+
+static void mark_cell_impassable(PlacementGrid *grid, int row, int col) {
+    /*
+     * A helper function that updates the counts of the neighbors of a cell
+     * in which a block or the exit was placed.
+     */
+
+    // Cells touching the border are already counted as impassable
+    if (is_touching_border(row, col))
+        return;
+
+    for (int i=-1; i<=1; i++) {
+        for (int j=-1; j<=1; j++) {
+            if (i == 0 && j == 0) continue;
+            grid->impassable_neighbors[(row + i) * BOARD_SIZE + (col + j)]++;
+        }
+    }
+}
+
+static void collect_eligible_cells(PlacementGrid *grid, const Board *board,
+                                   int min_index, int max_index, bool limit_impassable_neighbors) {
+    /*
+     * A helper function that lists the empty cells whose row and column lie
+     * within [min_index, max_index]. If `limit_impassable_neighbors` is true,
+     * only the cells with less than MAX_ADJACENT_IMPASSABLE_NEIGHBORS
+     * impassable neighbors are listed.
+     */
+
+    grid->number_of_eligible_cells = 0;
+    for (int row=min_index; row<=max_index; row++) {
+        for (int col=min_index; col<=max_index; col++) {
+            int cell = row * BOARD_SIZE + col;
+
+            if (board->array[row][col] != EMPTY)
+                continue;
+            if (limit_impassable_neighbors && grid->impassable_neighbors[cell] >= MAX_ADJACENT_IMPASSABLE_NEIGHBORS)
+                continue;
+
+            grid->eligible_cells[grid->number_of_eligible_cells++] = cell;
+        }
+    }
+}
+
+static int take_eligible_cell(PlacementGrid *grid, RandomGenerator *generator) {
+    /*
+     * A helper function that removes a random cell from the eligible cells.
+     *
+     * returns
+     *      the index of the cell, or -1 if there are no eligible cells left
+     */
+
+    if (grid->number_of_eligible_cells == 0)
+        return -1;
+
+    int index = gen_random_num(generator, 0, grid->number_of_eligible_cells - 1);
+    int cell = grid->eligible_cells[index];
+
+    // Fill the gap with the last cell, since the order does not matter
+    grid->number_of_eligible_cells--;
+    grid->eligible_cells[index] = grid->eligible_cells[grid->number_of_eligible_cells];
+    return cell;
+}
+
+static bool fill_board_with_blocks(Board *board, PlacementGrid *grid, RandomGenerator *generator) {
+    /*
+     * A function that fills the board with blocks.
+     *
+     * params
+     *       Board *board
+     *          A pointer to the struct Board
+     *       PlacementGrid *grid
+     *          The legal cells and the impassable neighbor counts
+     *       RandomGenerator *generator
+     *          The generator the positions are drawn from
+     * returns
+     *       false if there was no room left for a block
+     */
+
+    // NOTE:
+    //   To decrease the chances of an impossible win scenario, the blocks
+    //   are only placed in the rows and columns within the range [1,8].
+    collect_eligible_cells(grid, board, 1, BOARD_SIZE - 2, false);
+
+    for (int i=0; i<board->number_of_blocks; i++) {
+        int cell = take_eligible_cell(grid, generator);
+        if (cell < 0)
+            return false;
+
+        board->array[cell / BOARD_SIZE][cell % BOARD_SIZE] = BLOCK;
+        mark_cell_impassable(grid, cell / BOARD_SIZE, cell % BOARD_SIZE);
+    }
+    return true;
+}
+
+static bool fill_board_with_exit(Board *board, PlacementGrid *grid, RandomGenerator *generator) {
+    /*
+     * A function that randomly places an exit on the game board
+     *
+     * params
+     *       Board *board
+     *          A pointer to the struct Board which holds
+     *          variables that are concerned with the game itself.
+     *       PlacementGrid *grid
+     *          The legal cells and the impassable neighbor counts
+     *       RandomGenerator *generator
+     *          The generator the positions are drawn from
+     * returns
+     *       false if there was no legal cell for the exit
+     */
+
+    // NOTE:
+    //  Restricting the row and col to the range [1, 9] ensures that
+    //  pacman will not be adjacent to the exit.
+    collect_eligible_cells(grid, board, 1, BOARD_SIZE - 1, true);
+
+    int cell = take_eligible_cell(grid, generator);
+    if (cell < 0)
+        return false;
+
+    board->array[cell / BOARD_SIZE][cell % BOARD_SIZE] = EXIT;
+    mark_cell_impassable(grid, cell / BOARD_SIZE, cell % BOARD_SIZE);
+    return true;
+}
+
+static bool fill_board_with_foods(Board *board, PlacementGrid *grid, RandomGenerator *generator) {
+    /*
+     * A function that randomly fills the board with food.
+     *
+     * params
+     *       Board *board
+     *          A pointer to the struct Board
+     *       PlacementGrid *grid
+     *          The legal cells and the impassable neighbor counts
+     *       RandomGenerator *generator
+     *          The generator the positions are drawn from
+     * returns
+     *       false if there were not enough legal cells for the food pieces
+     */
+
+    // Foods are passable, so placing one does not change any count
+    collect_eligible_cells(grid, board, 0, BOARD_SIZE - 1, true);
+
+    for (int i=0; i<board->number_of_foods; i++) {
+        int cell = take_eligible_cell(grid, generator);
+        if (cell < 0)
+            return false;
+
+        board->array[cell / BOARD_SIZE][cell % BOARD_SIZE] = FOOD;
+    }
+    return true;
+}
+
+bool is_board_solvable(const Board *board) {
+    /*
+     * A function that checks whether the board can be won, i.e. Pacman can
+     * reach every food piece and then the exit without hitting a block.
+     *
+     * params
+     *      const Board *board
+     *          A pointer to the struct Board to be checked
+     * returns
+     *      true if the board can be won
+     */
+
+    BitBoard bitboard;
+    bitboard_from_board(&bitboard, board);
+    return bitboard_is_solvable(&bitboard);
+}
+
+static bool place_board_elements(Board* board, int number_of_foods, RandomGenerator *generator) {
+    /*
+     * A helper function that resets the board and randomly places its blocks,
+     * exit and foods. This takes time proportional to the number of cells.
+     *
+     * returns
+     *      false if there was no legal cell left for one of the elements
+     */
+
+    // Reset the board array
+    for (int row=0; row<BOARD_SIZE; row++) {
+        for (int col=0; col<BOARD_SIZE; col++) {
+            board->array[row][col] = EMPTY;
+        }
+    }
+
+    // Reset the position of pacman
+    board->array[0][0] = PACMAN;
+    board->pacman_position.row = 0;
+    board->pacman_position.col = 0;
+
+    // Reset the board
+    board->total_player_score = 0;
+    board->number_of_moves = 0;
+    board->route_table = NULL;
+    board->number_of_blocks = NUMBER_OF_BLOCKS;
+    board->number_of_foods = number_of_foods;
+
+    PlacementGrid grid;
+    init_placement_grid(&grid);
+
+    return fill_board_with_blocks(board, &grid, generator) &&
+           fill_board_with_exit(board, &grid, generator) &&
+           fill_board_with_foods(board, &grid, generator);
+}
+
+int generate_board(Board* board, int number_of_foods, uint64_t seed) {
+    /*
+     * A function that resets the board and randomly generates a new game
+     * with `number_of_foods` food pieces that can always be won.
+     *
+     * params
+     *      Board *board
+     *          A pointer to the struct Board which holds
+     *          variables that are concerned with the game itself.
+     *      int number_of_foods
+     *          The number of food pieces to be placed, from 2 to 9
+     *      uint64_t seed
+     *          The seed of the random generator. The same seed and number of
+     *          foods always give the same board, which is how a board can be
+     *          reproduced.
+     * returns
+     *      the number of boards that were generated until a winnable one
+     *      was found, which is also stored in `board->generation_attempts`,
+     *      BOARD_PLACEMENT_FAILED if the elements could not be placed, e.g.
+     *      for a number of foods out of range, or
+     *      BOARD_GENERATION_FAILED if none of the boards could be won
+     *
+     * NOTE:
+     *  The local MAX_ADJACENT_IMPASSABLE_NEIGHBORS heuristic used when placing
+     *  the elements cannot stop the blocks from walling off a food piece or
+     *  the exit, so each board is checked with `is_board_solvable` and
+     *  generated again when it cannot be won. Since every attempt takes a
+     *  bounded time, so does the whole generation. Running out of legal
+     *  cells is not retried, since it means the number of elements does not
+     *  fit the board, so it fails right away.
+     *
+     *  The par of the winnable board is stored in `board->par`.
+     */
+
+    board->seed = seed;
+    board->generation_attempts = 0;
+    board->par = BOARD_UNSOLVABLE;
+
+    if (number_of_foods < MIN_NUMBER_OF_FOOD || number_of_foods > MAX_NUMBER_OF_FOOD)
+        return BOARD_PLACEMENT_FAILED;
+
+    RandomGenerator generator;
+    seed_random_generator(&generator, seed);
+
+    for (int attempts=1; attempts<=MAX_BOARD_GENERATION_ATTEMPTS; attempts++) {
+        // NOTE:
+        //  `is_board_solvable` is much cheaper than `solve_board`, so it
+        //  throws away most of the boards that cannot be won first.
+        if (!place_board_elements(board, number_of_foods, &generator))
+            return BOARD_PLACEMENT_FAILED;
+
+        BoardSolution solution;
+        if (is_board_solvable(board) && solve_board(board, &solution)) {
+            board->generation_attempts = attempts;
+            board->par = solution.par;
+            return attempts;
+        }
+    }
+
+    return BOARD_GENERATION_FAILED;
+}
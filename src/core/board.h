@@ -0,0 +1,183 @@
+/*
+ *  This file, 'board.h', declares the headless core of the game: the board
+ *  itself, the rules that decide how Pacman moves and when the game is won
+ *  or lost, and the random generation of new boards.
+ *
+ *  Nothing under `src/core/` depends on SDL. Instead of playing sounds or
+ *  moving sprites, the rules report what happened through a `MoveResult`,
+ *  and the frontend decides how to present it.
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+// The board is a square grid with BOARD_SIZE rows and columns
+#define BOARD_SIZE 10
+#define BOARD_NUMBER_OF_CELLS (BOARD_SIZE * BOARD_SIZE)
+
+#define NUMBER_OF_BLOCKS 10
+#define MIN_NUMBER_OF_FOOD 2
+#define MAX_NUMBER_OF_FOOD 9
+
+/*
+ *  MAX_ADJACENT_IMPASSABLE_NEIGHBORS is the maximum number of
+ *  adjacent spaces around a food piece or an exit that is impossible
+ *  to be passed through. This includes its adjacent blocks or borders.
+ *
+ *  Legend:
+ *       x  block
+ *       *  food
+ *       -  border
+ *
+ *  Example:
+ *      x
+ *       *
+ *      ---
+ *  This amounts to 4 impassable_adjacent_neighbors.
+ */
+#define MAX_ADJACENT_IMPASSABLE_NEIGHBORS 3
+
+// The number of boards `generate_board` may throw away before giving up on
+// finding one that can be won. In practice, almost every board can be won on
+// the first or second attempt.
+#define MAX_BOARD_GENERATION_ATTEMPTS 1000
+
+// Returned by `generate_board` when none of the boards it placed could be won
+#define BOARD_GENERATION_FAILED -1
+// Returned by `generate_board` when no legal cell was left for one of the
+// blocks, the exit or the foods, which more attempts would not fix
+#define BOARD_PLACEMENT_FAILED -2
+
+/*
+ * BoardElement is an enum that encodes all the possible
+ * elements in the board.
+ */
+enum BoardElement {
+    EMPTY,
+    PACMAN,
+    FOOD,
+    BLOCK,
+    EXIT,
+};
+
+/*
+ * BoardPosition is a struct that holds the `row` and `col` position of a
+ * BoardElement.
+ */
+typedef struct BoardPosition {
+    int row;
+    int col;
+} BoardPosition;
+
+struct RouteTable;
+
+/*
+ * Board is a struct that holds variables
+ * related to the game itself.
+ */
+typedef struct Board {
+    // A 10 by 10, two-dimensional array that encodes the different
+    // positions of all elements in the board.
+    enum BoardElement array[BOARD_SIZE][BOARD_SIZE];
+    // The current position of Pacman in `array`
+    BoardPosition pacman_position;
+    // The total number of foods generated in the board
+    int number_of_foods;
+    // Total total number of blocks generated in the board
+    int number_of_blocks;
+    // Current score of the player
+    int total_player_score;
+    // The seed this board was generated from
+    uint64_t seed;
+    // The number of boards generated until this one, which can be won
+    int generation_attempts;
+    // The least number of moves needed to win this board, see `solve_board`
+    int par;
+    // The number of moves the player made so far
+    int number_of_moves;
+    // The route that hints are taken from, kept up to date as the food
+    // pieces are eaten. This is NULL unless the frontend attaches one.
+    struct RouteTable *route_table;
+} Board;
+
+/*
+ * GameState specifies the following, given that the player state is in-game:
+ *
+ *   GAME_IN_FOOD_NUMBER_INPUT
+ *       - where the player is prompted to choose the number of food
+ *         to be displayed in the game board (from 2 to 9)
+ *
+ *   GAME_IN_PROGRESS
+ *       - where the player plays the game
+ *
+ *   GameState also covers the results of the game:
+ *
+ *       GAME_LOST_HIT_BLOCK
+ *       GAME_LOST_HIT_BORDER
+ *       GAME_LOST_INSUFFICIENT_FOOD
+ *       GAME_WON
+ *
+ *       Results can be one of the following:
+ *            Game Won
+ *                - (1) when Pacman reaches the door after eating all food pieces,
+ *                      without hitting a block or moving out of the border
+ *            Game Lost
+ *                - (2) when Pacman hits a block
+ *                - (3) when Pacman moves out of the border
+ *                - (4) when Pacman reaches the door,
+ *                   without eating all the food pieces
+ */
+enum GameState {
+    GAME_WON,
+    GAME_LOST_HIT_BLOCK,
+    GAME_LOST_HIT_BORDER,
+    GAME_LOST_INSUFFICIENT_FOOD,
+    GAME_IN_PROGRESS,
+    GAME_IN_FOOD_NUMBER_INPUT,
+};
+
+/*
+ * PacmanMove is an enum that handles the movement of pacman on the screen.
+ */
+enum PacmanMove {
+   MOVE_PACMAN_UP,
+   MOVE_PACMAN_DOWN,
+   MOVE_PACMAN_LEFT,
+   MOVE_PACMAN_RIGHT,
+};
+
+/*
+ * BoardEvent is a set of flags that describe what happened on the board
+ * during a single move, aside from the resulting GameState. The frontend
+ * uses these to decide which sounds to play.
+ */
+enum BoardEvent {
+    BOARD_EVENT_NONE        = 0,
+    BOARD_EVENT_PACMAN_STEP = 1 << 0,
+    BOARD_EVENT_FOOD_EATEN  = 1 << 1,
+};
+
+/*
+ * MoveResult is the outcome of resolving a single PacmanMove.
+ */
+typedef struct MoveResult {
+    // The state of the game after the move
+    enum GameState  game_state;
+    // The position Pacman tried to move into
+    BoardPosition   next_position;
+    // A combination of BoardEvent flags
+    unsigned int    events;
+} MoveResult;
+
+int generate_board(Board *board, int number_of_foods, uint64_t seed);
+
+bool is_board_solvable(const Board *board);
+
+MoveResult resolve_move(Board *board, enum PacmanMove pacman_move);
+
+int count_impassable_neighbors(const Board *board, int row, int col);
+
+#endif // !BOARD_H
@@ -0,0 +1,141 @@
+/*
+ * This file, `board_queue.c`, contains the lock-free queue of boards that
+ * are generated ahead of time.
+ */
+
+#include "stdatomic.h"
+#include "stdbool.h"
+
+#include "board.h"
+#include "board_queue.h"
+#include "random.h"
+
+static BoardRing* get_ring(BoardQueue *queue, int number_of_foods) {
+    /*
+     * A helper function that returns the ring holding boards with
+     * `number_of_foods` food pieces.
+     */
+    return &queue->rings[number_of_foods - MIN_NUMBER_OF_FOOD];
+}
+
+void board_queue_init(BoardQueue *queue, uint64_t seed) {
+    /*
+     * A function that empties the queue and resets its counters.
+     *
+     * params
+     *      BoardQueue *queue
+     *          A pointer to the struct BoardQueue to be initialized
+     *      uint64_t seed
+     *          The seed from which the seeds of all generated boards are drawn
+     */
+
+    for (int i=0; i<NUMBER_OF_FOOD_CHOICES; i++) {
+        atomic_init(&queue->rings[i].head, 0);
+        atomic_init(&queue->rings[i].tail, 0);
+    }
+    atomic_init(&queue->hits, 0);
+    atomic_init(&queue->misses, 0);
+    atomic_init(&queue->boards_generated, 0);
+    seed_random_generator(&queue->seed_generator, seed);
+}
+
+int board_queue_refill(BoardQueue *queue) {
+    /*
+     * A function that generates one board for every ring that is not full.
+     * It must only be called by the producer of the queue.
+     *
+     * params
+     *      BoardQueue *queue
+     *          A pointer to the struct BoardQueue to be refilled
+     * returns
+     *      the number of boards generated, which is 0 when the queue is full
+     *
+     * NOTE:
+     *  Only one board per ring is generated per call, so that the number of
+     *  foods the player is most likely to pick next does not have to wait
+     *  for every other ring to be filled.
+     */
+
+    int boards_generated = 0;
+
+    for (int number_of_foods=MIN_NUMBER_OF_FOOD; number_of_foods<=MAX_NUMBER_OF_FOOD; number_of_foods++) {
+        BoardRing *ring = get_ring(queue, number_of_foods);
+
+        unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        if (tail - head >= BOARD_QUEUE_CAPACITY)
+            continue;
+
+        uint64_t seed = next_random(&queue->seed_generator);
+        if (generate_board(&ring->boards[tail % BOARD_QUEUE_CAPACITY], number_of_foods, seed) < 0)
+            continue;
+
+        // Publish the board only after it has been completely written
+        atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+        boards_generated++;
+    }
+
+    atomic_fetch_add_explicit(&queue->boards_generated, boards_generated, memory_order_relaxed);
+    return boards_generated;
+}
+
+bool board_queue_pop(BoardQueue *queue, int number_of_foods, Board *board) {
+    /*
+     * A function that takes a ready board out of the queue. It must only be
+     * called by the consumer of the queue.
+     *
+     * params
+     *      BoardQueue *queue
+     *          A pointer to the struct BoardQueue
+     *      int number_of_foods
+     *          The number of food pieces of the board, from 2 to 9
+     *      Board *board
+     *          Receives a copy of the board, if one is ready
+     * returns
+     *      true if a board was ready, otherwise false and `board` is untouched
+     */
+
+    BoardRing *ring = get_ring(queue, number_of_foods);
+
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head == tail) {
+        atomic_fetch_add_explicit(&queue->misses, 1, memory_order_relaxed);
+        return false;
+    }
+
+    *board = ring->boards[head % BOARD_QUEUE_CAPACITY];
+
+    // Hand the slot back to the producer only after the board was copied
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    atomic_fetch_add_explicit(&queue->hits, 1, memory_order_relaxed);
+    return true;
+}
+
+int board_queue_depth(BoardQueue *queue, int number_of_foods) {
+    /*
+     * A function that returns the number of boards ready for `number_of_foods`.
+     */
+
+    BoardRing *ring = get_ring(queue, number_of_foods);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return (int) (tail - head);
+}
+
+BoardQueueStats board_queue_stats(BoardQueue *queue) {
+    /*
+     * A function that takes a snapshot of the depth and counters of the queue.
+     */
+
+    BoardQueueStats stats;
+    for (int number_of_foods=MIN_NUMBER_OF_FOOD; number_of_foods<=MAX_NUMBER_OF_FOOD; number_of_foods++) {
+        stats.depth[number_of_foods - MIN_NUMBER_OF_FOOD] = board_queue_depth(queue, number_of_foods);
+    }
+    stats.hits             = atomic_load(&queue->hits);
+    stats.misses           = atomic_load(&queue->misses);
+    stats.boards_generated = atomic_load(&queue->boards_generated);
+    return stats;
+}
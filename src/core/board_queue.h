@@ -0,0 +1,71 @@
+/*
+ *  This file, 'board_queue.h', declares a queue of boards that were generated
+ *  ahead of time, so that starting a game does not have to wait for
+ *  `generate_board`.
+ *
+ *  There is one fixed-size ring of boards for every number of foods from
+ *  MIN_NUMBER_OF_FOOD to MAX_NUMBER_OF_FOOD. Each ring has exactly one
+ *  producer, which calls `board_queue_refill`, and one consumer, which calls
+ *  `board_queue_pop`. These may run on different threads without any lock.
+ */
+
+#ifndef BOARD_QUEUE_H
+#define BOARD_QUEUE_H
+
+#include "stdatomic.h"
+#include "stdbool.h"
+
+#include "board.h"
+#include "random.h"
+
+// The number of boards kept ready for each number of foods. This must be a
+// power of two.
+#define BOARD_QUEUE_CAPACITY 4
+
+#define NUMBER_OF_FOOD_CHOICES (MAX_NUMBER_OF_FOOD - MIN_NUMBER_OF_FOOD + 1)
+
+/*
+ * BoardRing is a single-producer, single-consumer ring buffer of boards that
+ * all have the same number of foods. `head` is only written by the consumer
+ * and `tail` is only written by the producer.
+ */
+typedef struct BoardRing {
+    Board               boards[BOARD_QUEUE_CAPACITY];
+    atomic_uint         head;
+    atomic_uint         tail;
+} BoardRing;
+
+/*
+ * BoardQueue holds a BoardRing for every number of foods, as well as the
+ * number of times a board was or was not ready when one was needed.
+ */
+typedef struct BoardQueue {
+    BoardRing           rings[NUMBER_OF_FOOD_CHOICES];
+    atomic_ulong        hits;
+    atomic_ulong        misses;
+    atomic_ulong        boards_generated;
+    // Draws the seed of every board. Only used by the producer.
+    RandomGenerator     seed_generator;
+} BoardQueue;
+
+/*
+ * BoardQueueStats is a snapshot of a BoardQueue, used for reporting.
+ */
+typedef struct BoardQueueStats {
+    int                 depth[NUMBER_OF_FOOD_CHOICES];
+    unsigned long       hits;
+    unsigned long       misses;
+    unsigned long       boards_generated;
+} BoardQueueStats;
+
+void board_queue_init(BoardQueue *queue, uint64_t seed);
+
+int board_queue_refill(BoardQueue *queue);
+
+bool board_queue_pop(BoardQueue *queue, int number_of_foods, Board *board);
+
+int board_queue_depth(BoardQueue *queue, int number_of_foods);
+
+BoardQueueStats board_queue_stats(BoardQueue *queue);
+
+#endif // !BOARD_QUEUE_H
@@ -0,0 +1,98 @@
+/*
+ * This file, `random.c`, contains a small and fast random number generator,
+ * xoshiro256** by David Blackman and Sebastiano Vigna, which replaces the
+ * global `rand()` of the C standard library.
+ */
+
+#include "stdint.h"
+
+#include "random.h"
+
+static uint64_t rotate_left(uint64_t bits, int amount) {
+    return (bits << amount) | (bits >> (64 - amount));
+}
+
+static uint64_t next_splitmix64(uint64_t *state) {
+    /*
+     * A helper function that returns the next number of a splitmix64
+     * generator, which is used to spread a seed over the whole state.
+     */
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void seed_random_generator(RandomGenerator *generator, uint64_t seed) {
+    /*
+     * A function that sets the state of the generator from a `seed`.
+     *
+     * params
+     *      RandomGenerator *generator
+     *          A pointer to the struct RandomGenerator to be seeded
+     *      uint64_t seed
+     *          Any number. The same seed always gives the same numbers.
+     */
+
+    uint64_t splitmix_state = seed;
+    for (int i=0; i<4; i++) {
+        generator->state[i] = next_splitmix64(&splitmix_state);
+    }
+}
+
+uint64_t next_random(RandomGenerator *generator) {
+    /*
+     * A function that returns the next random 64-bit number of the generator.
+     */
+
+    uint64_t *s = generator->state;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+
+    return result;
+}
+
+int gen_random_num(RandomGenerator *generator, int min, int max) {
+    /*
+     * A function that generates a random number with a minimum or maximum
+     *
+     * params:
+     *      RandomGenerator *generator
+     *          the generator the number is drawn from
+     *      int min
+     *          the minimum number that will be generated
+     *      int max
+     *          the maximum number that will be generated
+     * returns:
+     *      a random number generated in the range [min, max], where every
+     *      number is equally likely
+     *
+     * NOTE:
+     *  Taking `rand() % range` favors the smaller numbers whenever `range`
+     *  does not divide the number of possible values. Instead, this scales a
+     *  random 32-bit number into the range with a multiplication, and draws
+     *  again in the rare case that it lands in the biased part, as described
+     *  by Daniel Lemire in "Fast Random Integer Generation in an Interval".
+     */
+
+    uint32_t range = (uint32_t) (max - min + 1);
+    uint64_t scaled = (next_random(generator) >> 32) * range;
+    uint32_t leftover = (uint32_t) scaled;
+
+    if (leftover < range) {
+        uint32_t threshold = (0u - range) % range;
+        while (leftover < threshold) {
+            scaled = (next_random(generator) >> 32) * range;
+            leftover = (uint32_t) scaled;
+        }
+    }
+
+    return min + (int) (scaled >> 32);
+}
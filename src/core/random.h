@@ -0,0 +1,26 @@
+/*
+ *  This file, 'random.h', declares the random number generator used to
+ *  generate boards. Every generator carries its own state, so boards can be
+ *  generated on several threads at once, and a board generated from the same
+ *  seed is always the same board.
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include "stdint.h"
+
+/*
+ * RandomGenerator holds the state of a xoshiro256** generator.
+ */
+typedef struct RandomGenerator {
+    uint64_t state[4];
+} RandomGenerator;
+
+void seed_random_generator(RandomGenerator *generator, uint64_t seed);
+
+uint64_t next_random(RandomGenerator *generator);
+
+int gen_random_num(RandomGenerator *generator, int min, int max);
+
+#endif // !RANDOM_H
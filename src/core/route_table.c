@@ -0,0 +1,215 @@
+/*
+ * This file, `route_table.c`, contains the RouteTable that answers hints
+ * without solving the board again on every keypress.
+ */
+
+#include "stdbool.h"
+#include "string.h"
+
+#include "board.h"
+#include "bitboard.h"
+#include "route_table.h"
+#include "solver.h"
+
+static int cell_of(BoardPosition position) {
+    return position.row * BOARD_SIZE + position.col;
+}
+
+static void measure_distances_from(RouteTable *table, int source, BoardMask passable, BoardMask exit) {
+    /*
+     * A helper function that fills the row of `distances` for the cell
+     * `source`, by growing a BitBoard frontier one move at a time.
+     */
+
+    unsigned char *distances = table->distances[source];
+    memset(distances, ROUTE_UNREACHABLE, BOARD_NUMBER_OF_CELLS);
+    distances[source] = 0;
+
+    BoardMask reached = board_mask_from_position(source / BOARD_SIZE, source % BOARD_SIZE);
+    BoardMask frontier = reached;
+
+    for (int distance=1; !board_mask_is_empty(frontier); distance++) {
+        BoardMask grown = board_mask_shift(frontier, MOVE_PACMAN_UP);
+        grown = board_mask_or(grown, board_mask_shift(frontier, MOVE_PACMAN_DOWN));
+        grown = board_mask_or(grown, board_mask_shift(frontier, MOVE_PACMAN_LEFT));
+        grown = board_mask_or(grown, board_mask_shift(frontier, MOVE_PACMAN_RIGHT));
+
+        if (distances[table->exit_cell] == ROUTE_UNREACHABLE && !board_mask_is_empty(board_mask_and(grown, exit)))
+            distances[table->exit_cell] = (unsigned char) distance;
+
+        frontier = board_mask_and_not(board_mask_and(grown, passable), reached);
+        reached = board_mask_or(reached, frontier);
+
+        BoardMask cells_left = frontier;
+        BoardPosition position;
+        while (board_mask_first_position(cells_left, &position) >= 0) {
+            distances[cell_of(position)] = (unsigned char) distance;
+            cells_left = board_mask_and_not(cells_left, board_mask_from_position(position.row, position.col));
+        }
+    }
+}
+
+static bool order_foods_left(RouteTable *table, int start_cell) {
+    /*
+     * A helper function that puts `food_cells` in the order of an optimal
+     * route from `start_cell`, using the distances of the table.
+     *
+     * returns
+     *      false if the board cannot be won from `start_cell`
+     */
+
+    int number_of_foods = table->number_of_foods_left;
+
+    int from_start[MAX_NUMBER_OF_FOOD + 1] = {0};
+    int between[MAX_NUMBER_OF_FOOD][MAX_NUMBER_OF_FOOD + 1];
+
+    for (int i=0; i<=number_of_foods; i++) {
+        int to = (i == number_of_foods) ? table->exit_cell : table->food_cells[i];
+
+        int distance = table->distances[start_cell][to];
+        from_start[i] = (distance == ROUTE_UNREACHABLE) ? SOLVER_UNREACHABLE : distance;
+
+        for (int from=0; from<number_of_foods; from++) {
+            distance = table->distances[table->food_cells[from]][to];
+            between[from][i] = (distance == ROUTE_UNREACHABLE) ? SOLVER_UNREACHABLE : distance;
+        }
+    }
+
+    int food_order[MAX_NUMBER_OF_FOOD];
+    if (order_foods(number_of_foods, from_start, (const int (*)[MAX_NUMBER_OF_FOOD + 1]) between, food_order) == BOARD_UNSOLVABLE)
+        return false;
+
+    int food_cells[MAX_NUMBER_OF_FOOD];
+    for (int order=0; order<number_of_foods; order++) {
+        food_cells[order] = table->food_cells[food_order[order]];
+    }
+    memcpy(table->food_cells, food_cells, sizeof(int) * number_of_foods);
+    return true;
+}
+
+bool build_route_table(RouteTable *table, const Board *board) {
+    /*
+     * A function that measures the distances between all cells of the board
+     * and finds an optimal route through its food pieces.
+     *
+     * params
+     *      RouteTable *table
+     *          The struct RouteTable to be built
+     *      const Board *board
+     *          A pointer to the struct Board of the game that just started
+     * returns
+     *      false if the board cannot be won
+     *
+     * NOTE:
+     *  This is about a hundred breadth-first searches, which is why it is
+     *  only done once per game.
+     */
+
+    BitBoard bitboard;
+    bitboard_from_board(&bitboard, board);
+
+    BoardPosition exit_position;
+    board_mask_first_position(bitboard.exit, &exit_position);
+    table->exit_cell = cell_of(exit_position);
+
+    BoardMask passable = board_mask_and_not(board_mask_full(), board_mask_or(bitboard.blocks, bitboard.exit));
+
+    for (int cell=0; cell<BOARD_NUMBER_OF_CELLS; cell++) {
+        if (board_mask_test(passable, cell / BOARD_SIZE, cell % BOARD_SIZE)) {
+            measure_distances_from(table, cell, passable, bitboard.exit);
+        } else {
+            // Pacman never stands on a block, nor moves out of the exit
+            memset(table->distances[cell], ROUTE_UNREACHABLE, BOARD_NUMBER_OF_CELLS);
+            table->distances[cell][cell] = 0;
+        }
+    }
+
+    table->number_of_foods_left = 0;
+    BoardMask foods_left = bitboard.foods;
+    BoardPosition position;
+    while (table->number_of_foods_left < MAX_NUMBER_OF_FOOD && board_mask_first_position(foods_left, &position) >= 0) {
+        table->food_cells[table->number_of_foods_left++] = cell_of(position);
+        foods_left = board_mask_and_not(foods_left, board_mask_from_position(position.row, position.col));
+    }
+
+    return order_foods_left(table, cell_of(board->pacman_position));
+}
+
+void route_table_eat_food(RouteTable *table, BoardPosition food_position) {
+    /*
+     * A function that removes an eaten food piece from the route.
+     *
+     * params
+     *      RouteTable *table
+     *          The struct RouteTable of the game
+     *      BoardPosition food_position
+     *          The position of the food piece that Pacman just ate
+     *
+     * NOTE:
+     *  When Pacman eats the food piece that is next on the route, the rest
+     *  of the route is still optimal, so it is only shifted. Otherwise, the
+     *  food pieces left are ordered again from the cached distances, which
+     *  needs no breadth-first search.
+     */
+
+    int food_cell = cell_of(food_position);
+
+    int eaten = -1;
+    for (int i=0; i<table->number_of_foods_left; i++) {
+        if (table->food_cells[i] == food_cell)
+            eaten = i;
+    }
+    if (eaten < 0)
+        return;
+
+    for (int i=eaten; i<table->number_of_foods_left - 1; i++) {
+        table->food_cells[i] = table->food_cells[i + 1];
+    }
+    table->number_of_foods_left--;
+
+    if (eaten != 0)
+        order_foods_left(table, food_cell);
+}
+
+bool route_table_next_step(const RouteTable *table, BoardPosition pacman_position, enum PacmanMove *move) {
+    /*
+     * A function that finds the next move of an optimal route, which leads
+     * to the next food piece, or to the exit once every food piece is eaten.
+     *
+     * params
+     *      const RouteTable *table
+     *          The struct RouteTable of the game
+     *      BoardPosition pacman_position
+     *          The current position of Pacman
+     *      enum PacmanMove *move
+     *          Receives the next move
+     * returns
+     *      false if the target cannot be reached from `pacman_position`
+     */
+
+    int target = (table->number_of_foods_left > 0) ? table->food_cells[0] : table->exit_cell;
+    int distance = table->distances[cell_of(pacman_position)][target];
+
+    if (distance == ROUTE_UNREACHABLE || distance == 0)
+        return false;
+
+    static const enum PacmanMove MOVES[] = {
+        MOVE_PACMAN_UP, MOVE_PACMAN_DOWN, MOVE_PACMAN_LEFT, MOVE_PACMAN_RIGHT,
+    };
+    static const int ROW_STEPS[] = {-1, 1, 0, 0};
+    static const int COL_STEPS[] = {0, 0, -1, 1};
+
+    for (int i=0; i<4; i++) {
+        int row = pacman_position.row + ROW_STEPS[i];
+        int col = pacman_position.col + COL_STEPS[i];
+        if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE)
+            continue;
+
+        int step = row * BOARD_SIZE + col;
+        if (step == target || table->distances[step][target] == distance - 1) {
+            *move = MOVES[i];
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,43 @@
+/*
+ *  This file, 'route_table.h', declares the RouteTable, which holds the
+ *  shortest distance between every two cells of a board, along with the
+ *  optimal order of the food pieces that are left. It is built once per
+ *  game, so that a hint is only a lookup.
+ */
+
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include "stdbool.h"
+
+#include "board.h"
+
+// The distance between two cells that are not connected
+#define ROUTE_UNREACHABLE 255
+
+/*
+ * RouteTable is the cached route of a board that is being played.
+ *
+ * NOTE:
+ *  Blocks never move, so `distances` stays valid for the whole game. Only
+ *  the order of the food pieces changes as they are eaten.
+ */
+typedef struct RouteTable {
+    // distances[from][to] is the number of moves from cell `from` to cell
+    // `to`, where a cell is `row * BOARD_SIZE + col`. Pacman can move into
+    // the exit, but not out of it.
+    unsigned char   distances[BOARD_NUMBER_OF_CELLS][BOARD_NUMBER_OF_CELLS];
+    // The cell of the exit
+    int             exit_cell;
+    // The cells of the food pieces left, in the order of an optimal route
+    int             food_cells[MAX_NUMBER_OF_FOOD];
+    int             number_of_foods_left;
+} RouteTable;
+
+bool build_route_table(RouteTable *table, const Board *board);
+
+void route_table_eat_food(RouteTable *table, BoardPosition food_position);
+
+bool route_table_next_step(const RouteTable *table, BoardPosition pacman_position, enum PacmanMove *move);
+
+#endif // !ROUTE_TABLE_H
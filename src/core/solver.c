@@ -0,0 +1,258 @@
+/*
+ * This file, `solver.c`, contains the solver that finds the least number of
+ * moves needed to win a board.
+ *
+ * NOTE:
+ *  The solver works in two steps. First, it measures the shortest distance
+ *  between Pacman, every food piece and the exit with a breadth-first search
+ *  that grows a whole BitBoard frontier at once. Then, it finds the best
+ *  order to eat the food pieces with the Held-Karp algorithm, which tries
+ *  every subset of food pieces instead of every ordering of them. With at
+ *  most 9 food pieces, this takes a few microseconds per board.
+ */
+
+#include "stdbool.h"
+
+#include "board.h"
+#include "bitboard.h"
+#include "solver.h"
+
+static int lowest_food(int foods) {
+    /*
+     * A helper function that returns the index of the lowest food piece in
+     * a non-empty set of food pieces.
+     */
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz((unsigned int) foods);
+#else
+    int index = 0;
+    while (!(foods & 1)) {
+        foods >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+static BoardMask grow_frontier(BoardMask reached) {
+    /*
+     * A helper function that returns the cells one move away from `reached`.
+     */
+
+    BoardMask grown = board_mask_shift(reached, MOVE_PACMAN_UP);
+    grown = board_mask_or(grown, board_mask_shift(reached, MOVE_PACMAN_DOWN));
+    grown = board_mask_or(grown, board_mask_shift(reached, MOVE_PACMAN_LEFT));
+    grown = board_mask_or(grown, board_mask_shift(reached, MOVE_PACMAN_RIGHT));
+    return grown;
+}
+
+static void measure_distances(BoardMask source, BoardMask passable,
+                              const BoardMask *targets, int number_of_targets, int *distances) {
+    /*
+     * A helper function that measures the number of moves from `source` to
+     * each of the `targets`, only walking through `passable` cells.
+     *
+     * NOTE:
+     *  A target does not have to be passable itself. This is how the exit is
+     *  measured, since Pacman can move into it but never through it.
+     */
+
+    int targets_left = number_of_targets;
+    for (int i=0; i<number_of_targets; i++) {
+        distances[i] = SOLVER_UNREACHABLE;
+        if (!board_mask_is_empty(board_mask_and(targets[i], source))) {
+            distances[i] = 0;
+            targets_left--;
+        }
+    }
+
+    BoardMask reached = source;
+    for (int distance=1; targets_left > 0; distance++) {
+        BoardMask grown = grow_frontier(reached);
+
+        for (int i=0; i<number_of_targets; i++) {
+            if (distances[i] == SOLVER_UNREACHABLE && !board_mask_is_empty(board_mask_and(grown, targets[i]))) {
+                distances[i] = distance;
+                targets_left--;
+            }
+        }
+
+        BoardMask next = board_mask_or(reached, board_mask_and(grown, passable));
+
+        // Nothing new was reached, so the remaining targets are unreachable
+        if (board_mask_equals(next, reached))
+            break;
+        reached = next;
+    }
+}
+
+int order_foods(int number_of_foods,
+                const int *from_start,
+                const int (*between)[MAX_NUMBER_OF_FOOD + 1],
+                int *food_order) {
+    /*
+     * A function that finds the order of the food pieces that wins in the
+     * least number of moves, given the distances between them.
+     *
+     * params
+     *      int number_of_foods
+     *          The number of food pieces left, from 0 to MAX_NUMBER_OF_FOOD.
+     *          Index `number_of_foods` of the distances is the exit.
+     *      const int *from_start
+     *          The distance from Pacman to each food piece and to the exit
+     *      const int (*between)[MAX_NUMBER_OF_FOOD + 1]
+     *          between[i][j] is the distance from food piece i to food
+     *          piece j, or to the exit
+     *      int *food_order
+     *          Receives the indices of the food pieces in the order in
+     *          which they are eaten
+     * returns
+     *      the least number of moves needed to win, or BOARD_UNSOLVABLE
+     *
+     * NOTE:
+     *  Distances of SOLVER_UNREACHABLE mark pieces that cannot be reached.
+     */
+
+    int exit_index = number_of_foods;
+
+    if (number_of_foods == 0) {
+        if (from_start[exit_index] >= SOLVER_UNREACHABLE)
+            return BOARD_UNSOLVABLE;
+        return from_start[exit_index];
+    }
+
+    // NOTE:
+    //  shortest[eaten][last] is the least number of moves needed to eat the
+    //  set of food pieces `eaten`, ending on food piece `last`.
+    //  previous[eaten][last] is the food piece eaten right before `last`.
+    static const int NO_FOOD = -1;
+    int full_set = (1 << number_of_foods) - 1;
+    int shortest[1 << MAX_NUMBER_OF_FOOD][MAX_NUMBER_OF_FOOD];
+    signed char previous[1 << MAX_NUMBER_OF_FOOD][MAX_NUMBER_OF_FOOD];
+
+    for (int eaten=1; eaten<=full_set; eaten++) {
+        for (int last=0; last<number_of_foods; last++) {
+            shortest[eaten][last] = SOLVER_UNREACHABLE;
+            previous[eaten][last] = NO_FOOD;
+        }
+    }
+    for (int i=0; i<number_of_foods; i++) {
+        shortest[1 << i][i] = from_start[i];
+    }
+
+    // NOTE:
+    //  Only the food pieces in `eaten` can be the last one, and only the
+    //  others can be next, so both loops walk the set bits directly.
+    for (int eaten=1; eaten<=full_set; eaten++) {
+        for (int lasts=eaten; lasts; lasts &= lasts - 1) {
+            int last = lowest_food(lasts);
+            int moves = shortest[eaten][last];
+            if (moves >= SOLVER_UNREACHABLE)
+                continue;
+
+            for (int nexts=full_set & ~eaten; nexts; nexts &= nexts - 1) {
+                int next = lowest_food(nexts);
+                int next_eaten = eaten | (1 << next);
+                int next_moves = moves + between[last][next];
+                if (next_moves < shortest[next_eaten][next]) {
+                    shortest[next_eaten][next] = next_moves;
+                    previous[next_eaten][next] = (signed char) last;
+                }
+            }
+        }
+    }
+
+    // Finish with the move into the exit
+    int best_last = NO_FOOD;
+    int best_moves = SOLVER_UNREACHABLE;
+    for (int last=0; last<number_of_foods; last++) {
+        int moves = shortest[full_set][last] + between[last][exit_index];
+        if (moves < best_moves) {
+            best_moves = moves;
+            best_last = last;
+        }
+    }
+
+    if (best_last == NO_FOOD)
+        return BOARD_UNSOLVABLE;
+
+    // Walk back through `previous` to recover the order of the food pieces
+    int eaten = full_set;
+    int last = best_last;
+    for (int order=number_of_foods - 1; order>=0; order--) {
+        food_order[order] = last;
+        int before = previous[eaten][last];
+        eaten &= ~(1 << last);
+        last = before;
+    }
+
+    return best_moves;
+}
+
+bool bitboard_solve(const BitBoard *bitboard, BoardSolution *solution) {
+    /*
+     * A function that finds an optimal way to win the board from its
+     * current state.
+     *
+     * params
+     *      const BitBoard *bitboard
+     *          A pointer to the struct BitBoard to be solved
+     *      BoardSolution *solution
+     *          Receives the par and the optimal order of the food pieces
+     * returns
+     *      false if the board cannot be won
+     */
+
+    // The food pieces, followed by the exit
+    BoardMask targets[MAX_NUMBER_OF_FOOD + 1];
+    BoardPosition food_positions[MAX_NUMBER_OF_FOOD];
+    int number_of_foods = 0;
+
+    BoardMask foods_left = bitboard->foods;
+    BoardPosition position;
+    while (number_of_foods < MAX_NUMBER_OF_FOOD && board_mask_first_position(foods_left, &position) >= 0) {
+        targets[number_of_foods] = board_mask_from_position(position.row, position.col);
+        food_positions[number_of_foods] = position;
+        foods_left = board_mask_and_not(foods_left, targets[number_of_foods]);
+        number_of_foods++;
+    }
+    targets[number_of_foods] = bitboard->exit;
+
+    solution->number_of_foods = number_of_foods;
+    solution->par = BOARD_UNSOLVABLE;
+
+    BoardMask passable = board_mask_and_not(board_mask_full(), board_mask_or(bitboard->blocks, bitboard->exit));
+
+    // from_pacman[i] is the distance from Pacman to target i, and
+    // between[i][j] is the distance from food i to target j
+    int from_pacman[MAX_NUMBER_OF_FOOD + 1];
+    int between[MAX_NUMBER_OF_FOOD][MAX_NUMBER_OF_FOOD + 1];
+
+    measure_distances(bitboard->pacman, passable, targets, number_of_foods + 1, from_pacman);
+    for (int i=0; i<number_of_foods; i++) {
+        if (from_pacman[i] >= SOLVER_UNREACHABLE)
+            return false;
+        measure_distances(targets[i], passable, targets, number_of_foods + 1, between[i]);
+    }
+
+    int food_order[MAX_NUMBER_OF_FOOD];
+    solution->par = order_foods(number_of_foods, from_pacman, (const int (*)[MAX_NUMBER_OF_FOOD + 1]) between, food_order);
+    if (solution->par == BOARD_UNSOLVABLE)
+        return false;
+
+    for (int order=0; order<number_of_foods; order++) {
+        solution->food_order[order] = food_positions[food_order[order]];
+    }
+    return true;
+}
+
+bool solve_board(const Board *board, BoardSolution *solution) {
+    /*
+     * A function that finds an optimal way to win the board from its
+     * current state. See `bitboard_solve`.
+     */
+
+    BitBoard bitboard;
+    bitboard_from_board(&bitboard, board);
+    return bitboard_solve(&bitboard, solution);
+}
@@ -0,0 +1,45 @@
+/*
+ *  This file, 'solver.h', declares the solver that finds the least number of
+ *  moves needed to eat every food piece and then reach the exit. This number
+ *  is the "par" of a board.
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "stdbool.h"
+#include "limits.h"
+
+#include "board.h"
+#include "bitboard.h"
+
+// The par of a board that cannot be won
+#define BOARD_UNSOLVABLE -1
+
+// The distance to a piece that cannot be reached. It is small enough that
+// adding up a few of them does not overflow.
+#define SOLVER_UNREACHABLE (INT_MAX / 16)
+
+/*
+ * BoardSolution is an optimal way to win the board from its current state.
+ */
+typedef struct BoardSolution {
+    // The least number of moves needed to win, including the final move
+    // into the exit, or BOARD_UNSOLVABLE
+    int             par;
+    // The number of food pieces left on the board
+    int             number_of_foods;
+    // The order in which the food pieces are eaten in an optimal route
+    BoardPosition   food_order[MAX_NUMBER_OF_FOOD];
+} BoardSolution;
+
+int order_foods(int number_of_foods,
+                const int *from_start,
+                const int (*between)[MAX_NUMBER_OF_FOOD + 1],
+                int *food_order);
+
+bool solve_board(const Board *board, BoardSolution *solution);
+
+bool bitboard_solve(const BitBoard *bitboard, BoardSolution *solution);
+
+#endif // !SOLVER_H
@@ -11,34 +11,95 @@
 
 #define SPRITE_UPDATE_DELAY 100
 
-#define NUMBER_OF_BLOCKS 10
+// The target frame rates that are not a number of frames per second
+#define FRAME_RATE_UNCAPPED 0
+#define FRAME_RATE_MATCH_DISPLAY -1
+
+// The refresh rate assumed when the display does not report one
+#define DEFAULT_REFRESH_RATE 60
+
+// The number of frames measured to find out whether vsync is active
+#define FRAME_PACER_CALIBRATION_FRAMES 30
+
+// The longest time, in milliseconds, the main loop waits for an event while
+// nothing on the screen changes
+#define IDLE_EVENT_TIMEOUT 1000
+
+// The number of milliseconds a wrong input reminder stays on the screen
+#define REMINDER_DURATION 3000
+
 #define NUMBER_OF_PAGES_IN_TUTORIAL 7
 #define NUMBER_OF_FOOD_INPUT_PROMPTS 9
 #define NUMBER_OF_SCORE_VISUALS 10
-#define MAX_NUMBER_OF_FOOD 9
+
+// The largest number of atlas pages the sprites are packed into
+#define MAX_ATLAS_PAGES 8
+
+// The most draw commands a frame can queue before they are drawn
+#define MAX_RENDER_COMMANDS 1024
+
+// The format the audio device is opened with. Sounds in the asset pack are
+// converted to it ahead of time.
+#define AUDIO_FREQUENCY 44100
+#define AUDIO_FORMAT MIX_DEFAULT_FORMAT
+#define AUDIO_CHANNELS 2
+// The samples the audio device mixes at a time, about 46 ms of sound. The
+// smaller low latency buffer, about 12 ms, is used with `--low-latency-audio`.
+#define AUDIO_CHUNK_SIZE 2048
+#define LOW_LATENCY_AUDIO_CHUNK_SIZE 512
+
+// The asset pack written when the game is built, relative to the bin/ folder
+#define ASSET_PACK_FILENAME "assets.pack"
+
+// The most threads that decode assets while the game starts, and the most
+// assets they can be given
+#define MAX_ASSET_WORKERS 4
+#define MAX_ASSET_JOBS 32
+
+// The most sprites the struct Assets holds
+#define MAX_NUMBER_OF_SPRITES 128
+
+// The mixer channels the sound effects are played on, i.e. the most sound
+// effects that are ever mixed at once
+#define NUMBER_OF_VOICES 8
+
+// The frames the performance overlay keeps, which its graph shows one bar each
+#define PERF_HUD_FRAMES 256
+
+// The file the frames kept by the performance overlay are written to, in
+// the bin/ folder, when F4 is pressed
+#define PERF_HUD_CSV_FILENAME "frame_times.csv"
+
+// The frames `--benchmark` makes room for at first. It grows as needed.
+#define FRAME_BENCHMARK_INITIAL_CAPACITY 4096
+
+// The most events taken from SDL's queue at once. Every event that is queued
+// by the time a frame starts is handled before it is drawn.
+#define MAX_EVENTS_PER_BATCH 64
+
+// The keys whose latency is kept, and the most keys that can be handled
+// between two frames
+#define INPUT_LATENCY_SAMPLES 1024
+#define MAX_PENDING_INPUTS 64
+
+// The most zones the trace keeps. Once it is full, the oldest ones are
+// overwritten.
+#define TRACE_BUFFER_SIZE 65536
+
+// The recordings of sessions start with REPLAY_MAGIC, followed by the
+// version of their format as two bytes, least significant first
+#define REPLAY_MAGIC "GPRP"
+#define REPLAY_MAGIC_LENGTH 4
+#define REPLAY_VERSION 1
+
+// The texture memory, in megabytes, that the atlas pages may use unless it is
+// set with `--texture-budget`
+#define DEFAULT_TEXTURE_BUDGET_MB 32
 
 // Defines the size (in pixels) of each box in the grid, which appears in the game
 // itself.
 #define BOX_WIDTH 45
 
-/*
- *  MAX_ADJACENT_IMPASSABLE_NEIGHBORS is the maximum number of
- *  adjacent spaces around a food piece or an exit that is impossible
- *  to be passed through. This includes its adjacent blocks or borders.
- *
- *  Legend: 
- *       x  block
- *       *  food
- *       -  border
- *
- *  Example:
- *      x
- *       *
- *      ---
- *  This amounts to 4 impassable_adjacent_neighbors. 
- */
-#define MAX_ADJACENT_IMPASSABLE_NEIGHBORS 3
-
 /*
  * ELEMENT_INITIAL_POSITION_X and ELEMENT_INITIAL_POSITION_Y
  * is the initial position of a BoardElement.
@@ -46,34 +107,79 @@
 #define ELEMENT_INITIAL_POSITION_X (95 + 12)
 #define ELEMENT_INITIAL_POSITION_Y (95 + 6)
 
+/*
+ * BOX_INITIAL_POSITION_X and BOX_INITIAL_POSITION_Y
+ * is the position of the top left box of the grid.
+ */
+#define BOX_INITIAL_POSITION_X 95
+#define BOX_INITIAL_POSITION_Y 95
+
 #include "stdbool.h"
+#include "stdio.h"
 
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_mixer.h"
 #include "SDL2/SDL_image.h"
 
+// The board, its elements and the rules of the game are declared in the
+// headless game core, which does not depend on SDL.
+#include "core/board.h"
+#include "core/board_queue.h"
+#include "core/random.h"
+#include "core/route_table.h"
+
 /*
- * BoardElement is an enum that encodes all the possible 
- * elements in the board.
+ * RenderLayer is the order in which things are drawn. Everything on a layer
+ * is drawn above everything on the layers before it. Things on the same
+ * layer must not overlap, since they may be drawn in any order.
  */
-
-enum BoardElement {
-    EMPTY,
-    PACMAN,
-    FOOD,
-    BLOCK,
-    EXIT,
+enum RenderLayer {
+    // Screens that fill the window, such as the menu or the board itself
+    RENDER_LAYER_SCREEN,
+    // Pacman, the food pieces, the blocks and the exit
+    RENDER_LAYER_BOARD,
+    // The score, the par and the hint
+    RENDER_LAYER_OVERLAY,
+    RENDER_LAYER_REMINDER,
+    RENDER_LAYER_DIALOG,
 };
 
 /*
- * BoardPosition is a struct that holds the `x` and `y` position of a
- * BoardElement.
+ * RenderCommand is a textured or a filled rectangle that is waiting in the
+ * RenderQueue to be drawn.
  */
-typedef struct BoardPosition {
-    int row;
-    int col;
-} BoardPosition;
+typedef struct RenderCommand {
+    enum RenderLayer    layer;
+    // The number of commands queued before this one in the frame, which
+    // keeps the order of the commands that share a layer and a texture
+    int                 order;
+    // NULL for a rectangle filled with `color`
+    SDL_Texture         *texture;
+    SDL_Rect            source;
+    SDL_Rect            destination;
+    SDL_Color           color;
+    float               rotation;
+    SDL_RendererFlip    flip;
+} RenderCommand;
 
+/*
+ * RenderQueue collects the draw commands of a frame, so that commands using
+ * the same texture can be drawn together in a single draw call.
+ */
+typedef struct RenderQueue {
+    SDL_Renderer        *renderer;
+    RenderCommand       commands[MAX_RENDER_COMMANDS];
+    int                 number_of_commands;
+    // The draw calls made by the last flush of the queue
+    int                 draw_calls;
+    // Whether the renderer supports SDL_RenderGeometry. Otherwise, every
+    // command is drawn on its own.
+    bool                uses_geometry;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    SDL_Vertex          vertices[MAX_RENDER_COMMANDS * 4];
+    int                 indices[MAX_RENDER_COMMANDS * 6];
+#endif
+} RenderQueue;
 
 /*
  * Sprite is a struct that holds related variables 
@@ -81,7 +187,17 @@ typedef struct BoardPosition {
  */
 typedef struct Sprite {
     SDL_Renderer        *renderer;
+    RenderQueue         *render_queue;
+    enum RenderLayer    layer;
     SDL_Texture         *texture;
+    // The texture of the sprite, or NULL if it is on an atlas page, which
+    // is then taken from `texture_cache` every time the sprite is drawn
+    struct TextureCache *texture_cache;
+    // The part of the texture that holds the image, since the texture may
+    // be an atlas page shared with other sprites
+    SDL_Rect            source;
+    // The atlas page the image is on, or -1 if the sprite has its own texture
+    int                 atlas_page;
     SDL_Rect            rect;
     SDL_RendererFlip    flip;
     float               rotation;
@@ -90,12 +206,208 @@ typedef struct Sprite {
     int                 current_frame;
 } Sprite;
 
+/*
+ * AssetPack is the asset pack of the game, mapped into memory. It holds the
+ * atlas pages, run-length encoded, and the sounds, already decoded. See
+ * `asset_pack.h`.
+ */
+typedef struct AssetPack {
+    // The whole file, or NULL if the pack could not be opened
+    const unsigned char         *data;
+    size_t                      size;
+    const struct AssetPackEntry *entries;
+    int                         number_of_entries;
+    // Whether `data` is the pack embedded into the executable, rather than
+    // a mapped file
+    bool                        is_embedded;
+#ifdef _WIN32
+    void                        *file;
+    void                        *mapping;
+#endif
+} AssetPack;
+
+/*
+ * Atlas holds the textures of the atlas pages, which are the few large images
+ * that most sprites are packed into when the game is built.
+ */
+typedef struct Atlas {
+    SDL_Texture         *pages[MAX_ATLAS_PAGES];
+    // Whether the page is in the asset pack or has a PNG file, i.e. whether
+    // the sprites on it can wait for it to load
+    bool                is_page_available[MAX_ATLAS_PAGES];
+    int                 number_of_pages;
+} Atlas;
+
+/*
+ * TextureCacheStats counts how the atlas pages were found, for reporting.
+ */
+typedef struct TextureCacheStats {
+    // A page was drawn that was already loaded, or had to be loaded
+    unsigned long       hits;
+    unsigned long       misses;
+    unsigned long       evictions;
+    unsigned long       prefetches;
+} TextureCacheStats;
+
+/*
+ * TextureCache loads the atlas pages when they are first drawn, and releases
+ * the least recently drawn ones to stay within a memory budget.
+ */
+typedef struct TextureCache {
+    Atlas               *atlas;
+    const AssetPack     *pack;
+    SDL_Renderer        *renderer;
+    // The most memory, in bytes, the loaded pages may use
+    size_t              budget;
+    size_t              bytes_used;
+    size_t              page_bytes[MAX_ATLAS_PAGES];
+    // The frame each page was last drawn in. The pages drawn in the current
+    // frame are never released, since the render queue still uses them.
+    unsigned long       last_used[MAX_ATLAS_PAGES];
+    unsigned long       current_frame;
+    // The pages that are likely to be drawn soon, which are loaded ahead
+    bool                is_prefetch_requested[MAX_ATLAS_PAGES];
+    TextureCacheStats   stats;
+} TextureCache;
+
+enum AssetJobType {
+    ASSET_JOB_ATLAS_PAGE,
+    ASSET_JOB_SOUND,
+    ASSET_JOB_MUSIC,
+};
+
+/*
+ * AssetJob is an asset that is decoded by one of the workers of the
+ * AssetLoader, and then handed over to the render thread.
+ */
+typedef struct AssetJob {
+    enum AssetJobType   type;
+    // Whether the menu can only be shown once this asset is loaded
+    bool                is_needed_by_menu;
+    // The atlas page, or the filename and destination of a sound
+    int                 page;
+    const char          *filename;
+    Mix_Chunk           **chunk;
+    Mix_Music           **music;
+    // Written by the worker, and only read once `is_decoded` is set
+    SDL_Surface         *decoded_page;
+    Mix_Chunk           *decoded_chunk;
+    Mix_Music           *decoded_music;
+    SDL_atomic_t        is_decoded;
+    // Set by the render thread once it took over the asset
+    bool                is_done;
+} AssetJob;
+
+/*
+ * AssetLoader decodes the images and sounds on a pool of worker threads,
+ * while the render thread uploads the decoded images into textures.
+ */
+typedef struct AssetLoader {
+    AssetJob            jobs[MAX_ASSET_JOBS];
+    int                 number_of_jobs;
+    // The next job a worker takes, in order
+    SDL_atomic_t        next_job;
+    SDL_atomic_t        is_cancelled;
+    SDL_Thread          *workers[MAX_ASSET_WORKERS];
+    int                 number_of_workers;
+    // Posted by a worker every time it decoded a job
+    SDL_sem             *job_decoded;
+    const AssetPack     *pack;
+    int                 number_of_jobs_done;
+    int                 number_of_menu_jobs_left;
+} AssetLoader;
+
+/*
+ * SoundEffect names every sound effect, so that the VoiceManager knows how
+ * each of them may be played.
+ */
+enum SoundEffect {
+    SOUND_PACMAN_MUNCH,
+    SOUND_PACMAN_STEP,
+    SOUND_OPTION_SELECT,
+    SOUND_OPTION_CONFIRM,
+    SOUND_QUIT,
+    SOUND_OPEN_ABOUT_GAME,
+    SOUND_START_GAME,
+    SOUND_GAME_NOTIFICATION,
+    SOUND_GAME_WIN,
+    SOUND_GAME_OVER,
+    NUMBER_OF_SOUND_EFFECTS,
+};
+
+/*
+ * Voice is a mixer channel, and the sound effect last played on it.
+ */
+typedef struct Voice {
+    // The sound effect, or -1 if the channel is free
+    int                 sound;
+    int                 priority;
+    // When the sound effect started, in milliseconds since SDL started
+    Uint32              started_at;
+} Voice;
+
+/*
+ * VoiceStats counts what happened to the sound effects that were played,
+ * for reporting.
+ */
+typedef struct VoiceStats {
+    unsigned long       played;
+    // Played again so soon after itself that it was skipped
+    unsigned long       coalesced;
+    // Played on a channel that was still playing another sound effect
+    unsigned long       stolen;
+    // Skipped because every channel played a more important sound effect
+    unsigned long       dropped;
+} VoiceStats;
+
+/*
+ * AudioLatency measures how long a sound effect takes to be heard, from
+ * when the key that played it was pressed, or when it was played if no key
+ * did, until its first samples leave the audio device. It is shared with the
+ * audio thread, which finishes every measurement. All times are in ticks of
+ * SDL's performance counter.
+ */
+typedef struct AudioLatency {
+    SDL_SpinLock        lock;
+    // When the key of the sound effect that was not mixed yet was pressed,
+    // or 0
+    Uint64              played_at;
+    // The rate and the bytes per frame the audio device was opened with
+    int                 frequency;
+    int                 frame_size;
+    unsigned long       measurements;
+    Uint64              total;
+    Uint64              max;
+} AudioLatency;
+
+/*
+ * VoiceManager decides which mixer channel every sound effect is played on,
+ * so that a burst of unimportant sounds never keeps an important one from
+ * being heard.
+ */
+typedef struct VoiceManager {
+    Voice               voices[NUMBER_OF_VOICES];
+    // When every sound effect was last played, and whether it ever was
+    Uint32              last_played[NUMBER_OF_SOUND_EFFECTS];
+    bool                was_played[NUMBER_OF_SOUND_EFFECTS];
+    VoiceStats          stats;
+    AudioLatency        latency;
+    // When the key being handled was pressed, or 0 outside of its handling
+    Uint64              key_pressed_at;
+} VoiceManager;
+
 /*
  * Assets is a struct that holds the all the `assets` of the application. This 
  * includes images, or sounds which enhance the experience of the user. 
  */
 typedef struct Assets {
 
+    AssetPack asset_pack;
+    Atlas atlas;
+    TextureCache texture_cache;
+    AssetLoader loader;
+    RenderQueue *render_queue;
+
     struct {
         Sprite pacman;
         Sprite main;
@@ -152,26 +464,10 @@ typedef struct Assets {
         Mix_Chunk* game_over;
     } sounds;
 
+    VoiceManager voices;
 
-} Assets;
-
-/*
- * Board is a struct that holds variables
- * related to the game itself.
- */
-
-typedef struct Board { 
-    // Pointer to a 10 by 10, two-dimensional array that encodes
-    // the different positions of all elements in the board.
-    enum BoardElement array[10][10];
-    // The total number of foods generated in the board
-    int number_of_foods;
-    // Total total number of blocks generated in the board
-    int number_of_blocks;
-    // Current score of the player 
-    int total_player_score;
-} Board;
 
+} Assets;
 
 /* 
  * PlayerState specifies the following current states of the user:
@@ -195,42 +491,6 @@ enum PlayerState {
     PLAYER_IN_ABOUT,
 };
 
-/* 
- * GameState specifies the following, given that the player state is in-game:
- *
- *   GAME_IN_FOOD_NUMBER_INPUT
- *       - where the player is prompted to choose the number of food
- *         to be displayed in the game board (from 2 to 9)
- *
- *   GAME_IN_PROGRESS
- *       - where the player plays the game
- *
- *   GameState also covers the results of the game:
- *
- *       GAME_LOST_HIT_BLOCK
- *       GAME_LOST_HIT_BORDER
- *       GAME_LOST_INSUFFICIENT_FOOD
- *       GAME_WON
- *
- *       Results can be one of the following:
- *            Game Won
- *                - (1) when Pacman reaches the door after eating all food pieces,
- *                      without hitting a block or moving out of the border
- *            Game Lost
- *                - (2) when Pacman hits a block
- *                - (3) when Pacman moves out of the border
- *                - (4) when Pacman reaches the door,
- *                   without eating all the food pieces
- */
-enum GameState { 
-    GAME_WON,
-    GAME_LOST_HIT_BLOCK,
-    GAME_LOST_HIT_BORDER,
-    GAME_LOST_INSUFFICIENT_FOOD,
-    GAME_IN_PROGRESS,
-    GAME_IN_FOOD_NUMBER_INPUT,
-};
-
 /* 
  * WrongInputState is associated with the events where the input of the user is
  * not included to the certain keypresses accepted on some instances, such as:
@@ -298,6 +558,207 @@ enum MenuChoiceState {
     PLAYER_CHOSE_NONE,
 };
 
+/*
+ * InputScreen is what the keys are handled by, which follows from the
+ * PlayerState, the GameState and whether the quit confirmation is shown.
+ */
+enum InputScreen {
+    INPUT_SCREEN_QUIT_CONFIRMATION,
+    INPUT_SCREEN_MENU,
+    INPUT_SCREEN_TUTORIAL,
+    INPUT_SCREEN_ABOUT,
+    INPUT_SCREEN_FOOD_INPUT,
+    INPUT_SCREEN_GAME,
+    INPUT_SCREEN_GAME_OVER,
+    NUMBER_OF_INPUT_SCREENS,
+};
+
+/*
+ * InputActionType is what a key does on a screen. A key that is not bound on
+ * a screen does INPUT_ACTION_WRONG_INPUT, which shows the reminder of the
+ * screen.
+ */
+enum InputActionType {
+    INPUT_ACTION_WRONG_INPUT,
+    INPUT_ACTION_QUIT,
+    INPUT_ACTION_CANCEL_QUIT,
+    INPUT_ACTION_ASK_TO_QUIT,
+    INPUT_ACTION_CHOOSE_MENU_OPTION,
+    INPUT_ACTION_CONFIRM_MENU_CHOICE,
+    INPUT_ACTION_NEXT_PAGE,
+    INPUT_ACTION_PREVIOUS_PAGE,
+    INPUT_ACTION_OPEN_MENU,
+    INPUT_ACTION_OPEN_GAME,
+    INPUT_ACTION_PICK_FOODS,
+    INPUT_ACTION_START_GAME,
+    INPUT_ACTION_LEAVE_FOOD_INPUT,
+    INPUT_ACTION_MOVE_PACMAN,
+    INPUT_ACTION_SHOW_HINT,
+    INPUT_ACTION_PLAY_AGAIN,
+    INPUT_ACTION_LEAVE_GAME,
+    NUMBER_OF_INPUT_ACTIONS,
+};
+
+/*
+ * InputAction is an entry of the table of what every key does on every
+ * screen. Its argument is the MenuChoiceState of
+ * INPUT_ACTION_CHOOSE_MENU_OPTION, the number of foods of
+ * INPUT_ACTION_PICK_FOODS, the PacmanMove of INPUT_ACTION_MOVE_PACMAN, and
+ * 0 otherwise.
+ */
+typedef struct InputAction {
+    Uint8                    type;
+    Uint8                    argument;
+} InputAction;
+
+// The keys are looked up in the table of input actions by their index: the
+// keys that are characters first, followed by the others by their scancode
+#define NUMBER_OF_CHARACTER_KEYS 128
+#define NUMBER_OF_INPUT_KEYS (NUMBER_OF_CHARACTER_KEYS + SDL_NUM_SCANCODES)
+#define INPUT_KEY_INDEX(key) (((key) & SDLK_SCANCODE_MASK) ? \
+                              NUMBER_OF_CHARACTER_KEYS + ((key) & ~SDLK_SCANCODE_MASK) : (key))
+
+/*
+ * FramePacer decides how long each frame of the main loop lasts. It either
+ * relies on vsync to wait for the display, or sleeps until the next frame
+ * is due. All times are in ticks of SDL's performance counter.
+ */
+typedef struct FramePacer {
+    // The requested frames per second, FRAME_RATE_UNCAPPED or
+    // FRAME_RATE_MATCH_DISPLAY
+    int                      target_fps;
+    // The refresh rate of the display the window is on
+    int                      refresh_rate;
+    // Whether the renderer was asked for vsync, and whether presenting a
+    // frame was measured to actually wait for the display
+    bool                     vsync_requested;
+    bool                     vsync_active;
+    // Whether the pacer sleeps until `next_frame`, instead of relying on vsync
+    bool                     sleeps;
+    Uint64                   ticks_per_second;
+    Uint64                   ticks_per_frame;
+    Uint64                   next_frame;
+    // The time of the previous frame, and the measured length of the first
+    // frames after the assets were loaded, used to detect vsync. Until they
+    // are loaded, `calibration_frames` is negative.
+    Uint64                   previous_frame;
+    Uint64                   calibration_ticks[FRAME_PACER_CALIBRATION_FRAMES];
+    int                      calibration_frames;
+} FramePacer;
+
+/*
+ * FrameSample is what a single frame of the main loop took. All times are in
+ * ticks of SDL's performance counter.
+ */
+typedef struct FrameSample {
+    // From the previous frame being presented to this one being presented
+    Uint64                   frame;
+    // Handling the keys pressed since the previous frame
+    Uint64                   input;
+    // Queueing and drawing the frame, i.e. `render_state`
+    Uint64                   render;
+    // Presenting the frame, which includes waiting for vsync
+    Uint64                   present;
+    int                      draw_calls;
+    // The memory used by the loaded atlas pages
+    size_t                   texture_bytes;
+} FrameSample;
+
+/*
+ * PerfHud is the performance overlay, which shows how long the last frames
+ * took. It keeps the frames in a ring buffer, even while it is hidden.
+ */
+typedef struct PerfHud {
+    bool                     is_visible;
+    FrameSample              samples[PERF_HUD_FRAMES];
+    // The number of frames recorded so far, including the overwritten ones
+    unsigned long            number_of_samples;
+    // The time handling keys took since the previous frame
+    Uint64                   input;
+    // When the previous frame was presented, or 0 after a pause
+    Uint64                   previous_present;
+    // The longest a frame may take at the refresh rate of the display
+    Uint64                   frame_budget;
+    Uint64                   ticks_per_second;
+} PerfHud;
+
+/*
+ * FrameBenchmark keeps every frame drawn while a recording is played back
+ * with `--benchmark`, to report how fast the whole game runs.
+ */
+typedef struct FrameBenchmark {
+    bool                     is_running;
+    const char              *filename;
+    FrameSample             *samples;
+    int                      number_of_samples;
+    int                      capacity;
+    // When the game started, so that loading the assets is included
+    Uint64                   start;
+} FrameBenchmark;
+
+/*
+ * InputLatency measures how long every key takes to show up on the screen,
+ * from when it was pressed until the first frame drawn after handling it was
+ * presented. All times are in milliseconds since SDL started, like the
+ * timestamps of the events.
+ */
+typedef struct InputLatency {
+    // When the keys handled since the last frame was presented were pressed
+    Uint32                   pending[MAX_PENDING_INPUTS];
+    int                      number_of_pending;
+    // The latency of the last keys
+    Uint32                   samples[INPUT_LATENCY_SAMPLES];
+    // The number of keys measured so far, including the overwritten ones
+    unsigned long            number_of_samples;
+} InputLatency;
+
+/*
+ * TraceZone is a zone of the trace that was entered, but not left yet. Its
+ * start is 0 if the game is not traced.
+ */
+typedef struct TraceZone {
+    const char              *name;
+    Uint64                   start;
+} TraceZone;
+
+/*
+ * TraceEvent is a zone of the trace that was left. All times are in ticks of
+ * SDL's performance counter.
+ */
+typedef struct TraceEvent {
+    const char              *name;
+    unsigned long            thread;
+    Uint64                   start;
+    Uint64                   duration;
+    // The number of zones recorded before this one, plus one, once every
+    // field above is written
+    SDL_atomic_t             sequence;
+} TraceEvent;
+
+/*
+ * Tracer holds the zones of the trace in a ring buffer, until they are
+ * written to a file.
+ */
+typedef struct Tracer {
+    TraceEvent              *events;
+    // The number of zones recorded so far, including the overwritten ones
+    SDL_atomic_t             number_of_events;
+    // When tracing started, which every zone is timed from
+    Uint64                   start;
+    const char              *filename;
+} Tracer;
+
+/*
+ * BoardWorker holds the queue of pregenerated boards together with the
+ * background thread that keeps it filled.
+ */
+typedef struct BoardWorker {
+    BoardQueue      queue;
+    SDL_Thread      *thread;
+    SDL_sem         *wakeup;
+    SDL_atomic_t    running;
+} BoardWorker;
+
 typedef struct States {
     enum PlayerState         player_state;
     enum GameState           game_state;
@@ -308,19 +769,123 @@ typedef struct States {
     bool                     show_quit_confirmation;
     bool                     player_wants_to_quit;
     Uint32                   wrong_input_time; // Uint32 is a type defined by SDL
+    // Generates boards in the background, or NULL to generate them on demand
+    BoardWorker             *board_worker;
+    // Draws the seeds of boards that are generated when none is pregenerated
+    RandomGenerator          seed_generator;
+    // The seed given with `--seed`, which is used for the first game
+    uint64_t                 requested_seed;
+    bool                     has_requested_seed;
+    // The cached route of the current board, which hints are taken from
+    RouteTable               route_table;
+    // Whether the next step of the route is highlighted on the board
+    bool                     show_hint;
+    // Whether to skip printing the details of every board, e.g. when
+    // benchmarking
+    bool                     quiet;
+    // The number of boards generated so far, which tells a recording that
+    // a key started a new game
+    unsigned long            number_of_boards;
+    // The attempts it took to generate those boards, including the ones
+    // that could not be won, which is reported at exit
+    unsigned long            board_generation_attempts;
 } States;
 
-
 /*
- * PacmanMove is an enum that handles the movement of pacman on the screen.
+ * ReplayMode specifies whether the session is recorded, played back from a
+ * recording, or neither.
  */
+enum ReplayMode {
+    REPLAY_OFF,
+    REPLAY_RECORDING,
+    REPLAY_PLAYING,
+};
 
-enum PacmanMove {
-   MOVE_PACMAN_UP,
-   MOVE_PACMAN_DOWN,
-   MOVE_PACMAN_LEFT,
-   MOVE_PACMAN_RIGHT,
+/*
+ * ReplayRecordType specifies what a record of a recording holds:
+ *
+ *   REPLAY_RECORD_KEY
+ *       - a key that was handled, with its keycode as the value
+ *
+ *   REPLAY_RECORD_BOARD
+ *       - the seed of the board the next key starts a game on
+ *
+ *   REPLAY_RECORD_QUIT
+ *       - the window was closed, which asks the player to confirm quitting
+ *
+ *   REPLAY_RECORD_END
+ *       - the end of the session, with a hash of the final state as the
+ *         value, which a replay must arrive at
+ */
+enum ReplayRecordType {
+    REPLAY_RECORD_KEY,
+    REPLAY_RECORD_BOARD,
+    REPLAY_RECORD_QUIT,
+    REPLAY_RECORD_END,
 };
 
+/*
+ * ReplayRecord is a single record of a recording. Its time is in
+ * milliseconds since the menu was first shown.
+ */
+typedef struct ReplayRecord {
+    enum ReplayRecordType    type;
+    Uint32                   time;
+    uint64_t                 value;
+} ReplayRecord;
+
+/*
+ * Replay holds the recording a session is written to, or played back from.
+ */
+typedef struct Replay {
+    enum ReplayMode          mode;
+    // Whether the recording is played back as fast as possible, one key
+    // per frame, instead of at the pace it was recorded at
+    bool                     is_fast;
+    FILE                    *file;
+    const char              *filename;
+    // When the menu was first shown, from `SDL_GetTicks`, which the times
+    // of the records are relative to
+    bool                     has_started;
+    Uint32                   start;
+    // The time of the last record written or read, since every record
+    // only holds the time since the one before it
+    Uint32                   previous_time;
+    // The record that is played next, which is read ahead to know when it
+    // is due
+    ReplayRecord             next;
+    bool                     has_next;
+    // The number of boards the recording knows of, see `States`
+    unsigned long            number_of_boards;
+    unsigned long            number_of_records;
+} Replay;
+
+/*
+ * Options are the options the game is started with, read from the command
+ * line by `parse_arguments`. See `print_usage` for what each of them does.
+ */
+typedef struct Options {
+    bool                     show_usage;
+    // FRAME_RATE_MATCH_DISPLAY unless `--fps` is given
+    int                      target_fps;
+    bool                     has_target_fps;
+    // The recordings of `--record`, `--replay` and `--benchmark`, or NULL.
+    // The recording of a benchmark is also the one that is played back.
+    const char              *record_filename;
+    const char              *replay_filename;
+    bool                     is_replay_fast;
+    const char              *benchmark_filename;
+    long                     texture_budget_mb;
+    // The samples the audio device mixes at a time
+    int                      audio_chunk_size;
+    bool                     is_low_latency_audio;
+    // The file of `--trace`, or NULL
+    const char              *trace_filename;
+    bool                     show_perf_hud;
+    // The board `--seed` asks for
+    uint64_t                 seed;
+    bool                     has_seed;
+} Options;
+
 
 #endif
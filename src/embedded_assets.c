@@ -0,0 +1,74 @@
+/*
+ *  This file, `embedded_assets.c`, embeds the asset pack into the executable
+ *  when the game is built with GHOSTLESS_PACMAN_EMBED_ASSETS, so that the
+ *  game runs from any folder without opening a single file.
+ *
+ *  NOTE:
+ *      The pack is included with the `.incbin` directive of the assembler,
+ *      which copies the file into the executable as it is. Turning the pack
+ *      into a C array instead would take minutes to compile. The build sets
+ *      EMBEDDED_ASSET_PACK to the path of the pack.
+ */
+
+#include "stdbool.h"
+#include "stddef.h"
+
+#include "embedded_assets.h"
+
+#ifdef EMBEDDED_ASSET_PACK
+
+#define EMBEDDED_STRING(text) #text
+#define EMBEDDED_EXPANDED_STRING(text) EMBEDDED_STRING(text)
+
+// The prefix the compiler adds to the names of C symbols, e.g. "_" on macOS
+#define EMBEDDED_SYMBOL(name) EMBEDDED_EXPANDED_STRING(__USER_LABEL_PREFIX__) #name
+
+// The read-only data section of the executable
+#if defined(__APPLE__)
+#define EMBEDDED_SECTION ".const_data\n"
+#elif defined(_WIN32)
+#define EMBEDDED_SECTION ".section .rdata,\"dr\"\n"
+#else
+#define EMBEDDED_SECTION ".section .rodata\n"
+#endif
+
+// The pack is aligned like the data of its assets
+__asm__(
+    EMBEDDED_SECTION
+    ".balign 64\n"
+    ".globl " EMBEDDED_SYMBOL(embedded_asset_pack_start) "\n"
+    EMBEDDED_SYMBOL(embedded_asset_pack_start) ":\n"
+    ".incbin \"" EMBEDDED_ASSET_PACK "\"\n"
+    ".globl " EMBEDDED_SYMBOL(embedded_asset_pack_end) "\n"
+    EMBEDDED_SYMBOL(embedded_asset_pack_end) ":\n"
+    ".text\n"
+);
+
+extern const unsigned char embedded_asset_pack_start[];
+extern const unsigned char embedded_asset_pack_end[];
+
+#endif
+
+bool get_embedded_asset_pack(const unsigned char **data, size_t *size) {
+    /*
+     * A function that finds the asset pack embedded into the executable.
+     *
+     * params
+     *      const unsigned char **data
+     *          Receives the start of the pack
+     *      size_t *size
+     *          Receives the size of the pack, in bytes
+     * returns
+     *      false if no pack was embedded
+     */
+
+#ifdef EMBEDDED_ASSET_PACK
+    *data = embedded_asset_pack_start;
+    *size = (size_t) (embedded_asset_pack_end - embedded_asset_pack_start);
+    return *size > 0;
+#else
+    *data = NULL;
+    *size = 0;
+    return false;
+#endif
+}
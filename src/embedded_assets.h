@@ -0,0 +1,9 @@
+#ifndef EMBEDDED_ASSETS_H
+#define EMBEDDED_ASSETS_H
+
+#include "stdbool.h"
+#include "stddef.h"
+
+bool get_embedded_asset_pack(const unsigned char **data, size_t *size);
+
+#endif // !EMBEDDED_ASSETS_H
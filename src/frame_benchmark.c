@@ -0,0 +1,187 @@
+/*
+ *  This file, `frame_benchmark.c`, contains the benchmark of the whole game,
+ *  which plays back a recording as fast as possible, without a display, and
+ *  reports the frame rate, the times of the frames and the peak memory use.
+ *
+ *  usage
+ *      ./ghostless-pacman --benchmark session.rec
+ *
+ *  NOTE:
+ *      Unlike the benchmarks in the bench/ folder, which time single
+ *      operations, every frame goes through the same main loop as when the
+ *      game is played, from loading the assets to handling the keys,
+ *      rendering and presenting. The frames are timed from when the game
+ *      started, so loading the assets counts towards the result.
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stddef.h"
+#include "stdbool.h"
+
+#ifdef _WIN32
+// Links GetProcessMemoryInfo from kernel32, rather than from psapi
+#define PSAPI_VERSION 2
+#include "windows.h"
+#include "psapi.h"
+#else
+#include "sys/resource.h"
+#endif
+
+#include "declarations.h"
+#include "frame_benchmark.h"
+
+#include "SDL2/SDL.h"
+
+void init_frame_benchmark(FrameBenchmark *benchmark) {
+    /*
+     * A function that sets up a benchmark that is not running.
+     */
+
+    benchmark->is_running = false;
+    benchmark->filename = NULL;
+    benchmark->samples = NULL;
+    benchmark->number_of_samples = 0;
+    benchmark->capacity = 0;
+    benchmark->start = 0;
+}
+
+bool start_frame_benchmark(FrameBenchmark *benchmark, const char *filename, Uint64 start) {
+    /*
+     * A function that starts keeping the frames of the benchmark.
+     *
+     * params
+     *      FrameBenchmark *benchmark
+     *          A pointer to the struct FrameBenchmark
+     *      const char *filename
+     *          The recording that is played back, which is reported
+     *      Uint64 start
+     *          When the game started, from `SDL_GetPerformanceCounter`
+     * returns
+     *      false if there is no memory for the frames
+     */
+
+    benchmark->samples = malloc(FRAME_BENCHMARK_INITIAL_CAPACITY * sizeof(FrameSample));
+    if (!benchmark->samples) {
+        printf("Error starting the benchmark: out of memory\n");
+        return false;
+    }
+
+    benchmark->is_running = true;
+    benchmark->filename = filename;
+    benchmark->capacity = FRAME_BENCHMARK_INITIAL_CAPACITY;
+    benchmark->number_of_samples = 0;
+    benchmark->start = start;
+    return true;
+}
+
+void add_benchmark_frame(FrameBenchmark *benchmark, FrameSample sample) {
+    /*
+     * A function that keeps a frame that was presented, if the benchmark is
+     * running.
+     */
+
+    if (!benchmark->is_running)
+        return;
+
+    if (benchmark->number_of_samples == benchmark->capacity) {
+        FrameSample *samples = realloc(benchmark->samples, 2 * (size_t) benchmark->capacity * sizeof(FrameSample));
+        if (!samples) {
+            // The frames kept so far are still reported
+            printf("Error keeping the frames of the benchmark: out of memory\n");
+            return;
+        }
+        benchmark->samples = samples;
+        benchmark->capacity *= 2;
+    }
+    benchmark->samples[benchmark->number_of_samples++] = sample;
+}
+
+static double get_peak_memory_mb(void) {
+    /*
+     * A helper function that returns the most memory the game has held in
+     * RAM at once, i.e. its peak resident set size, or -1 if it is unknown.
+     */
+
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1.0;
+    return (double) counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1.0;
+#ifdef __APPLE__
+    // macOS reports it in bytes, and Linux in kilobytes
+    return (double) usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return (double) usage.ru_maxrss / 1024.0;
+#endif
+#endif
+}
+
+static int compare_ticks(const void *a, const void *b) {
+    Uint64 first = *(const Uint64 *) a;
+    Uint64 second = *(const Uint64 *) b;
+    return (first > second) - (first < second);
+}
+
+static void print_percentiles(const FrameBenchmark *benchmark, Uint64 *ticks, const char *label, size_t offset) {
+    /*
+     * A helper function that prints the p50, p90, p99 and max of one of the
+     * times of the frames.
+     *
+     * params
+     *      Uint64 *ticks
+     *          Room for the time of every frame, which is sorted in place
+     *      size_t offset
+     *          Where the time is in the struct FrameSample, e.g.
+     *          `offsetof(FrameSample, render)`
+     */
+
+    int number_of_samples = benchmark->number_of_samples;
+    for (int i=0; i<number_of_samples; i++) {
+        ticks[i] = *(const Uint64 *) ((const char *) &benchmark->samples[i] + offset);
+    }
+    qsort(ticks, number_of_samples, sizeof(Uint64), compare_ticks);
+
+    double ticks_per_ms = (double) SDL_GetPerformanceFrequency() / 1000.0;
+    printf("  %-8s %8.3f ms p50, %8.3f ms p90, %8.3f ms p99, %8.3f ms max\n", label,
+           (double) ticks[number_of_samples / 2] / ticks_per_ms,
+           (double) ticks[(number_of_samples * 90) / 100] / ticks_per_ms,
+           (double) ticks[(number_of_samples * 99) / 100] / ticks_per_ms,
+           (double) ticks[number_of_samples - 1] / ticks_per_ms);
+}
+
+void stop_frame_benchmark(FrameBenchmark *benchmark) {
+    /*
+     * A function that reports the frames of the benchmark, and releases
+     * them.
+     */
+
+    if (!benchmark->is_running)
+        return;
+
+    double elapsed = (double) (SDL_GetPerformanceCounter() - benchmark->start) / (double) SDL_GetPerformanceFrequency();
+    int number_of_samples = benchmark->number_of_samples;
+
+    printf("Benchmark of %s: %d frames in %.3f s, %.1f fps\n", benchmark->filename, number_of_samples,
+           elapsed, elapsed > 0.0 ? (double) number_of_samples / elapsed : 0.0);
+
+    Uint64 *ticks = number_of_samples > 0 ? malloc((size_t) number_of_samples * sizeof(Uint64)) : NULL;
+    if (ticks) {
+        print_percentiles(benchmark, ticks, "FRAME", offsetof(FrameSample, frame));
+        print_percentiles(benchmark, ticks, "INPUT", offsetof(FrameSample, input));
+        print_percentiles(benchmark, ticks, "RENDER", offsetof(FrameSample, render));
+        print_percentiles(benchmark, ticks, "PRESENT", offsetof(FrameSample, present));
+        free(ticks);
+    }
+
+    double peak_memory = get_peak_memory_mb();
+    if (peak_memory >= 0.0)
+        printf("  Peak RSS %.1f MB\n", peak_memory);
+
+    free(benchmark->samples);
+    init_frame_benchmark(benchmark);
+}
@@ -0,0 +1,14 @@
+#ifndef FRAME_BENCHMARK_H
+#define FRAME_BENCHMARK_H
+
+#include "declarations.h"
+
+void init_frame_benchmark(FrameBenchmark *benchmark);
+
+bool start_frame_benchmark(FrameBenchmark *benchmark, const char *filename, Uint64 start);
+
+void add_benchmark_frame(FrameBenchmark *benchmark, FrameSample sample);
+
+void stop_frame_benchmark(FrameBenchmark *benchmark);
+
+#endif // !FRAME_BENCHMARK_H
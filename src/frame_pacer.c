@@ -0,0 +1,192 @@
+/*
+ *  This file, `frame_pacer.c`, contains the FramePacer, which keeps the main
+ *  loop at a steady frame rate.
+ *
+ *  NOTE:
+ *   Sleeping for a fixed time on top of vsync makes the two waits add up, so
+ *   a frame that is only slightly late misses the next refresh and waits for
+ *   the one after it. Instead, the pacer only sleeps when vsync is not doing
+ *   the waiting already, and then only for the remainder of the frame.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+#include "frame_pacer.h"
+#include "declarations.h"
+
+#include "SDL2/SDL.h"
+
+// SDL_Delay can oversleep by about a millisecond, so the last part of the
+// wait is spent checking the clock instead
+#define FRAME_PACER_SPIN_MILLISECONDS 1
+
+// The value of `calibration_frames` until `start_frame_pacer_calibration`
+#define FRAME_PACER_CALIBRATION_NOT_STARTED -1
+
+static void update_pacing(FramePacer *pacer) {
+    /*
+     * A helper function that decides whether the pacer has to sleep, from
+     * the target frame rate and whether vsync is active.
+     */
+
+    int fps = pacer->target_fps == FRAME_RATE_MATCH_DISPLAY ? pacer->refresh_rate : pacer->target_fps;
+    pacer->ticks_per_frame = fps > 0 ? pacer->ticks_per_second / fps : 0;
+
+    if (pacer->ticks_per_frame == 0)
+        pacer->sleeps = false;
+    else if (pacer->vsync_active && fps >= pacer->refresh_rate)
+        pacer->sleeps = false;
+    else
+        pacer->sleeps = true;
+}
+
+void init_frame_pacer(FramePacer *pacer, SDL_Window *window, SDL_Renderer *renderer, int target_fps) {
+    /*
+     * A function that sets up the pacing of the main loop.
+     *
+     * params
+     *      FramePacer *pacer
+     *          A pointer to the struct FramePacer to be initialized
+     *      SDL_Window *window
+     *          The window, used to find the refresh rate of its display
+     *      SDL_Renderer *renderer
+     *          The renderer, used to find out whether vsync was requested
+     *      int target_fps
+     *          The frames per second to aim for, FRAME_RATE_UNCAPPED or
+     *          FRAME_RATE_MATCH_DISPLAY
+     */
+
+    pacer->target_fps = target_fps;
+    pacer->ticks_per_second = SDL_GetPerformanceFrequency();
+
+    SDL_DisplayMode mode;
+    int display = SDL_GetWindowDisplayIndex(window);
+    if (display >= 0 && SDL_GetCurrentDisplayMode(display, &mode) == 0 && mode.refresh_rate > 0)
+        pacer->refresh_rate = mode.refresh_rate;
+    else
+        pacer->refresh_rate = DEFAULT_REFRESH_RATE;
+
+    SDL_RendererInfo info;
+    pacer->vsync_requested = SDL_GetRendererInfo(renderer, &info) == 0 &&
+                             (info.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    // NOTE:
+    //  A renderer may accept vsync and still not wait for the display, e.g.
+    //  when the driver turns it off. Until the frames were measured, vsync
+    //  is assumed to work, so that the pacer does not sleep while the
+    //  frames are measured. They are only measured once the assets are
+    //  loaded, see `start_frame_pacer_calibration`.
+    pacer->vsync_active = pacer->vsync_requested;
+    pacer->calibration_frames = pacer->vsync_requested ? FRAME_PACER_CALIBRATION_NOT_STARTED :
+                                                         FRAME_PACER_CALIBRATION_FRAMES;
+
+    pacer->previous_frame = SDL_GetPerformanceCounter();
+    update_pacing(pacer);
+    pacer->next_frame = pacer->previous_frame + pacer->ticks_per_frame;
+
+    if (!pacer->vsync_requested)
+        printf("Frame pacing: %d Hz display, vsync off, %s\n", pacer->refresh_rate,
+               pacer->sleeps ? "sleeping between frames" : "uncapped");
+}
+
+static int compare_ticks(const void *a, const void *b) {
+    Uint64 x = *(const Uint64*) a;
+    Uint64 y = *(const Uint64*) b;
+    return (x > y) - (x < y);
+}
+
+static void calibrate(FramePacer *pacer, Uint64 now) {
+    /*
+     * A helper function that measures the length of the first frames after
+     * the assets were loaded, and then decides whether presenting a frame
+     * waits for the display.
+     */
+
+    pacer->calibration_ticks[pacer->calibration_frames++] = now - pacer->previous_frame;
+    if (pacer->calibration_frames < FRAME_PACER_CALIBRATION_FRAMES)
+        return;
+
+    qsort(pacer->calibration_ticks, FRAME_PACER_CALIBRATION_FRAMES, sizeof(Uint64), compare_ticks);
+    Uint64 median = pacer->calibration_ticks[FRAME_PACER_CALIBRATION_FRAMES / 2];
+    Uint64 refresh_period = pacer->ticks_per_second / pacer->refresh_rate;
+
+    // With vsync, a frame lasts about one refresh period even when it takes
+    // much less to render
+    pacer->vsync_active = median * 4 >= refresh_period * 3;
+    update_pacing(pacer);
+    pacer->next_frame = now + pacer->ticks_per_frame;
+
+    printf("Frame pacing: %d Hz display, vsync %s, %s\n", pacer->refresh_rate,
+           pacer->vsync_active ? "active" : "requested but not active",
+           pacer->sleeps ? "sleeping between frames" : (pacer->ticks_per_frame ? "relying on vsync" : "uncapped"));
+}
+
+void wait_for_next_frame(FramePacer *pacer) {
+    /*
+     * A function that waits until the next frame is due. It must be called
+     * once per frame, after the frame was presented and before the keys of
+     * the next one are read.
+     *
+     * NOTE:
+     *  Frames are due at fixed intervals from each other rather than from
+     *  the end of the previous wait, so that small delays do not add up. If
+     *  the loop falls more than a frame behind, it starts over from now
+     *  instead of rushing to catch up.
+     */
+
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    if (pacer->calibration_frames < FRAME_PACER_CALIBRATION_FRAMES) {
+        if (pacer->calibration_frames != FRAME_PACER_CALIBRATION_NOT_STARTED)
+            calibrate(pacer, now);
+        pacer->previous_frame = now;
+        return;
+    }
+
+    if (pacer->sleeps) {
+        if (now < pacer->next_frame) {
+            Uint64 remaining_ms = (pacer->next_frame - now) * 1000 / pacer->ticks_per_second;
+            if (remaining_ms > FRAME_PACER_SPIN_MILLISECONDS)
+                SDL_Delay((Uint32) (remaining_ms - FRAME_PACER_SPIN_MILLISECONDS));
+
+            do {
+                now = SDL_GetPerformanceCounter();
+            } while (now < pacer->next_frame);
+        }
+
+        if (now - pacer->next_frame > pacer->ticks_per_frame)
+            pacer->next_frame = now;
+        pacer->next_frame += pacer->ticks_per_frame;
+    }
+
+    pacer->previous_frame = now;
+}
+
+void start_frame_pacer_calibration(FramePacer *pacer) {
+    /*
+     * A function that starts measuring the frames to detect vsync. Only the
+     * first call counts.
+     *
+     * NOTE:
+     *  It is called once the assets are loaded, since the frames drawn while
+     *  they load also upload the atlas pages, and a few slow ones would make
+     *  the pacer mistake vsync for a slow display, or the other way round.
+     */
+
+    if (pacer->calibration_frames == FRAME_PACER_CALIBRATION_NOT_STARTED)
+        pacer->calibration_frames = 0;
+}
+
+void resume_frame_pacer(FramePacer *pacer) {
+    /*
+     * A function that starts pacing again after the main loop stopped
+     * drawing frames for a while, so that the pause is neither mistaken for
+     * vsync nor made up for with rushed frames.
+     */
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    pacer->previous_frame = now;
+    pacer->next_frame = now;
+}
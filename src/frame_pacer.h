@@ -0,0 +1,11 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "declarations.h"
+
+void init_frame_pacer(FramePacer *pacer, SDL_Window *window, SDL_Renderer *renderer, int target_fps);
+void wait_for_next_frame(FramePacer *pacer);
+void start_frame_pacer_calibration(FramePacer *pacer);
+void resume_frame_pacer(FramePacer *pacer);
+
+#endif // !FRAME_PACER_H
@@ -0,0 +1,93 @@
+/*
+ *  This file, `input_latency.c`, measures the input-to-present latency, i.e.
+ *  how long it takes from a key being pressed until the frame that shows
+ *  its result is presented.
+ *
+ *  NOTE:
+ *      The time a key was pressed is taken from the timestamp of its event,
+ *      so the time the event waited in SDL's queue is included. The time
+ *      the display takes to show the presented frame is not.
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+
+#include "declarations.h"
+#include "input_latency.h"
+
+#include "SDL2/SDL.h"
+
+void init_input_latency(InputLatency *latency) {
+    latency->number_of_pending = 0;
+    latency->number_of_samples = 0;
+}
+
+void latch_input(InputLatency *latency, Uint32 timestamp) {
+    /*
+     * A function that carries the timestamp of a handled key until the next
+     * frame is presented.
+     *
+     * params
+     *      InputLatency *latency
+     *          A pointer to the struct InputLatency
+     *      Uint32 timestamp
+     *          The timestamp of the event of the key
+     *
+     * NOTE:
+     *  The keys handled once the list is full share the latency of the last
+     *  key in it, which is at most as long as theirs.
+     */
+
+    if (latency->number_of_pending < MAX_PENDING_INPUTS)
+        latency->number_of_pending++;
+    latency->pending[latency->number_of_pending - 1] = timestamp;
+}
+
+void record_input_present(InputLatency *latency, Uint32 presented_at) {
+    /*
+     * A function that measures the latency of every key handled before the
+     * frame that was just presented.
+     *
+     * params
+     *      InputLatency *latency
+     *          A pointer to the struct InputLatency
+     *      Uint32 presented_at
+     *          When the frame was presented, from `SDL_GetTicks`
+     */
+
+    for (int i=0; i<latency->number_of_pending; i++) {
+        latency->samples[latency->number_of_samples % INPUT_LATENCY_SAMPLES] = presented_at - latency->pending[i];
+        latency->number_of_samples++;
+    }
+    latency->number_of_pending = 0;
+}
+
+static int compare_latencies(const void *a, const void *b) {
+    Uint32 first = *(const Uint32 *) a;
+    Uint32 second = *(const Uint32 *) b;
+    return (first > second) - (first < second);
+}
+
+void print_input_latency(const InputLatency *latency) {
+    /*
+     * A function that reports the percentiles of the latency of the last
+     * keys.
+     */
+
+    int number_of_samples = latency->number_of_samples < INPUT_LATENCY_SAMPLES ?
+                            (int) latency->number_of_samples : INPUT_LATENCY_SAMPLES;
+    if (number_of_samples == 0)
+        return;
+
+    Uint32 sorted[INPUT_LATENCY_SAMPLES];
+    for (int i=0; i<number_of_samples; i++) {
+        sorted[i] = latency->samples[i];
+    }
+    qsort(sorted, number_of_samples, sizeof(Uint32), compare_latencies);
+
+    printf("Input to present: %u ms p50, %u ms p90, %u ms p99, %u ms max, over %d keys\n",
+           (unsigned int) sorted[number_of_samples / 2],
+           (unsigned int) sorted[(number_of_samples * 90) / 100],
+           (unsigned int) sorted[(number_of_samples * 99) / 100],
+           (unsigned int) sorted[number_of_samples - 1], number_of_samples);
+}
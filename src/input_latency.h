@@ -0,0 +1,14 @@
+#ifndef INPUT_LATENCY_H
+#define INPUT_LATENCY_H
+
+#include "declarations.h"
+
+void init_input_latency(InputLatency *latency);
+
+void latch_input(InputLatency *latency, Uint32 timestamp);
+
+void record_input_present(InputLatency *latency, Uint32 presented_at);
+
+void print_input_latency(const InputLatency *latency);
+
+#endif // !INPUT_LATENCY_H
@@ -1,16 +1,24 @@
 /*
  * This file, `logic.c`, contains functions that handle the different
- * processes in the game itself
+ * processes in the game itself. The rules are resolved by the headless
+ * game core in `core/board.c`, while the functions here render the board
+ * and play the sounds of each outcome.
  */
 
 #include "stdbool.h"
-#include "stdlib.h"
-#include "time.h"
 #include "stdio.h"
+#include "inttypes.h"
 
+#include "assets.h"
 #include "declarations.h"
 #include "utils.h"
+#include "voices.h"
 #include "logic.h"
+#include "board_worker.h"
+#include "render_queue.h"
+#include "text.h"
+#include "trace.h"
+#include "core/random.h"
 
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_mixer.h"
@@ -59,8 +67,8 @@ void render_board(Board *board, Assets* assets) {
     render_sprite(pacman);
 
 
-    for (int row=0; row<10; row++) {
-        for (int col=0; col<10; col++) {
+    for (int row=0; row<BOARD_SIZE; row++) {
+        for (int col=0; col<BOARD_SIZE; col++) {
             enum BoardElement element = board->array[row][col];
                 switch (element) {
                     case EMPTY:
@@ -90,124 +98,171 @@ void render_board(Board *board, Assets* assets) {
     }
 }
 
-BoardPosition calculate_pacman_position(Sprite* pacman) {
-
-    /* 
-     * A helper function that calculates and returns the position of Pacman.
-     * 
+void render_par(Board *board, Assets *assets) {
+    /*
+     * A function that renders the par of the board below the result prompts,
+     * next to the number of moves the player made.
+     *
      * params
-     *      Sprite *pacman
-     *          a pointer to a sprite containing pacman
-     * returns
-     *      BoardPosition
-     *          the current position of pacman
+     *      Board *board
+     *            A pointer to the struct Board that holds the par and the
+     *            number of moves
+     *      Assets* assets
+     *            A pointer to the struct Assets that holds
+     *            the required assets of the application
      */
 
-    BoardPosition position;
-    position.col = (pacman->rect.x - ELEMENT_INITIAL_POSITION_X) / BOX_WIDTH;
-    position.row = (pacman->rect.y - ELEMENT_INITIAL_POSITION_Y) / BOX_WIDTH;
-    return position;
-};
+    SDL_Color color = {.r=234, .g=205, .b=134, .a=255};
+    int scale = 3;
 
+    char text[32];
+    snprintf(text, sizeof(text), "PAR %d   MOVES %d", board->par, board->number_of_moves);
 
-enum GameState check_player_status(BoardPosition next_position, enum BoardElement future_obstacle, Board *board, Assets* assets) {
+    int x = (WINDOW_WIDTH - measure_text_width(text, scale)) / 2;
+    int y = 590;
+    render_text(assets->render_queue, RENDER_LAYER_OVERLAY, text, x, y, scale, color);
+}
 
-    /* 
-     * A function that checks the state of the game based on the
-     * current player status, specifically involving the blocks and
-     * food
+void render_loading_indicator(Assets *assets) {
+    /*
+     * A function that renders how much of the assets was loaded, in the
+     * bottom right corner of the window.
      *
      * params
-     *      BoardPosition next_position
-     *          A struct holding the next position of Pacman
-     *      enum BoardElement future_obstace
-     *          An enum that represents the future obstacle that pacman will
-     *          encounter on its `next_position`
-     *      Board *board
-     *          A pointer to the struct board which stores all the variables
-     *          related to the game itself.
      *      Assets* assets
-     *            A pointer to the struct Assets that points
-     *            to the required assets
+     *            A pointer to the struct Assets that is being loaded
+     */
+
+    SDL_Color color = {.r=234, .g=205, .b=134, .a=255};
+    int scale = 2;
+
+    char text[32];
+    snprintf(text, sizeof(text), "LOADING %d%%", get_loading_percentage(assets));
+
+    int margin = 10;
+    int x = WINDOW_WIDTH - measure_text_width(text, scale) - margin;
+    int y = WINDOW_HEIGHT - (TEXT_GLYPH_HEIGHT * scale) - margin;
+    render_text(assets->render_queue, RENDER_LAYER_OVERLAY, text, x, y, scale, color);
+}
+
+bool show_hint(Board *board, States *states) {
+    /*
+     * A function that turns on the highlight of the next step of an optimal
+     * route, which stays on until Pacman moves.
      *
+     * params
+     *      Board *board
+     *            A pointer to the struct Board of the current game
+     *      States *states
+     *            A pointer to the struct States that holds the route
      * returns
-     *      enum GameState
-     *          the `state` of the game when Pacman moves into the `next_position`. 
-     *
-     * example
-     *      If Pacman moves into a block on its `next_position`, this function
-     *      will return a `GAME_LOST_HIT_BLOCK` enum.
+     *      false if no hint is available
      */
 
-    int row = next_position.row;
-    int col = next_position.col;
+    enum PacmanMove move;
+    if (!board->route_table || !route_table_next_step(board->route_table, board->pacman_position, &move))
+        return false;
+
+    states->show_hint = true;
+    return true;
+}
+
+void render_hint(Board *board, Assets *assets, States *states) {
+    /*
+     * A function that highlights the box Pacman should move into next, when
+     * the player asked for a hint.
+     *
+     * params
+     *      Board *board
+     *            A pointer to the struct Board of the current game
+     *      Assets* assets
+     *            A pointer to the struct Assets that holds
+     *            the required assets of the application
+     *      States *states
+     *            A pointer to the struct States that holds the route
+     */
 
-    bool player_within_horizontal_borders = col >= 0 && col <=9;
-    bool player_within_vertical_borders = row >= 0 && row <= 9;
-    bool player_within_borders = player_within_horizontal_borders && player_within_vertical_borders;
+    enum PacmanMove move;
+    if (!states->show_hint || !board->route_table ||
+        !route_table_next_step(board->route_table, board->pacman_position, &move))
+        return;
 
-    switch (future_obstacle) {
-        case FOOD:
-            board->total_player_score++;
-            board->array[row][col] = EMPTY;
-            Mix_PlayChannel(2, assets->sounds.pacman_munch, 0);
+    BoardPosition step = board->pacman_position;
+    switch (move) {
+        case MOVE_PACMAN_UP:
+            step.row--;
+            break;
+        case MOVE_PACMAN_DOWN:
+            step.row++;
             break;
-        case BLOCK:
-            Mix_PlayChannel(2, assets->sounds.game_over, 0);
-            return GAME_LOST_HIT_BLOCK;
+        case MOVE_PACMAN_LEFT:
+            step.col--;
             break;
-        default: 
+        case MOVE_PACMAN_RIGHT:
+            step.col++;
             break;
     }
 
-    if (!player_within_borders) {
-        Mix_PlayChannel(2, assets->sounds.game_over, 0);
-        return GAME_LOST_HIT_BORDER;
-    } 
+    SDL_Color color = {.r=234, .g=205, .b=134, .a=255};
+
+    // Draw a 3 pixel thick outline inside the box, 2 pixels from its edges
+    int inset = 2;
+    int thickness = 3;
+    int left = BOX_INITIAL_POSITION_X + (BOX_WIDTH * step.col) + inset;
+    int top  = BOX_INITIAL_POSITION_Y + (BOX_WIDTH * step.row) + inset;
+    int size = BOX_WIDTH - (2 * inset);
 
-    return GAME_IN_PROGRESS;
-};
+    SDL_Rect edges[4] = {
+        {.x=left,                    .y=top,                    .w=size,      .h=thickness},
+        {.x=left,                    .y=top + size - thickness, .w=size,      .h=thickness},
+        {.x=left,                    .y=top + thickness,        .w=thickness, .h=size - (2 * thickness)},
+        {.x=left + size - thickness, .y=top + thickness,        .w=thickness, .h=size - (2 * thickness)},
+    };
+    for (int i=0; i<4; i++) {
+        queue_filled_rect(assets->render_queue, RENDER_LAYER_OVERLAY, edges[i], color);
+    }
+}
 
-enum GameState check_if_player_won(BoardPosition next_position, Board *board, Assets *assets) {
+static void play_move_sounds(MoveResult result, Assets *assets) {
 
-    /* 
-     * A function that checks if the player won the game.
+    /*
+     * A helper function that plays the sounds associated with the outcome
+     * of a single move of Pacman.
      *
      * params
-     *      BoardPosition next_position
-     *          A struct holding the next position of Pacman on the board.
-     *      Board *board
-     *          A pointer to the struct board which stores all the variables
-     *          related to the game itself.
+     *      MoveResult result
+     *          The outcome of the move, as returned by `resolve_move`
      *      Assets *assets
-     *          A pointer to the struct Assets that holds the required assets
-     *          in the application.
-     * returns
-     *      enum GameState
-     *          the `state` of the game when Pacman moves into the `next_position`. 
-     *
-     * example
-     *      If pacman moves into the exit on its `next_position`, and Pacman has 
-     *      eaten all the food pieces. This function will return a game_state enum
-     *      PLAYER_WON.
+     *          A pointer to the struct Assets that holds
+     *          the required assets of the application.
      */
 
+    if (result.events & BOARD_EVENT_FOOD_EATEN)
+        play_sound(assets, SOUND_PACMAN_MUNCH);
 
-    // Check if Pacman has eaten all the food pieces
-    if (board->total_player_score == board->number_of_foods) {
-        Mix_PlayChannel(-1, assets->sounds.game_win, 0);
-        return GAME_WON;
-    } else {
-        Mix_PlayChannel(-1, assets->sounds.game_over, 0);
-        return GAME_LOST_INSUFFICIENT_FOOD;
+    switch (result.game_state) {
+        case GAME_WON:
+            play_sound(assets, SOUND_GAME_WIN);
+            break;
+        case GAME_LOST_INSUFFICIENT_FOOD:
+        case GAME_LOST_HIT_BLOCK:
+        case GAME_LOST_HIT_BORDER:
+            play_sound(assets, SOUND_GAME_OVER);
+            break;
+        default:
+            break;
     }
 
+    if (result.events & BOARD_EVENT_PACMAN_STEP)
+        play_sound(assets, SOUND_PACMAN_STEP);
 }
 
 void move_pacman(enum PacmanMove pacman_move, Assets *assets, Board* board, States *states) {
 
     /* 
-     * A function that handles the movement of Pacman
+     * A function that handles the movement of Pacman. The rules themselves
+     * are resolved by the game core in `resolve_move`, while this function
+     * turns Pacman's sprite and plays the sounds of the outcome.
      *
      * params
      *      enum pacman_move
@@ -218,253 +273,38 @@ void move_pacman(enum PacmanMove pacman_move, Assets *assets, Board* board, Stat
      *      Board *board
      *          A pointer to the struct board which stores all the variables
      *          related to the game itself.
-     *
-     * example
-     *      If Pacman moves into a block on its `next_position`, this function
-     *      will return a `GAME_LOST_HIT_BLOCK` enum.
+     *      States *states
+     *          A pointer to the struct States, whose `game_state` is
+     *          updated with the outcome of the move.
      */
     Sprite* pacman = &assets->game.pacman;
 
-    // Current position of Pacman
-    BoardPosition current_position = calculate_pacman_position(pacman);
-    // Next position of Pacman when the player moves
-    BoardPosition next_position;
-
-    enum BoardElement future_obstacle;
     switch (pacman_move) {
         case MOVE_PACMAN_UP:
-            next_position.row =  current_position.row -  1;
-            next_position.col =  current_position.col +  0; 
-
             pacman->flip = SDL_FLIP_NONE;
             pacman->rotation = 270;
-
-            future_obstacle = board->array[next_position.row][next_position.col];
-            if (future_obstacle == EXIT) { 
-                states->game_state = check_if_player_won(next_position, board, assets);
-                break;
-            } else { 
-                states->game_state = check_player_status(next_position, future_obstacle, board, assets);
-                if (states->game_state != GAME_IN_PROGRESS) 
-                    break;
-            }
-
-
-            board->array[current_position.row][current_position.col] = EMPTY;
-            board->array[next_position.row][next_position.col] = PACMAN;
-            Mix_PlayChannel(-1, assets->sounds.pacman_step, 0);
             break;
         case MOVE_PACMAN_DOWN:
-            next_position.row =  current_position.row +  1; 
-            next_position.col =  current_position.col +  0;
-
             pacman->flip = SDL_FLIP_VERTICAL;
             pacman->rotation = 90;
-
-            future_obstacle = board->array[next_position.row][next_position.col];
-            if (future_obstacle == EXIT) { 
-                states->game_state = check_if_player_won(next_position, board, assets);
-                break;
-            } else { 
-                states->game_state = check_player_status(next_position, future_obstacle, board, assets);
-                if (states->game_state != GAME_IN_PROGRESS) 
-                    break;
-            }
-
-            board->array[current_position.row][current_position.col] = EMPTY;
-            board->array[next_position.row][next_position.col] = PACMAN;
-            Mix_PlayChannel(-1, assets->sounds.pacman_step, 0);
             break;
         case MOVE_PACMAN_LEFT:
-            next_position.row =  current_position.row + 0;
-            next_position.col =  current_position.col - 1; 
-
             pacman->flip = SDL_FLIP_HORIZONTAL;
             pacman->rotation = 0;
-
-            future_obstacle = board->array[next_position.row][next_position.col];
-            if (future_obstacle == EXIT) { 
-                states->game_state = check_if_player_won(next_position, board, assets);
-                break;
-            } else { 
-                states->game_state = check_player_status(next_position, future_obstacle, board, assets);
-                if (states->game_state != GAME_IN_PROGRESS) 
-                    break;
-            }
-
-            board->array[current_position.row][current_position.col] = EMPTY;
-            board->array[next_position.row][next_position.col] = PACMAN;
-            Mix_PlayChannel(-1, assets->sounds.pacman_step, 0);
             break;
         case MOVE_PACMAN_RIGHT:
-            next_position.col =  current_position.col + 1; 
-            next_position.row =  current_position.row + 0;
-
             pacman->flip = SDL_FLIP_NONE;
             pacman->rotation = 0;
-
-            future_obstacle = board->array[next_position.row][next_position.col];
-            if (future_obstacle == EXIT) { 
-                states->game_state = check_if_player_won(next_position, board, assets);
-            } else { 
-                states->game_state = check_player_status(next_position, future_obstacle, board, assets);
-                if (states->game_state != GAME_IN_PROGRESS) 
-                    break;
-            }
-
-            board->array[current_position.row][current_position.col] = EMPTY;
-            board->array[next_position.row][next_position.col] = PACMAN;
-            Mix_PlayChannel(-1, assets->sounds.pacman_step, 0);
             break;
-
     };
-}
 
-int count_impassable_neighbors(Board* board, int row, int col) {
-    /* 
-     * A function that calculates the number of impassable neighbors
-     * there are in a given `row` and `col` variables.
-     *  
-     * params
-     *      Board *board
-     *            A pointer to the struct `Board` which
-     *            contains the variables regarding the game.
-     *      int row
-     *            A variable corresponding to the row index of the
-     *            10-by-10 array.
-     *      int col
-     *            A variable corresponding to the column index of the
-     *            10-by-10 array.
-     * returns
-     *       the number of impassable neighbors adjacent to the 
-     *       given row and column.
-     *      
-     *  NOTE:
-     *
-     *  We define `impassable_adjacent_neighbors` as the number of
-     *  adjacent spaces around a food piece or an exit that is impossible
-     *  to be passed through. This includes adjacent block or touching the
-     *  borders.
-     *
-     *  Legend: 
-     *      - x : block
-     *      - * : food
-     *      - - : border
-     *
-     *  Example:
-     *      x
-     *       *
-     *      ---
-     *  This amounts to 4 impassable_adjacent_neighbors. 
-     */
-
-    int impassable_adjacent_neighbors = 0;
-
-    // Loop through all the adjacent neighbors of the row and col
-    for (int i=-1; i<=1; i++) {
-        for (int j=-1; j<=1; j++) {
-
-            if (i == 0 && j == 0) continue;
-            // Counts the number of adjacent spaces touching the border
-            if (row + i == 0 || row + i == 9 || col + j == 0 || col + j == 9) {
-                impassable_adjacent_neighbors++;
-            // Counts the number of adjacent blocks or exit
-            } else if (board->array[row + i][col + j] == BLOCK || board->array[row + i][col + j] == EXIT) 
-                impassable_adjacent_neighbors++;
-            }
-    } 
-    return impassable_adjacent_neighbors;
+    MoveResult result = resolve_move(board, pacman_move);
+    states->game_state = result.game_state;
+    states->show_hint = false;
+    play_move_sounds(result, assets);
 }
 
-void fill_board_with_foods(Board *board) {
-    /* 
-     * A function that randomly fills the board with food.
-     * 
-     * params
-     *       Board *board
-     *          A pointer to the struct Board
-     *
-     */
-    int total_foods_generated = 0;
-    int rand_row, rand_col;
-    int number_of_impassable_neighbors;
-    while (total_foods_generated < board->number_of_foods){
-         // Generates random number between 0-9
-         rand_row =  gen_random_num(0,9); 
-         rand_col =  gen_random_num(0,9);
-
-         number_of_impassable_neighbors = count_impassable_neighbors(board, rand_row, rand_col);
-
-         if (
-            board->array[rand_row][rand_col] == EMPTY &&
-            number_of_impassable_neighbors < MAX_ADJACENT_IMPASSABLE_NEIGHBORS
-         ) {
-            board->array[rand_row][rand_col] = FOOD;
-            total_foods_generated++;
-        }
-    }
-}
-
-void fill_board_with_blocks(Board *board) {
-    /*
-     * A function that fills the board with blocks.
-     * 
-     * params
-     *       Board *board
-     *          A pointer to the struct Board
-     *
-     */
-    int total_blocks_generated = 0;
-    int rand_row;
-    int rand_col;
-    while (total_blocks_generated < board->number_of_blocks) {
-
-         // NOTE:
-         //   To decrease the chances of an impossible win scenario, the following
-         //   restricts the random generation of row and column index wihin the 
-         //   range [1,8].
-
-         // Generate random number between 1-8
-         rand_row =  gen_random_num(1,8); 
-         rand_col =  gen_random_num(1,8);
-         if (board->array[rand_row][rand_col] == EMPTY) {
-
-             board->array[rand_row][rand_col] = BLOCK;
-             total_blocks_generated++;
-        }
-    }
-}
-
-void fill_board_with_exit(Board *board) {
-    /*
-     * A function that randomly places an exit on the game board
-     * 
-     * params
-     *       Board *board
-     *          A pointer to the struct Board which holds
-     *          variables that are concerned with the game itself.
-     */
-
-    // NOTE: 
-    //  Restricting the random number generated for row and col
-    //  to the range [1, 9] ensures that that pacman will not be
-    //  adjacent to the exit.
-
-    // Generate random number between 1-9
-    int rand_row = gen_random_num(1,9); 
-    int rand_col = gen_random_num(1,9); 
-    int number_impassable_neighbors = count_impassable_neighbors(board, rand_row, rand_col);
-    
-    while (!(number_impassable_neighbors < MAX_ADJACENT_IMPASSABLE_NEIGHBORS)) {
-        rand_row = gen_random_num(1,9); 
-        rand_col = gen_random_num(1,9); 
-        number_impassable_neighbors = count_impassable_neighbors(board, rand_row, rand_col);
-    } 
-
-    board->array[rand_row][rand_col] = EXIT;
-}
-
-void init_board(Board* board, Assets* assets, int number_of_foods) {
+bool init_board(Board* board, Assets* assets, States *states) {
     /*
      * A function that initializes the board
      *
@@ -475,30 +315,80 @@ void init_board(Board* board, Assets* assets, int number_of_foods) {
      *      Assets* assets
      *            A pointer to the struct Assets that holds the
      *            required assets for the application
+     *      States *states
+     *            A pointer to the struct States, which holds the number of
+     *            food pieces chosen by the player, the boards that were
+     *            generated ahead of time and the seed requested by the player
+     * returns
+     *      false if no board could be generated
      */
 
-    // Reset the board array
-    for (int row=0; row<10; row++) {
-        for (int col=0; col<10; col++) {
-            board->array[row][col] = EMPTY;
-        }
+    TraceZone zone = begin_trace_zone("init_board");
+    int number_of_foods = states->current_number_of_foods_picked;
+
+    // NOTE:
+    //  A board is usually ready in the queue of pregenerated boards. Only
+    //  when none is ready, or when the player asked for a specific seed, the
+    //  board is generated here on the render thread.
+    int attempts;
+    if (states->has_requested_seed) {
+        attempts = generate_board(board, number_of_foods, states->requested_seed);
+
+        // The requested seed is only used for the first game
+        states->has_requested_seed = false;
+    } else if (states->board_worker && take_pregenerated_board(states->board_worker, board, number_of_foods)) {
+        attempts = board->generation_attempts;
+    } else {
+        attempts = generate_board(board, number_of_foods, next_random(&states->seed_generator));
+    }
+
+    if (attempts == BOARD_PLACEMENT_FAILED) {
+        printf("Error generating board: no legal cell was left for the blocks, the exit or the %d foods\n",
+               number_of_foods);
+        end_trace_zone(zone);
+        return false;
+    } else if (attempts == BOARD_GENERATION_FAILED) {
+        printf("Error generating board: none of the %d boards with %d foods that were placed could be won\n",
+               MAX_BOARD_GENERATION_ATTEMPTS, number_of_foods);
+        end_trace_zone(zone);
+        return false;
     }
+    states->number_of_boards++;
+    states->board_generation_attempts += (unsigned long) attempts;
+
+    // Show the seed, so that the same board can be played again
+    if (!states->quiet)
+        printf("Board seed: %" PRIu64 " (run with `--seed %" PRIu64 "` and pick %d foods to replay it)\n",
+               board->seed, board->seed, number_of_foods);
+
+    // NOTE:
+    //  The route is measured once here, and then only updated by the game
+    //  core as food pieces are eaten, so that a hint is only a lookup.
+    if (build_route_table(&states->route_table, board))
+        board->route_table = &states->route_table;
+    states->show_hint = false;
 
     // Reset the position of pacman
-    board->array[0][0] = PACMAN;
     assets->game.pacman.rect.x = ELEMENT_INITIAL_POSITION_X;
     assets->game.pacman.rect.y = ELEMENT_INITIAL_POSITION_Y;
 
     // Reset the rotation and flip of pacman
     assets->game.pacman.flip = SDL_FLIP_NONE;
     assets->game.pacman.rotation = 0;
+    end_trace_zone(zone);
+    return true;
+}
+
+void print_board_stats(const States *states) {
+    /*
+     * A function that reports how many attempts the boards that were played
+     * took to generate, since the boards that cannot be won are thrown
+     * away and generated again.
+     */
 
-    // Reset the board
-    board->total_player_score = 0;
-    board->number_of_blocks = NUMBER_OF_BLOCKS;
-    board->number_of_foods = number_of_foods;
+    if (states->number_of_boards == 0)
+        return;
 
-    fill_board_with_blocks(board);
-    fill_board_with_exit(board);
-    fill_board_with_foods(board);
+    printf("Boards: %lu played, %.1f generation attempts per board\n", states->number_of_boards,
+           (double) states->board_generation_attempts / (double) states->number_of_boards);
 }
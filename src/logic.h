@@ -7,7 +7,17 @@ void move_pacman(enum PacmanMove move, Assets *assets, Board* board, States* sta
 
 void render_board(Board* board, Assets *assets);
 
-void init_board(Board* board, Assets *assets, int number_of_foods);
+void render_par(Board* board, Assets *assets);
+
+void render_loading_indicator(Assets *assets);
+
+bool show_hint(Board* board, States *states);
+
+void render_hint(Board* board, Assets *assets, States *states);
+
+bool init_board(Board* board, Assets *assets, States *states);
+
+void print_board_stats(const States *states);
 
 
 #endif // !DECLARE_H
@@ -19,27 +19,208 @@
 #include "logic.h"
 #include "state.h"
 #include "assets.h"
+#include "board_worker.h"
+#include "frame_benchmark.h"
+#include "frame_pacer.h"
+#include "input_latency.h"
+#include "options.h"
+#include "perf_hud.h"
+#include "render_queue.h"
+#include "replay.h"
+#include "texture_cache.h"
+#include "trace.h"
+#include "voices.h"
 #include "declarations.h"
 
 
-int main () {
+static bool handle_keypress(SDL_Event event, States *states, Board *board, Assets *assets,
+                            PerfHud *hud, InputLatency *input_latency, Replay *replay) {
+    /*
+     * A helper function that hands a key to the game, whether it was pressed
+     * by the player or played back from a recording.
+     *
+     * returns
+     *      true if the screen has to be drawn again
+     *
+     * NOTE:
+     *  Every keypress changes the screen, since a key that does nothing
+     *  in the current state shows a wrong input reminder.
+     */
 
-    // Set a seed for the random number generator
-    // that is used in the game.
-    time_t t;
-    srand((unsigned) time(&t));
+    // The keys do nothing until the menu is shown
+    if (!is_menu_ready(assets))
+        return false;
+    Uint64 input_start = SDL_GetPerformanceCounter();
+    TraceZone zone = begin_trace_zone("process_keypress");
+    begin_key_sounds(&assets->voices, event.key.timestamp);
+    process_keypress(event, states, board, assets);
+    end_key_sounds(&assets->voices);
+    end_trace_zone(zone);
+    add_perf_hud_input(hud, SDL_GetPerformanceCounter() - input_start);
+    record_replay_key(replay, states, board, event.key.keysym.sym);
+
+    // Carry the time of the key until the frame showing it is presented
+    latch_input(input_latency, event.key.timestamp);
+    return true;
+}
+
+static bool handle_quit(States *states, Replay *replay) {
+    /*
+     * A helper function that asks the player to confirm quitting once the
+     * window is closed.
+     */
+
+    states->show_quit_confirmation = true;
+    record_replay_quit(replay);
+    return true;
+}
+
+static bool process_event(SDL_Event event, States *states, Board *board, Assets *assets,
+                          PerfHud *hud, InputLatency *input_latency, Replay *replay) {
+    /*
+     * A helper function that handles a single event of the main loop.
+     *
+     * returns
+     *      true if the screen has to be drawn again
+     */
+
+    bool is_replay_playing = replay->mode == REPLAY_PLAYING;
+
+    switch (event.type) {
+        case SDL_QUIT:
+            // Closing the window while a recording is played back stops
+            // the game right away
+            if (is_replay_playing) {
+                states->player_wants_to_quit = true;
+                return false;
+            }
+            return handle_quit(states, replay);
+        case SDL_KEYDOWN:
+            // F3 shows or hides the performance overlay, F4 writes the
+            // frame times it keeps, and F9 writes the trace so far, if the
+            // game is traced
+            switch (event.key.keysym.sym) {
+                case SDLK_F3:
+                    hud->is_visible = !hud->is_visible;
+                    return true;
+                case SDLK_F4:
+                    write_perf_hud_csv(hud, PERF_HUD_CSV_FILENAME);
+                    return false;
+                case SDLK_F9:
+                    write_trace();
+                    return false;
+                default:
+                    break;
+            }
+            // The keys of the player are ignored while a recording is
+            // played back
+            if (is_replay_playing)
+                return false;
+            return handle_keypress(event, states, board, assets, hud, input_latency, replay);
+        case SDL_WINDOWEVENT:
+            // The window was uncovered, shown again or restored
+            return event.window.event == SDL_WINDOWEVENT_EXPOSED ||
+                   event.window.event == SDL_WINDOWEVENT_SHOWN ||
+                   event.window.event == SDL_WINDOWEVENT_RESTORED;
+        default:
+            return false;
+    }
+}
+
+int main (int argc, char *argv[]) {
+
+    // The time-to-first-frame is measured from here
+    Uint64 start_time = SDL_GetPerformanceCounter();
+
+    // Every option is read and checked before anything starts, see
+    // `print_usage` for all of them
+    Options options;
+    if (!parse_arguments(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (options.show_usage) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    // A session is recorded with `--record <file>`, and played back with
+    // `--replay <file>`, at the pace it was recorded at, or as fast as
+    // possible with `--replay-fast` as well, which quits at its end
+    Replay replay;
+    init_replay(&replay);
+    if (options.replay_filename && !start_playing(&replay, options.replay_filename, options.is_replay_fast))
+        return 1;
+    if (options.record_filename && !start_recording(&replay, options.record_filename))
+        return 1;
+
+    // With `--benchmark <file>`, a recording is played back as fast as
+    // possible without a display, and the frame rate, the frame times and
+    // the peak memory use are reported at its end
+    FrameBenchmark benchmark;
+    init_frame_benchmark(&benchmark);
+    if (options.benchmark_filename) {
+        if (!start_frame_benchmark(&benchmark, options.benchmark_filename, start_time))
+            return 1;
+
+        // SDL's dummy drivers draw through the software renderer and play
+        // no sound, unless SDL_VIDEODRIVER and SDL_AUDIODRIVER are set
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    }
+
+    // The frame rate can be set with `--fps <n>`, where 0 means uncapped,
+    // e.g. for benchmarking. By default, it follows the display. A
+    // recording played back as fast as possible does not wait for the
+    // display, unless a frame rate is given.
+    int target_fps = options.target_fps;
+    if (replay.mode == REPLAY_PLAYING && replay.is_fast && !options.has_target_fps)
+        target_fps = FRAME_RATE_UNCAPPED;
+
+    // With `--trace <file>`, the time spent loading the assets and drawing
+    // every frame is written to a Chrome trace when the game exits, or
+    // when F9 is pressed
+    if (options.trace_filename)
+        start_tracing(options.trace_filename);
+
+    // Every key is looked up in a table of what it does on every screen,
+    // which is checked for mistakes before anything starts. It only takes a
+    // few microseconds, so every build checks it.
+    if (!check_input_actions())
+        return 1;
 
     // Initialize SDL
-    init_SDL();
+    init_SDL(options.audio_chunk_size);
 
     SDL_Window* window = create_window();
-    SDL_Renderer* renderer = create_renderer(window);
+    SDL_Renderer* renderer = create_renderer(window, target_fps != FRAME_RATE_UNCAPPED);
+
+    FramePacer frame_pacer;
+    init_frame_pacer(&frame_pacer, window, renderer, target_fps);
+
+    // The performance overlay is shown with F3, or from the start with
+    // `--perf-hud`
+    PerfHud hud;
+    init_perf_hud(&hud, frame_pacer.refresh_rate);
+    hud.is_visible = options.show_perf_hud;
+
+    // The time from a key being pressed until it shows on the screen is
+    // reported when the game exits
+    InputLatency input_latency;
+    init_input_latency(&input_latency);
 
     // Set the background color for the window
     SDL_SetRenderDrawColor(renderer, 24, 28, 36, 1);
     
-    // Load all application assets
-    Assets assets = load_all_assets(renderer);
+    // Everything is drawn through the render queue, which batches the
+    // sprites that share a texture
+    RenderQueue *render_queue = create_render_queue(renderer);
+
+    // Start loading all application assets. The images and sounds are
+    // decoded in the background, and the menu is shown as soon as its own
+    // images are loaded.
+    Assets assets;
+    start_loading_assets(&assets, render_queue, (size_t) options.texture_budget_mb * 1024 * 1024);
 
     // Initialize board that will be used in the game
     Board board;
@@ -61,33 +242,168 @@ int main () {
 
     states.show_quit_confirmation = false;
     states.player_wants_to_quit = false;
+    states.show_hint = false;
+    // The details of every board are not printed while benchmarking
+    states.quiet = benchmark.is_running;
+    states.number_of_boards = 0;
+    states.board_generation_attempts = 0;
+
+    // Every board is generated from its own seed, which is drawn from
+    // these generators. They are seeded differently on every run.
+    uint64_t seed = (uint64_t) time(NULL) ^ SDL_GetPerformanceCounter();
+    seed_random_generator(&states.seed_generator, seed);
+
+    // A board can be played again by starting the game with `--seed <seed>`,
+    // using the seed that is shown when the board is generated.
+    states.requested_seed = options.seed;
+    states.has_requested_seed = options.has_seed;
 
-    // Play background music
-    Mix_FadeInMusic(assets.sounds.background_music, -1, 4000);
+    // Start generating boards in the background, so that they are ready
+    // by the time the player starts a game
+    states.board_worker = start_board_worker(next_random(&states.seed_generator));
+
+    // The background music starts once it is loaded
+    bool is_music_playing = false;
+    bool is_first_frame_shown = false;
+
+    // NOTE:
+    //  A frame is only drawn when something on the screen changed, i.e.
+    //  after an event, or while the scene is animated. Otherwise, the loop
+    //  sleeps until the next event arrives. Nothing is drawn at all while
+    //  the window is hidden or minimized.
+    //
+    //  The work that does not depend on the keys is done first, and the
+    //  loop then waits for the next frame to be due. Only then are the
+    //  keys read, right before the frame is drawn, so that they show up on
+    //  the screen as soon as possible.
+    bool scene_changed = true;
+    bool was_idle = false;
+    bool was_frame_presented = false;
 
     while (!states.player_wants_to_quit) {
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                states.show_quit_confirmation = true;
+
+        // Hand over the assets that were decoded since the last frame
+        scene_changed |= update_asset_loading(&assets);
+
+        // Vsync is detected from the frames drawn once loading is over
+        if (are_all_assets_loaded(&assets))
+            start_frame_pacer_calibration(&frame_pacer);
+
+        // Load one of the atlas pages that are likely to be drawn soon
+        prefetch_atlas_page(&assets.texture_cache);
+
+        // Play background music
+        if (!is_music_playing && assets.sounds.background_music) {
+            Mix_FadeInMusic(assets.sounds.background_music, -1, 4000);
+            is_music_playing = true;
+        }
+
+        bool is_window_hidden = SDL_GetWindowFlags(window) & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED);
+        // The performance overlay is drawn on every frame while it is shown
+        bool is_animated = is_scene_animated(&states, &assets) || hud.is_visible;
+        bool is_idle = is_window_hidden || (!scene_changed && !is_animated &&
+                                            !has_atlas_page_requests(&assets.texture_cache));
+
+        if (is_idle) {
+            was_idle = true;
+            // A recording that is played back wakes the loop up once its
+            // next key is due
+            if (SDL_WaitEventTimeout(&event, (int) get_replay_timeout(&replay, IDLE_EVENT_TIMEOUT)))
+                scene_changed |= process_event(event, &states, &board, &assets, &hud, &input_latency, &replay);
+        } else if (was_frame_presented) {
+            // Wait for the next frame, either through vsync or by sleeping
+            wait_for_next_frame(&frame_pacer);
+        }
+        was_frame_presented = false;
+
+        // Hand over the keys of the recording that are due. When it is
+        // played back as fast as possible, a frame is drawn after every key.
+        if (is_menu_ready(&assets)) {
+            start_replay_clock(&replay);
+            while (take_replayed_event(&replay, &states, &board, &event)) {
+                if (event.type == SDL_QUIT)
+                    scene_changed |= handle_quit(&states, &replay);
+                else
+                    scene_changed |= handle_keypress(event, &states, &board, &assets, &hud, &input_latency, &replay);
+                if (replay.is_fast)
+                    break;
             }
-            else if (event.type == SDL_KEYDOWN) 
-                process_keypress(event, &states, &board, &assets);
         }
+
+        // Take every event that is queued by now in batches, rather than
+        // locking SDL's queue for each one
+        SDL_PumpEvents();
+        SDL_Event events[MAX_EVENTS_PER_BATCH];
+        int number_of_events;
+        while ((number_of_events = SDL_PeepEvents(events, MAX_EVENTS_PER_BATCH, SDL_GETEVENT,
+                                                  SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0) {
+            for (int i = 0; i < number_of_events; i++) {
+                scene_changed |= process_event(events[i], &states, &board, &assets, &hud, &input_latency, &replay);
+            }
+        }
+
+        if (is_window_hidden || !(scene_changed || is_scene_animated(&states, &assets) || hud.is_visible))
+            continue;
+
+        if (was_idle) {
+            resume_frame_pacer(&frame_pacer);
+            resume_perf_hud(&hud);
+            was_idle = false;
+        }
+
+        Uint64 frame_start = SDL_GetPerformanceCounter();
+
         // Clear the previous `states` in the window.
         SDL_RenderClear(renderer);
     
         // Render the current `state` of the application
+        TraceZone render_zone = begin_trace_zone("render_state");
         render_state(&states, &board, &assets);
+        end_trace_zone(render_zone);
+        Uint64 render_end = SDL_GetPerformanceCounter();
+
+        // The overlay is drawn on its own, so that the draw calls it counts
+        // are those of the frame
+        FrameSample sample = {
+            .render=render_end - frame_start,
+            .draw_calls=render_queue->draw_calls,
+            .texture_bytes=assets.texture_cache.bytes_used,
+        };
+        render_perf_hud(&hud, render_queue);
+        flush_render_queue(render_queue);
+
+        Uint64 present_start = SDL_GetPerformanceCounter();
+        TraceZone present_zone = begin_trace_zone("SDL_RenderPresent");
         SDL_RenderPresent(renderer);
+        end_trace_zone(present_zone);
+        Uint64 present_end = SDL_GetPerformanceCounter();
+        sample.present = present_end - present_start;
+        add_benchmark_frame(&benchmark, record_frame_sample(&hud, sample, frame_start, present_end));
+        record_input_present(&input_latency, SDL_GetTicks());
+        was_frame_presented = true;
+        prefetch_next_screens(&states, &assets);
+        scene_changed = false;
 
-        // Limit the framerate to 60 frames per second
-        SDL_Delay(1000/60); 
+        if (!is_first_frame_shown && is_menu_ready(&assets)) {
+            double elapsed = (double) (SDL_GetPerformanceCounter() - start_time) / (double) SDL_GetPerformanceFrequency();
+            printf("Time to first frame: %.1f ms\n", elapsed * 1000.0);
+            is_first_frame_shown = true;
+        }
     }
 
     // Free all resources and allocated memory used throughout
     // the application
+    stop_replay(&replay, &states, &board);
+    stop_frame_benchmark(&benchmark);
+    stop_board_worker(states.board_worker);
+    print_board_stats(&states);
+    print_texture_cache_stats(&assets.texture_cache);
+    print_audio_stats(&assets);
+    print_input_latency(&input_latency);
     free_all_assets(&assets);
+    stop_tracing();
+    destroy_render_queue(render_queue);
     IMG_Quit();
     SDL_DestroyWindow(window);
     SDL_DestroyRenderer(renderer);
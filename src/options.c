@@ -0,0 +1,260 @@
+/*
+ *  This file, `options.c`, contains the options the game is started with,
+ *  which are read from the command line once, before anything starts.
+ *
+ *  usage
+ *      ./ghostless-pacman [options]
+ *
+ *      See `print_usage` for every option.
+ *
+ *  NOTE:
+ *      An unknown option, a value that is missing or is not valid, or two
+ *      options that cannot be used together stop the game before it
+ *      starts, rather than being ignored, so that the game never runs with
+ *      other settings than the ones that were asked for.
+ */
+
+#include "errno.h"
+#include "limits.h"
+#include "stdbool.h"
+#include "stdint.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "declarations.h"
+#include "options.h"
+
+// SDL keeps the number of samples the audio device mixes at a time in 16 bits
+#define MAX_AUDIO_CHUNK_SIZE 65535
+
+// The largest texture budget, in megabytes, whose size in bytes fits in
+// a size_t
+#define MAX_TEXTURE_BUDGET_MB (SIZE_MAX / (1024 * 1024) < LONG_MAX ? (long) (SIZE_MAX / (1024 * 1024)) : LONG_MAX)
+
+static bool parse_number(const char *text, long minimum, long maximum, long *number) {
+    /*
+     * A helper function that reads a whole number given on the command line.
+     *
+     * params
+     *      const char *text
+     *          The number, in base 10
+     *      long minimum, long maximum
+     *          The range the number must be in
+     *      long *number
+     *          Receives the number, if it is valid
+     * returns
+     *      false if `text` is not only a number, or it is out of range
+     */
+
+    char *end;
+    errno = 0;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < minimum || parsed > maximum)
+        return false;
+
+    *number = parsed;
+    return true;
+}
+
+static bool parse_seed(const char *text, uint64_t *seed) {
+    /*
+     * A helper function that reads the seed of a board given on the command
+     * line, as it is shown when the board is generated.
+     *
+     * returns
+     *      false if `text` is not only a number, or it does not fit in 64
+     *      bits
+     *
+     * NOTE:
+     *  `strtoull` also accepts a sign, and reads "-1" as the largest seed,
+     *  so the seed must start with a digit.
+     */
+
+    if (text[0] < '0' || text[0] > '9')
+        return false;
+
+    char *end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > UINT64_MAX)
+        return false;
+
+    *seed = (uint64_t) parsed;
+    return true;
+}
+
+static void init_options(Options *options) {
+    /*
+     * A helper function that sets every option to its default, and marks
+     * the options with a value as not given.
+     */
+
+    options->show_usage = false;
+    options->target_fps = FRAME_RATE_MATCH_DISPLAY;
+    options->has_target_fps = false;
+    options->record_filename = NULL;
+    options->replay_filename = NULL;
+    options->is_replay_fast = false;
+    options->benchmark_filename = NULL;
+    options->texture_budget_mb = 0;
+    options->audio_chunk_size = 0;
+    options->is_low_latency_audio = false;
+    options->trace_filename = NULL;
+    options->show_perf_hud = false;
+    options->seed = 0;
+    options->has_seed = false;
+}
+
+static bool check_options(Options *options) {
+    /*
+     * A helper function that rejects the options that cannot be used
+     * together, and fills in the ones that follow from the others.
+     *
+     * returns
+     *      false if two of the options conflict, which is printed
+     */
+
+    const char *conflict = NULL;
+    if (options->record_filename && (options->replay_filename || options->benchmark_filename))
+        conflict = "--record cannot be used while a recording is played back";
+    else if (options->replay_filename && options->benchmark_filename)
+        conflict = "--replay and --benchmark both play back a recording";
+    else if (options->is_replay_fast && !options->replay_filename)
+        conflict = "--replay-fast only applies to --replay";
+    else if (options->has_seed && (options->replay_filename || options->benchmark_filename))
+        conflict = "--seed cannot be used while a recording is played back, which has its own seeds";
+    else if (options->is_low_latency_audio && options->audio_chunk_size != 0)
+        conflict = "--low-latency-audio and --audio-buffer both set the audio buffer";
+
+    if (conflict) {
+        printf("Error: %s\n", conflict);
+        return false;
+    }
+
+    // A benchmark is a recording that is played back as fast as possible
+    if (options->benchmark_filename) {
+        options->replay_filename = options->benchmark_filename;
+        options->is_replay_fast = true;
+    }
+
+    if (options->texture_budget_mb == 0)
+        options->texture_budget_mb = DEFAULT_TEXTURE_BUDGET_MB;
+    if (options->audio_chunk_size == 0)
+        options->audio_chunk_size = options->is_low_latency_audio ? LOW_LATENCY_AUDIO_CHUNK_SIZE : AUDIO_CHUNK_SIZE;
+    return true;
+}
+
+bool parse_arguments(int argc, char *argv[], Options *options) {
+    /*
+     * A function that reads the options the game is started with.
+     *
+     * params
+     *      int argc, char *argv[]
+     *          The arguments given to `main`
+     *      Options *options
+     *          Receives the options, with a default for every option that
+     *          was not given
+     * returns
+     *      false if an option is unknown, given twice, is missing its value
+     *      or has a value that is not valid, or two options conflict, which
+     *      is printed
+     */
+
+    init_options(options);
+
+    for (int i=1; i<argc; i++) {
+        const char *option = argv[i];
+        bool has_value = i + 1 < argc;
+        const char *value = has_value ? argv[i + 1] : NULL;
+        bool is_valid = true;
+        bool is_repeated = false;
+
+        if (strcmp(option, "--help") == 0 || strcmp(option, "-h") == 0) {
+            options->show_usage = true;
+            continue;
+        } else if (strcmp(option, "--replay-fast") == 0) {
+            options->is_replay_fast = true;
+            continue;
+        } else if (strcmp(option, "--low-latency-audio") == 0) {
+            options->is_low_latency_audio = true;
+            continue;
+        } else if (strcmp(option, "--perf-hud") == 0) {
+            options->show_perf_hud = true;
+            continue;
+        } else if (strcmp(option, "--fps") == 0) {
+            long fps = 0;
+            is_repeated = options->has_target_fps;
+            is_valid = has_value && parse_number(value, 0, INT_MAX, &fps);
+            options->target_fps = (int) fps;
+            options->has_target_fps = true;
+        } else if (strcmp(option, "--record") == 0) {
+            is_repeated = options->record_filename != NULL;
+            options->record_filename = value;
+        } else if (strcmp(option, "--replay") == 0) {
+            is_repeated = options->replay_filename != NULL;
+            options->replay_filename = value;
+        } else if (strcmp(option, "--benchmark") == 0) {
+            is_repeated = options->benchmark_filename != NULL;
+            options->benchmark_filename = value;
+        } else if (strcmp(option, "--texture-budget") == 0) {
+            is_repeated = options->texture_budget_mb != 0;
+            is_valid = has_value && parse_number(value, 1, MAX_TEXTURE_BUDGET_MB, &options->texture_budget_mb);
+        } else if (strcmp(option, "--audio-buffer") == 0) {
+            long samples = 0;
+            is_repeated = options->audio_chunk_size != 0;
+            is_valid = has_value && parse_number(value, 1, MAX_AUDIO_CHUNK_SIZE, &samples);
+            options->audio_chunk_size = (int) samples;
+        } else if (strcmp(option, "--trace") == 0) {
+            is_repeated = options->trace_filename != NULL;
+            options->trace_filename = value;
+        } else if (strcmp(option, "--seed") == 0) {
+            is_repeated = options->has_seed;
+            is_valid = has_value && parse_seed(value, &options->seed);
+            options->has_seed = true;
+        } else {
+            printf("Error: unknown option %s\n", option);
+            return false;
+        }
+
+        if (!has_value) {
+            printf("Error: %s expects a value\n", option);
+            return false;
+        }
+        if (!is_valid) {
+            printf("Error: %s is not a valid value for %s\n", value, option);
+            return false;
+        }
+        if (is_repeated) {
+            printf("Error: %s is given more than once\n", option);
+            return false;
+        }
+        // Skip the value
+        i++;
+    }
+
+    return check_options(options);
+}
+
+void print_usage(const char *program) {
+    /*
+     * A function that prints every option the game can be started with.
+     */
+
+    printf("usage: %s [options]\n"
+           "\n"
+           "  --seed <seed>              play the board with this seed first\n"
+           "  --fps <n>                  frames per second, 0 for uncapped (default: the display's)\n"
+           "  --texture-budget <MB>      texture memory for the atlas pages (default: %d)\n"
+           "  --low-latency-audio        mix the sounds %d samples at a time\n"
+           "  --audio-buffer <samples>   mix the sounds this many samples at a time (default: %d)\n"
+           "  --trace <file>             write a Chrome trace of loading and drawing\n"
+           "  --perf-hud                 show the performance overlay, F3 toggles it\n"
+           "  --record <file>            record the session\n"
+           "  --replay <file>            play back a recorded session\n"
+           "  --replay-fast              play it back as fast as possible\n"
+           "  --benchmark <file>         play back a recorded session without a display, and\n"
+           "                             report the frame rate and the frame times\n"
+           "  --help                     show this\n",
+           program, DEFAULT_TEXTURE_BUDGET_MB, LOW_LATENCY_AUDIO_CHUNK_SIZE, AUDIO_CHUNK_SIZE);
+}
@@ -0,0 +1,10 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "declarations.h"
+
+bool parse_arguments(int argc, char *argv[], Options *options);
+
+void print_usage(const char *program);
+
+#endif // !OPTIONS_H
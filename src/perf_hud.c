@@ -0,0 +1,248 @@
+/*
+ *  This file, `perf_hud.c`, contains the performance overlay, which shows how
+ *  long the last frames took to handle the keys, to render and to present,
+ *  together with a graph of the frame times. It is shown with F3, and the
+ *  frames it keeps are written to a CSV file with F4.
+ *
+ *  NOTE:
+ *      The overlay is drawn after the frame itself, so it shows the times of
+ *      the frames before the current one, and does not count towards them.
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stddef.h"
+#include "stdbool.h"
+
+#include "declarations.h"
+#include "perf_hud.h"
+#include "render_queue.h"
+#include "text.h"
+
+#include "SDL2/SDL.h"
+
+#define PERF_HUD_MARGIN 10
+#define PERF_HUD_PADDING 8
+#define PERF_HUD_TEXT_SCALE 2
+#define PERF_HUD_LINE_HEIGHT 14
+#define PERF_HUD_BAR_WIDTH 2
+#define PERF_HUD_GRAPH_HEIGHT 60
+
+// The graph reaches its top at this many times the frame budget
+#define PERF_HUD_GRAPH_BUDGETS 3
+
+void init_perf_hud(PerfHud *hud, int refresh_rate) {
+    /*
+     * A function that sets up a hidden overlay without any frames.
+     *
+     * params
+     *      PerfHud *hud
+     *          A pointer to the struct PerfHud
+     *      int refresh_rate
+     *          The refresh rate of the display, which the frame times are
+     *          compared to
+     */
+
+    hud->is_visible = false;
+    hud->number_of_samples = 0;
+    hud->input = 0;
+    hud->previous_present = 0;
+    hud->ticks_per_second = SDL_GetPerformanceFrequency();
+    hud->frame_budget = hud->ticks_per_second / (Uint64) (refresh_rate > 0 ? refresh_rate : DEFAULT_REFRESH_RATE);
+}
+
+void add_perf_hud_input(PerfHud *hud, Uint64 ticks) {
+    /*
+     * A function that adds the time it took to handle a key to the next
+     * frame.
+     */
+
+    hud->input += ticks;
+}
+
+void resume_perf_hud(PerfHud *hud) {
+    /*
+     * A function that keeps the pause of the main loop, while nothing was
+     * drawn, from being counted as a long frame.
+     */
+
+    hud->previous_present = 0;
+}
+
+FrameSample record_frame_sample(PerfHud *hud, FrameSample sample, Uint64 frame_start, Uint64 presented_at) {
+    /*
+     * A function that keeps what a frame took, overwriting the oldest frame
+     * if the ring buffer is full.
+     *
+     * params
+     *      PerfHud *hud
+     *          A pointer to the struct PerfHud
+     *      FrameSample sample
+     *          The render and present times, the draw calls and the texture
+     *          memory of the frame. Its frame and input times are filled in.
+     *      Uint64 frame_start
+     *          When the frame started, which it is timed from after a pause
+     *      Uint64 presented_at
+     *          When the frame was presented
+     * returns
+     *      The sample with its frame and input times filled in
+     */
+
+    Uint64 previous = hud->previous_present ? hud->previous_present : frame_start;
+    sample.frame = presented_at - previous;
+    sample.input = hud->input;
+
+    hud->samples[hud->number_of_samples % PERF_HUD_FRAMES] = sample;
+    hud->number_of_samples++;
+    hud->input = 0;
+    hud->previous_present = presented_at;
+    return sample;
+}
+
+static int get_number_of_kept_samples(const PerfHud *hud) {
+    return hud->number_of_samples < PERF_HUD_FRAMES ? (int) hud->number_of_samples : PERF_HUD_FRAMES;
+}
+
+static const FrameSample* get_sample(const PerfHud *hud, int age) {
+    /*
+     * A helper function that returns a kept frame, from the oldest one, at
+     * age 0, to the newest one.
+     */
+
+    unsigned long first = hud->number_of_samples - (unsigned long) get_number_of_kept_samples(hud);
+    return &hud->samples[(first + (unsigned long) age) % PERF_HUD_FRAMES];
+}
+
+static int compare_ticks(const void *a, const void *b) {
+    Uint64 first = *(const Uint64 *) a;
+    Uint64 second = *(const Uint64 *) b;
+    return (first > second) - (first < second);
+}
+
+static void render_percentiles(const PerfHud *hud, RenderQueue *queue, const char *label, size_t offset, int y, SDL_Color color) {
+    /*
+     * A helper function that draws a line with the p50, p99 and max of one
+     * of the times of the kept frames.
+     *
+     * params
+     *      size_t offset
+     *          Where the time is in the struct FrameSample, e.g.
+     *          `offsetof(FrameSample, render)`
+     */
+
+    Uint64 ticks[PERF_HUD_FRAMES];
+    int number_of_samples = get_number_of_kept_samples(hud);
+    for (int i=0; i<number_of_samples; i++) {
+        ticks[i] = *(const Uint64 *) ((const char *) get_sample(hud, i) + offset);
+    }
+    qsort(ticks, number_of_samples, sizeof(Uint64), compare_ticks);
+
+    double ticks_per_ms = (double) hud->ticks_per_second / 1000.0;
+    double p50 = (double) ticks[number_of_samples / 2] / ticks_per_ms;
+    double p99 = (double) ticks[(number_of_samples * 99) / 100] / ticks_per_ms;
+    double max = (double) ticks[number_of_samples - 1] / ticks_per_ms;
+
+    char text[64];
+    snprintf(text, sizeof(text), "%-8s%7.2f%7.2f%7.2f", label, p50, p99, max);
+    render_text(queue, RENDER_LAYER_DIALOG, text, PERF_HUD_MARGIN + PERF_HUD_PADDING, y, PERF_HUD_TEXT_SCALE, color);
+}
+
+void render_perf_hud(const PerfHud *hud, RenderQueue *queue) {
+    /*
+     * A function that queues the overlay to be drawn, if it is shown.
+     *
+     * params
+     *      const PerfHud *hud
+     *          A pointer to the struct PerfHud
+     *      RenderQueue *queue
+     *          The queue to draw through, which must be flushed afterwards
+     */
+
+    int number_of_samples = get_number_of_kept_samples(hud);
+    if (!hud->is_visible || number_of_samples == 0)
+        return;
+
+    SDL_Color background = {.r=24, .g=28, .b=36, .a=255};
+    SDL_Color text_color = {.r=234, .g=205, .b=134, .a=255};
+    SDL_Color within_budget = {.r=120, .g=200, .b=120, .a=255};
+    SDL_Color over_budget = {.r=220, .g=90, .b=90, .a=255};
+
+    int graph_width = PERF_HUD_FRAMES * PERF_HUD_BAR_WIDTH;
+    int x = PERF_HUD_MARGIN + PERF_HUD_PADDING;
+    int y = PERF_HUD_MARGIN + PERF_HUD_PADDING;
+    SDL_Rect panel = {
+        .x=PERF_HUD_MARGIN, .y=PERF_HUD_MARGIN,
+        .w=graph_width + 2 * PERF_HUD_PADDING,
+        .h=6 * PERF_HUD_LINE_HEIGHT + PERF_HUD_GRAPH_HEIGHT + 3 * PERF_HUD_PADDING
+    };
+    queue_filled_rect(queue, RENDER_LAYER_DIALOG, panel, background);
+
+    char text[64];
+    snprintf(text, sizeof(text), "%-8s%7s%7s%7s", "MS", "P50", "P99", "MAX");
+    render_text(queue, RENDER_LAYER_DIALOG, text, x, y, PERF_HUD_TEXT_SCALE, text_color);
+    render_percentiles(hud, queue, "FRAME", offsetof(FrameSample, frame), y + 1 * PERF_HUD_LINE_HEIGHT, text_color);
+    render_percentiles(hud, queue, "INPUT", offsetof(FrameSample, input), y + 2 * PERF_HUD_LINE_HEIGHT, text_color);
+    render_percentiles(hud, queue, "RENDER", offsetof(FrameSample, render), y + 3 * PERF_HUD_LINE_HEIGHT, text_color);
+    render_percentiles(hud, queue, "PRESENT", offsetof(FrameSample, present), y + 4 * PERF_HUD_LINE_HEIGHT, text_color);
+
+    const FrameSample *newest = get_sample(hud, number_of_samples - 1);
+    snprintf(text, sizeof(text), "DRAW CALLS %d  TEXTURES %.1f MB", newest->draw_calls,
+             (double) newest->texture_bytes / (1024.0 * 1024.0));
+    render_text(queue, RENDER_LAYER_DIALOG, text, x, y + 5 * PERF_HUD_LINE_HEIGHT, PERF_HUD_TEXT_SCALE, text_color);
+
+    // Draw a bar for every frame, from the oldest on the left, and a line
+    // at the frame budget
+    int graph_bottom = y + 6 * PERF_HUD_LINE_HEIGHT + PERF_HUD_PADDING + PERF_HUD_GRAPH_HEIGHT;
+    Uint64 graph_top = hud->frame_budget * PERF_HUD_GRAPH_BUDGETS;
+    int offset = PERF_HUD_FRAMES - number_of_samples;
+    for (int i=0; i<number_of_samples; i++) {
+        Uint64 frame = get_sample(hud, i)->frame;
+        if (frame > graph_top)
+            frame = graph_top;
+
+        int height = (int) (frame * PERF_HUD_GRAPH_HEIGHT / graph_top);
+        if (height < 1)
+            height = 1;
+        SDL_Rect bar = {.x=x + (offset + i) * PERF_HUD_BAR_WIDTH, .y=graph_bottom - height, .w=PERF_HUD_BAR_WIDTH, .h=height};
+        queue_filled_rect(queue, RENDER_LAYER_DIALOG, bar, frame > hud->frame_budget ? over_budget : within_budget);
+    }
+
+    SDL_Rect budget_line = {.x=x, .y=graph_bottom - PERF_HUD_GRAPH_HEIGHT / PERF_HUD_GRAPH_BUDGETS, .w=graph_width, .h=1};
+    queue_filled_rect(queue, RENDER_LAYER_DIALOG, budget_line, text_color);
+}
+
+bool write_perf_hud_csv(const PerfHud *hud, const char *filename) {
+    /*
+     * A function that writes the kept frames to a CSV file, from the oldest
+     * one to the newest one, with the times in milliseconds.
+     *
+     * returns
+     *      false if the file cannot be written
+     */
+
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        printf("Error writing the frame times to %s\n", filename);
+        return false;
+    }
+
+    double ticks_per_ms = (double) hud->ticks_per_second / 1000.0;
+    int number_of_samples = get_number_of_kept_samples(hud);
+    unsigned long first = hud->number_of_samples - (unsigned long) number_of_samples;
+
+    fprintf(file, "frame,frame_ms,input_ms,render_ms,present_ms,draw_calls,texture_mb\n");
+    for (int i=0; i<number_of_samples; i++) {
+        const FrameSample *sample = get_sample(hud, i);
+        fprintf(file, "%lu,%.3f,%.3f,%.3f,%.3f,%d,%.2f\n", first + (unsigned long) i,
+                (double) sample->frame / ticks_per_ms, (double) sample->input / ticks_per_ms,
+                (double) sample->render / ticks_per_ms, (double) sample->present / ticks_per_ms,
+                sample->draw_calls, (double) sample->texture_bytes / (1024.0 * 1024.0));
+    }
+
+    bool is_written = !ferror(file);
+    fclose(file);
+
+    if (is_written)
+        printf("Wrote %d frame times to %s\n", number_of_samples, filename);
+    return is_written;
+}
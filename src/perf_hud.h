@@ -0,0 +1,18 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include "declarations.h"
+
+void init_perf_hud(PerfHud *hud, int refresh_rate);
+
+void add_perf_hud_input(PerfHud *hud, Uint64 ticks);
+
+void resume_perf_hud(PerfHud *hud);
+
+FrameSample record_frame_sample(PerfHud *hud, FrameSample sample, Uint64 frame_start, Uint64 presented_at);
+
+void render_perf_hud(const PerfHud *hud, RenderQueue *queue);
+
+bool write_perf_hud_csv(const PerfHud *hud, const char *filename);
+
+#endif // !PERF_HUD_H
@@ -0,0 +1,292 @@
+/*
+ *  This file, `render_queue.c`, contains the queue that everything drawn on
+ *  the screen goes through.
+ *
+ *  NOTE:
+ *      Instead of drawing right away, the render functions queue what they
+ *      draw. When the frame is complete, the queue is sorted by layer and by
+ *      texture, and every run of commands that use the same texture is drawn
+ *      with a single call to SDL_RenderGeometry. Since most sprites share an
+ *      atlas page, the whole board takes only a few draw calls.
+ *
+ *      SDL_RenderGeometry was added in SDL 2.0.18. With older versions, or
+ *      renderers that do not support it, each command is drawn on its own,
+ *      in the same order.
+ */
+
+#include "stdint.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+#include "declarations.h"
+#include "render_queue.h"
+
+RenderQueue* create_render_queue(SDL_Renderer *renderer) {
+    /*
+     * A function that creates an empty queue that draws with `renderer`.
+     *
+     * returns
+     *      a pointer to the new RenderQueue, which is freed with
+     *      `destroy_render_queue`
+     */
+
+    RenderQueue *queue = malloc(sizeof(RenderQueue));
+    if (!queue) {
+        printf("Error creating render queue\n");
+        return NULL;
+    }
+
+    queue->renderer = renderer;
+    queue->number_of_commands = 0;
+    queue->draw_calls = 0;
+    queue->uses_geometry = false;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    SDL_version linked;
+    SDL_GetVersion(&linked);
+    queue->uses_geometry = SDL_VERSIONNUM(linked.major, linked.minor, linked.patch) >= SDL_VERSIONNUM(2, 0, 18);
+
+    // Every rectangle is two triangles, and the batches always start at
+    // the first vertex, so the indices never change
+    for (int i=0; i<MAX_RENDER_COMMANDS; i++) {
+        int *indices = &queue->indices[i * 6];
+        indices[0] = i * 4 + 0;
+        indices[1] = i * 4 + 1;
+        indices[2] = i * 4 + 2;
+        indices[3] = i * 4 + 2;
+        indices[4] = i * 4 + 3;
+        indices[5] = i * 4 + 0;
+    }
+#endif
+
+    return queue;
+}
+
+void destroy_render_queue(RenderQueue *queue) {
+    free(queue);
+}
+
+static RenderCommand* next_command(RenderQueue *queue, enum RenderLayer layer) {
+    /*
+     * A helper function that returns a new command at the end of the queue.
+     *
+     * NOTE:
+     *  A full queue is drawn right away to make room. This keeps everything
+     *  on the screen, though the commands queued afterwards may end up below
+     *  those drawn before them.
+     */
+
+    if (queue->number_of_commands == MAX_RENDER_COMMANDS)
+        flush_render_queue(queue);
+
+    RenderCommand *command = &queue->commands[queue->number_of_commands];
+    command->layer = layer;
+    command->order = queue->number_of_commands;
+    queue->number_of_commands++;
+    return command;
+}
+
+void queue_texture(RenderQueue *queue, enum RenderLayer layer, SDL_Texture *texture, SDL_Rect source,
+                   SDL_Rect destination, float rotation, SDL_RendererFlip flip) {
+    /*
+     * A function that queues part of a texture to be drawn.
+     *
+     * params
+     *      RenderQueue *queue
+     *          A pointer to the struct RenderQueue of the frame
+     *      enum RenderLayer layer
+     *          The layer to draw on
+     *      SDL_Texture *texture
+     *          The texture to draw from
+     *      SDL_Rect source
+     *          The part of the texture to draw
+     *      SDL_Rect destination
+     *          Where to draw it on the screen
+     *      float rotation
+     *          The clockwise rotation around the center of `destination`,
+     *          in degrees
+     *      SDL_RendererFlip flip
+     *          Whether to mirror the texture
+     */
+
+    if (!texture)
+        return;
+
+    RenderCommand *command = next_command(queue, layer);
+    command->texture = texture;
+    command->source = source;
+    command->destination = destination;
+    command->color = (SDL_Color) {255, 255, 255, 255};
+    command->rotation = rotation;
+    command->flip = flip;
+}
+
+void queue_filled_rect(RenderQueue *queue, enum RenderLayer layer, SDL_Rect rect, SDL_Color color) {
+    /*
+     * A function that queues a rectangle filled with `color` to be drawn.
+     */
+
+    RenderCommand *command = next_command(queue, layer);
+    command->texture = NULL;
+    command->source = (SDL_Rect) {0, 0, 0, 0};
+    command->destination = rect;
+    command->color = color;
+    command->rotation = 0;
+    command->flip = SDL_FLIP_NONE;
+}
+
+static int compare_commands(const void *a, const void *b) {
+    /*
+     * A helper function that sorts the commands by layer, then by texture,
+     * then in the order they were queued.
+     */
+
+    const RenderCommand *first = a;
+    const RenderCommand *second = b;
+
+    if (first->layer != second->layer)
+        return first->layer < second->layer ? -1 : 1;
+    if (first->texture != second->texture)
+        return (uintptr_t) first->texture < (uintptr_t) second->texture ? -1 : 1;
+    return first->order - second->order;
+}
+
+static void draw_command(RenderQueue *queue, const RenderCommand *command) {
+    /*
+     * A helper function that draws a single command with its own draw call.
+     */
+
+    if (command->texture) {
+        SDL_RenderCopyEx(queue->renderer, command->texture, &command->source, &command->destination,
+                         command->rotation, NULL, command->flip);
+    } else {
+        // The draw color is also the color the screen is cleared with
+        Uint8 r, g, b, a;
+        SDL_GetRenderDrawColor(queue->renderer, &r, &g, &b, &a);
+        SDL_SetRenderDrawColor(queue->renderer, command->color.r, command->color.g, command->color.b, command->color.a);
+        SDL_RenderFillRect(queue->renderer, &command->destination);
+        SDL_SetRenderDrawColor(queue->renderer, r, g, b, a);
+    }
+    queue->draw_calls++;
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+static void build_vertices(const RenderCommand *command, int texture_width, int texture_height, SDL_Vertex *vertices) {
+    /*
+     * A helper function that turns a command into the four corners of its
+     * rectangle, in clockwise order from the top left.
+     */
+
+    const SDL_Rect *destination = &command->destination;
+    float left   = (float) destination->x;
+    float top    = (float) destination->y;
+    float right  = (float) (destination->x + destination->w);
+    float bottom = (float) (destination->y + destination->h);
+
+    SDL_FPoint positions[4] = { {left, top}, {right, top}, {right, bottom}, {left, bottom} };
+
+    if (command->rotation != 0) {
+        float center_x = left + destination->w / 2.0f;
+        float center_y = top + destination->h / 2.0f;
+        float radians = command->rotation * (float) M_PI / 180.0f;
+        float cosine = SDL_cosf(radians);
+        float sine = SDL_sinf(radians);
+
+        for (int corner=0; corner<4; corner++) {
+            float dx = positions[corner].x - center_x;
+            float dy = positions[corner].y - center_y;
+            positions[corner].x = center_x + dx * cosine - dy * sine;
+            positions[corner].y = center_y + dx * sine + dy * cosine;
+        }
+    }
+
+    float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+    if (command->texture) {
+        u0 = (float) command->source.x / texture_width;
+        v0 = (float) command->source.y / texture_height;
+        u1 = (float) (command->source.x + command->source.w) / texture_width;
+        v1 = (float) (command->source.y + command->source.h) / texture_height;
+
+        if (command->flip & SDL_FLIP_HORIZONTAL) {
+            float swap = u0;
+            u0 = u1;
+            u1 = swap;
+        }
+        if (command->flip & SDL_FLIP_VERTICAL) {
+            float swap = v0;
+            v0 = v1;
+            v1 = swap;
+        }
+    }
+
+    SDL_FPoint tex_coords[4] = { {u0, v0}, {u1, v0}, {u1, v1}, {u0, v1} };
+
+    for (int corner=0; corner<4; corner++) {
+        vertices[corner].position = positions[corner];
+        vertices[corner].color = command->color;
+        vertices[corner].tex_coord = tex_coords[corner];
+    }
+}
+#endif
+
+static void draw_batch(RenderQueue *queue, const RenderCommand *commands, int number_of_commands) {
+    /*
+     * A helper function that draws commands which all use the same texture.
+     */
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (queue->uses_geometry) {
+        SDL_Texture *texture = commands[0].texture;
+        int texture_width = 1;
+        int texture_height = 1;
+        if (texture)
+            SDL_QueryTexture(texture, NULL, NULL, &texture_width, &texture_height);
+
+        for (int i=0; i<number_of_commands; i++) {
+            build_vertices(&commands[i], texture_width, texture_height, &queue->vertices[i * 4]);
+        }
+
+        if (SDL_RenderGeometry(queue->renderer, texture, queue->vertices, number_of_commands * 4,
+                               queue->indices, number_of_commands * 6) == 0) {
+            queue->draw_calls++;
+            return;
+        }
+
+        // The renderer does not support geometry, so stop trying
+        queue->uses_geometry = false;
+    }
+#endif
+
+    for (int i=0; i<number_of_commands; i++) {
+        draw_command(queue, &commands[i]);
+    }
+}
+
+void flush_render_queue(RenderQueue *queue) {
+    /*
+     * A function that draws every queued command and empties the queue. It is
+     * called once the whole frame has been queued, right before presenting it.
+     *
+     * params
+     *      RenderQueue *queue
+     *          A pointer to the struct RenderQueue of the frame
+     */
+
+    qsort(queue->commands, queue->number_of_commands, sizeof(RenderCommand), compare_commands);
+
+    queue->draw_calls = 0;
+
+    int start = 0;
+    while (start < queue->number_of_commands) {
+        // Commands next to each other that use the same texture are drawn
+        // together, even across layers, since the batch keeps their order
+        int end = start + 1;
+        while (end < queue->number_of_commands && queue->commands[end].texture == queue->commands[start].texture)
+            end++;
+
+        draw_batch(queue, &queue->commands[start], end - start);
+        start = end;
+    }
+
+    queue->number_of_commands = 0;
+}
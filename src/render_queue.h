@@ -0,0 +1,26 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "declarations.h"
+
+RenderQueue* create_render_queue(SDL_Renderer *renderer);
+void destroy_render_queue(RenderQueue *queue);
+
+void queue_texture(RenderQueue *queue,
+                   enum RenderLayer layer,
+                   SDL_Texture *texture,
+                   SDL_Rect source,
+                   SDL_Rect destination,
+                   float rotation,
+                   SDL_RendererFlip flip
+                  );
+
+void queue_filled_rect(RenderQueue *queue,
+                       enum RenderLayer layer,
+                       SDL_Rect rect,
+                       SDL_Color color
+                      );
+
+void flush_render_queue(RenderQueue *queue);
+
+#endif // !RENDER_QUEUE_H
@@ -0,0 +1,438 @@
+/*
+ *  This file, `replay.c`, records the keys of a session, together with the
+ *  seeds of the boards they were played on, so that the session can be
+ *  played back exactly as it happened, e.g. to reproduce a bug or as a
+ *  workload to measure the game with.
+ *
+ *  format
+ *      A recording starts with REPLAY_MAGIC and REPLAY_VERSION, followed by
+ *      its records. Every record is one byte with its ReplayRecordType, the
+ *      milliseconds since the record before it, and its value, except for
+ *      REPLAY_RECORD_QUIT, which has none. The times and values are written
+ *      7 bits per byte, least significant first, with the high bit set on
+ *      every byte but the last, so that a key usually takes 3 bytes.
+ *
+ *  NOTE:
+ *      Nothing but the keys and the boards changes the state of the game, so
+ *      handing the same keys to `process_keypress` on the same boards arrives
+ *      at the same state, however fast they are played back. The seed of a
+ *      board is recorded, instead of the seed of the generators, since which
+ *      board the board worker has ready depends on timing. Every record is
+ *      written out right away, so that a recording survives a crash.
+ */
+
+#include "stdio.h"
+#include "stdbool.h"
+#include "string.h"
+#include "inttypes.h"
+
+#include "declarations.h"
+#include "replay.h"
+
+#include "SDL2/SDL.h"
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+static void write_varint(FILE *file, uint64_t value) {
+    while (value >= 0x80) {
+        fputc((int) (value & 0x7f) | 0x80, file);
+        value >>= 7;
+    }
+    fputc((int) value, file);
+}
+
+static bool read_varint(FILE *file, uint64_t *value) {
+    /*
+     * A helper function that reads a number written by `write_varint`.
+     *
+     * returns
+     *      false if the file ends before the number does
+     */
+
+    *value = 0;
+    for (int shift=0; shift<64; shift+=7) {
+        int byte = fgetc(file);
+        if (byte == EOF)
+            return false;
+
+        *value |= (uint64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static uint64_t hash_value(uint64_t hash, uint64_t value) {
+    /*
+     * A helper function that adds a value to an FNV-1a hash, a byte at a
+     * time from the least significant one, so that the hash is the same on
+     * every platform.
+     */
+
+    for (int i=0; i<8; i++) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t hash_state(const States *states, const Board *board) {
+    /*
+     * A helper function that hashes the state the keys decide, which a
+     * replay of the session must arrive at.
+     *
+     * NOTE:
+     *  The wrong input reminder is left out, since whether it is still
+     *  shown depends on how long ago it was.
+     */
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash = hash_value(hash, (uint64_t) states->player_state);
+    hash = hash_value(hash, (uint64_t) states->game_state);
+    hash = hash_value(hash, (uint64_t) states->current_menu_choice);
+    hash = hash_value(hash, (uint64_t) states->current_tutorial_page);
+    hash = hash_value(hash, (uint64_t) states->current_number_of_foods_picked);
+    hash = hash_value(hash, (uint64_t) states->show_quit_confirmation);
+    hash = hash_value(hash, (uint64_t) states->show_hint);
+    hash = hash_value(hash, (uint64_t) states->number_of_boards);
+
+    // The board is only set once the first game starts
+    if (states->number_of_boards == 0)
+        return hash;
+
+    hash = hash_value(hash, board->seed);
+    hash = hash_value(hash, (uint64_t) board->pacman_position.row);
+    hash = hash_value(hash, (uint64_t) board->pacman_position.col);
+    hash = hash_value(hash, (uint64_t) board->number_of_foods);
+    hash = hash_value(hash, (uint64_t) board->total_player_score);
+    hash = hash_value(hash, (uint64_t) board->number_of_moves);
+    for (int row=0; row<BOARD_SIZE; row++) {
+        for (int col=0; col<BOARD_SIZE; col++) {
+            hash = hash_value(hash, (uint64_t) board->array[row][col]);
+        }
+    }
+    return hash;
+}
+
+static Uint32 get_replay_time(const Replay *replay) {
+    return SDL_GetTicks() - replay->start;
+}
+
+void init_replay(Replay *replay) {
+    /*
+     * A function that sets up a session that is neither recorded nor
+     * played back.
+     */
+
+    replay->mode = REPLAY_OFF;
+    replay->is_fast = false;
+    replay->file = NULL;
+    replay->filename = NULL;
+    replay->has_started = false;
+    replay->start = 0;
+    replay->previous_time = 0;
+    replay->has_next = false;
+    replay->number_of_boards = 0;
+    replay->number_of_records = 0;
+}
+
+bool start_recording(Replay *replay, const char *filename) {
+    /*
+     * A function that starts recording the session to a file.
+     *
+     * params
+     *      Replay *replay
+     *          A pointer to the struct Replay, set up by `init_replay`
+     *      const char *filename
+     *          The file the recording is written to
+     * returns
+     *      false if the file cannot be written
+     */
+
+    replay->file = fopen(filename, "wb");
+    if (!replay->file) {
+        printf("Error recording the session to %s\n", filename);
+        return false;
+    }
+
+    fwrite(REPLAY_MAGIC, 1, REPLAY_MAGIC_LENGTH, replay->file);
+    fputc(REPLAY_VERSION & 0xff, replay->file);
+    fputc((REPLAY_VERSION >> 8) & 0xff, replay->file);
+
+    replay->mode = REPLAY_RECORDING;
+    replay->filename = filename;
+    return true;
+}
+
+static void read_next_record(Replay *replay) {
+    /*
+     * A helper function that reads the record that is played after the
+     * current one, if there is any.
+     */
+
+    replay->has_next = false;
+
+    int type = fgetc(replay->file);
+    if (type == EOF)
+        return;
+
+    uint64_t delta;
+    uint64_t value = 0;
+    bool is_complete = read_varint(replay->file, &delta);
+    if (is_complete && type != REPLAY_RECORD_QUIT)
+        is_complete = read_varint(replay->file, &value);
+
+    if (!is_complete || type > REPLAY_RECORD_END) {
+        printf("Error reading the recording %s: record %lu is corrupt\n", replay->filename, replay->number_of_records);
+        return;
+    }
+
+    replay->previous_time += (Uint32) delta;
+    replay->next.type = (enum ReplayRecordType) type;
+    replay->next.time = replay->previous_time;
+    replay->next.value = value;
+    replay->has_next = true;
+    replay->number_of_records++;
+}
+
+bool start_playing(Replay *replay, const char *filename, bool is_fast) {
+    /*
+     * A function that starts playing back a recording, in place of the keys
+     * of the player.
+     *
+     * params
+     *      Replay *replay
+     *          A pointer to the struct Replay, set up by `init_replay`
+     *      const char *filename
+     *          The file of the recording
+     *      bool is_fast
+     *          Whether to play back one key per frame as fast as possible,
+     *          instead of at the pace the keys were pressed at
+     * returns
+     *      false if the file cannot be read, or is not a recording of this
+     *      version
+     */
+
+    replay->file = fopen(filename, "rb");
+    if (!replay->file) {
+        printf("Error reading the recording %s\n", filename);
+        return false;
+    }
+
+    unsigned char header[REPLAY_MAGIC_LENGTH + 2];
+    if (fread(header, 1, sizeof(header), replay->file) != sizeof(header) ||
+        memcmp(header, REPLAY_MAGIC, REPLAY_MAGIC_LENGTH) != 0) {
+        printf("Error reading the recording %s: not a recording\n", filename);
+        fclose(replay->file);
+        replay->file = NULL;
+        return false;
+    }
+
+    int version = header[REPLAY_MAGIC_LENGTH] | (header[REPLAY_MAGIC_LENGTH + 1] << 8);
+    if (version != REPLAY_VERSION) {
+        printf("Error reading the recording %s: version %d is not supported\n", filename, version);
+        fclose(replay->file);
+        replay->file = NULL;
+        return false;
+    }
+
+    replay->mode = REPLAY_PLAYING;
+    replay->is_fast = is_fast;
+    replay->filename = filename;
+    read_next_record(replay);
+    return true;
+}
+
+void start_replay_clock(Replay *replay) {
+    /*
+     * A function that starts the time the records are timed from, once the
+     * menu is shown and the keys are handled. Only the first call counts.
+     */
+
+    if (replay->has_started)
+        return;
+
+    replay->has_started = true;
+    replay->start = SDL_GetTicks();
+}
+
+static void write_record(Replay *replay, enum ReplayRecordType type, uint64_t value) {
+    start_replay_clock(replay);
+    Uint32 time = get_replay_time(replay);
+
+    fputc((int) type, replay->file);
+    write_varint(replay->file, time - replay->previous_time);
+    if (type != REPLAY_RECORD_QUIT)
+        write_varint(replay->file, value);
+    fflush(replay->file);
+
+    replay->previous_time = time;
+    replay->number_of_records++;
+}
+
+void record_replay_key(Replay *replay, const States *states, const Board *board, SDL_Keycode key) {
+    /*
+     * A function that records a key that was handled by `process_keypress`.
+     *
+     * params
+     *      Replay *replay
+     *          A pointer to the struct Replay
+     *      const States *states
+     *          The states after the key was handled, which tell whether it
+     *          started a new game
+     *      const Board *board
+     *          The board after the key was handled
+     *      SDL_Keycode key
+     *          The key
+     *
+     * NOTE:
+     *  The seed of a board that was generated for the key is recorded first,
+     *  so that a replay asks for the same board before handing over the key.
+     */
+
+    if (replay->mode != REPLAY_RECORDING)
+        return;
+
+    if (states->number_of_boards != replay->number_of_boards) {
+        write_record(replay, REPLAY_RECORD_BOARD, board->seed);
+        replay->number_of_boards = states->number_of_boards;
+    }
+    write_record(replay, REPLAY_RECORD_KEY, (uint64_t) (Uint32) key);
+}
+
+void record_replay_quit(Replay *replay) {
+    /*
+     * A function that records that the window was closed.
+     */
+
+    if (replay->mode == REPLAY_RECORDING)
+        write_record(replay, REPLAY_RECORD_QUIT, 0);
+}
+
+static void check_final_state(const Replay *replay, const States *states, const Board *board, uint64_t recorded_hash) {
+    uint64_t hash = hash_state(states, board);
+    if (hash == recorded_hash)
+        printf("Replay of %s matches the recording after %lu records\n", replay->filename, replay->number_of_records);
+    else
+        printf("Replay of %s diverged from the recording: final state %016" PRIx64 ", recorded %016" PRIx64 "\n",
+               replay->filename, hash, recorded_hash);
+}
+
+static void stop_playing(Replay *replay, States *states) {
+    /*
+     * A helper function that closes the recording once it was played back.
+     * The player takes over, unless it was played back as fast as possible.
+     */
+
+    fclose(replay->file);
+    replay->file = NULL;
+    replay->mode = REPLAY_OFF;
+    if (replay->is_fast)
+        states->player_wants_to_quit = true;
+}
+
+bool take_replayed_event(Replay *replay, States *states, const Board *board, SDL_Event *event) {
+    /*
+     * A function that takes the next event of the recording, if it is due.
+     *
+     * params
+     *      Replay *replay
+     *          A pointer to the struct Replay
+     *      States *states
+     *          A pointer to the struct States, which is given the seed of
+     *          the board the next key starts a game on
+     *      const Board *board
+     *          The current board, which is checked at the end of the
+     *          recording
+     *      SDL_Event *event
+     *          Set to the key, or to the window being closed
+     * returns
+     *      true if an event is due, which must be handled like one from SDL
+     */
+
+    if (replay->mode != REPLAY_PLAYING)
+        return false;
+    start_replay_clock(replay);
+
+    while (replay->has_next) {
+        ReplayRecord record = replay->next;
+        if (!replay->is_fast && get_replay_time(replay) < record.time)
+            return false;
+        read_next_record(replay);
+
+        switch (record.type) {
+            case REPLAY_RECORD_BOARD:
+                // The key after it generates the board, see `init_board`
+                states->requested_seed = record.value;
+                states->has_requested_seed = true;
+                break;
+            case REPLAY_RECORD_KEY:
+                memset(event, 0, sizeof(SDL_Event));
+                event->type = SDL_KEYDOWN;
+                event->key.type = SDL_KEYDOWN;
+                event->key.state = SDL_PRESSED;
+                event->key.timestamp = SDL_GetTicks();
+                event->key.keysym.sym = (SDL_Keycode) (Uint32) record.value;
+                return true;
+            case REPLAY_RECORD_QUIT:
+                memset(event, 0, sizeof(SDL_Event));
+                event->type = SDL_QUIT;
+                event->quit.timestamp = SDL_GetTicks();
+                return true;
+            case REPLAY_RECORD_END:
+                check_final_state(replay, states, board, record.value);
+                stop_playing(replay, states);
+                return false;
+        }
+    }
+
+    printf("Replay of %s ended without its final state, after %lu records\n", replay->filename, replay->number_of_records);
+    stop_playing(replay, states);
+    return false;
+}
+
+Uint32 get_replay_timeout(const Replay *replay, Uint32 timeout) {
+    /*
+     * A function that shortens how long the main loop may wait for an
+     * event, so that it wakes up once the next key of the recording is due.
+     */
+
+    if (replay->mode != REPLAY_PLAYING || !replay->has_started || !replay->has_next)
+        return timeout;
+    if (replay->is_fast)
+        return 0;
+
+    Uint32 now = get_replay_time(replay);
+    if (replay->next.time <= now)
+        return 0;
+    return replay->next.time - now < timeout ? replay->next.time - now : timeout;
+}
+
+void stop_replay(Replay *replay, const States *states, const Board *board) {
+    /*
+     * A function that finishes the recording with a hash of the final
+     * state, or checks the final state of a replay that was quit by its own
+     * keys.
+     */
+
+    switch (replay->mode) {
+        case REPLAY_RECORDING:
+            write_record(replay, REPLAY_RECORD_END, hash_state(states, board));
+            fclose(replay->file);
+            printf("Recorded %lu records to %s\n", replay->number_of_records, replay->filename);
+            break;
+        case REPLAY_PLAYING:
+            if (replay->has_next && replay->next.type == REPLAY_RECORD_END)
+                check_final_state(replay, states, board, replay->next.value);
+            else
+                printf("Replay of %s was stopped before its end\n", replay->filename);
+            fclose(replay->file);
+            break;
+        case REPLAY_OFF:
+            return;
+    }
+
+    replay->file = NULL;
+    replay->mode = REPLAY_OFF;
+}
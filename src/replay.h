@@ -0,0 +1,24 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "declarations.h"
+
+void init_replay(Replay *replay);
+
+bool start_recording(Replay *replay, const char *filename);
+
+bool start_playing(Replay *replay, const char *filename, bool is_fast);
+
+void start_replay_clock(Replay *replay);
+
+void record_replay_key(Replay *replay, const States *states, const Board *board, SDL_Keycode key);
+
+void record_replay_quit(Replay *replay);
+
+bool take_replayed_event(Replay *replay, States *states, const Board *board, SDL_Event *event);
+
+Uint32 get_replay_timeout(const Replay *replay, Uint32 timeout);
+
+void stop_replay(Replay *replay, const States *states, const Board *board);
+
+#endif // !REPLAY_H
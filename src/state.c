@@ -6,7 +6,11 @@
 #include "stdio.h"
 #include "stdbool.h"
 
+#include "assets.h"
+#include "render_queue.h"
+#include "texture_cache.h"
 #include "utils.h"
+#include "voices.h"
 #include "declarations.h"
 #include "logic.h"
 
@@ -33,6 +37,16 @@ void render_state(States* states, Board *board, Assets *assets) {
      *             used in the application.
      */
 
+    // The atlas pages drawn from here on are kept until the next frame
+    begin_texture_cache_frame(&assets->texture_cache);
+
+    // Nothing of the menu can be shown until its images are loaded
+    if (!is_menu_ready(assets)) {
+        render_loading_indicator(assets);
+        flush_render_queue(assets->render_queue);
+        return;
+    }
+
     // Sprite is a struct that holds several variables
     Sprite *about_screen                 = &assets->misc.about_screen;
     Sprite *game_lost_hit_block          = &assets->prompt.game_lost_hit_block;
@@ -114,21 +128,26 @@ void render_state(States* states, Board *board, Assets *assets) {
                 case GAME_WON:
                     render_sprite(game_won);
                     render_sprite(&score_visuals[board->total_player_score]);
+                    render_par(board, assets);
                     break;
                 case GAME_LOST_HIT_BLOCK:
                     render_sprite(game_lost_hit_block);
                     render_sprite(&score_visuals[board->total_player_score]);
+                    render_par(board, assets);
                     break;
                 case GAME_LOST_HIT_BORDER:
                     render_sprite(game_lost_hit_border);
                     render_sprite(&score_visuals[board->total_player_score]);
+                    render_par(board, assets);
                     break;
                 case GAME_LOST_INSUFFICIENT_FOOD:
                     render_sprite(game_lost_insufficient_food);
                     render_sprite(&score_visuals[board->total_player_score]);
+                    render_par(board, assets);
                     break;
                 case GAME_IN_PROGRESS:
                     render_board(board, assets);
+                    render_hint(board, assets, states);
                     render_sprite(&score_visuals[board->total_player_score]);
                     break;
             }
@@ -141,22 +160,22 @@ void render_state(States* states, Board *board, Assets *assets) {
         case WRONG_INPUT_NONE:
             break;
         case WRONG_INPUT_IN_ABOUT_GAME:
-            render_reminder(wrong_input_in_about_game, states, 3000, 535, 10);
+            render_reminder(wrong_input_in_about_game, states, REMINDER_DURATION, 535, 10);
             break;
         case WRONG_INPUT_IN_GAME:
-            render_reminder(wrong_input_in_game, states, 3000, 535, 10);
+            render_reminder(wrong_input_in_game, states, REMINDER_DURATION, 535, 10);
             break;
         case WRONG_INPUT_IN_TUTORIAL:
-            render_reminder(wrong_input_in_tutorial, states, 3000, 535, 10);
+            render_reminder(wrong_input_in_tutorial, states, REMINDER_DURATION, 535, 10);
             break;
         case WRONG_INPUT_IN_FOOD_INPUT:
-            render_reminder(wrong_input_in_food_input, states, 3000, 535, 10);
+            render_reminder(wrong_input_in_food_input, states, REMINDER_DURATION, 535, 10);
             break;
         case WRONG_INPUT_IN_MENU:
-            render_reminder(wrong_input_in_menu, states, 3000, 535, 10);
+            render_reminder(wrong_input_in_menu, states, REMINDER_DURATION, 535, 10);
             break;
         case WRONG_INPUT_IN_GAME_PROMPTS:
-            render_reminder(wrong_input_in_game_prompts, states, 3000, 535, 10);
+            render_reminder(wrong_input_in_game_prompts, states, REMINDER_DURATION, 535, 10);
             break;
     }
 
@@ -168,6 +187,222 @@ void render_state(States* states, Board *board, Assets *assets) {
         // confirmation prompt is shown in the screen.
         states->wrong_input_state = WRONG_INPUT_NONE;
     };
+
+    // The rest of the assets are still loading behind the current screen
+    if (!are_all_assets_loaded(assets))
+        render_loading_indicator(assets);
+
+    // Everything above was only queued, so draw it all at once
+    flush_render_queue(assets->render_queue);
+}
+
+/*
+ * InputScreenSettings tells what a key that is not bound on a screen does.
+ */
+typedef struct InputScreenSettings {
+    // The reminder that is shown, or WRONG_INPUT_NONE to ignore the key
+    enum WrongInputState     wrong_input;
+    bool                     plays_wrong_input_sound;
+    // Whether every key sends the tutorial back to its first page
+    bool                     resets_tutorial_page;
+} InputScreenSettings;
+
+static const InputScreenSettings INPUT_SCREEN_SETTINGS[NUMBER_OF_INPUT_SCREENS] = {
+    // Only `y` and `n` answer the quit confirmation, and every other key is
+    // ignored
+    [INPUT_SCREEN_QUIT_CONFIRMATION] = {WRONG_INPUT_NONE,               false,  false},
+    [INPUT_SCREEN_MENU]              = {WRONG_INPUT_IN_MENU,            true,   true},
+    [INPUT_SCREEN_TUTORIAL]          = {WRONG_INPUT_IN_TUTORIAL,        true,   false},
+    [INPUT_SCREEN_ABOUT]             = {WRONG_INPUT_IN_ABOUT_GAME,      true,   false},
+    [INPUT_SCREEN_FOOD_INPUT]        = {WRONG_INPUT_IN_FOOD_INPUT,      true,   false},
+    [INPUT_SCREEN_GAME]              = {WRONG_INPUT_IN_GAME,            true,   false},
+    [INPUT_SCREEN_GAME_OVER]         = {WRONG_INPUT_IN_GAME_PROMPTS,    false,  false},
+};
+
+#define KEY(key) INPUT_KEY_INDEX(key)
+
+// NOTE:
+//  SDLK_`x` refers to a keypress on the key `x`, while SDLK_KP_`x` refers to
+//  a keypress on the key `x` that is located on the "keypad". This is why
+//  the numbers are bound twice on the menu and the food input prompt.
+static const InputAction INPUT_ACTIONS[NUMBER_OF_INPUT_SCREENS][NUMBER_OF_INPUT_KEYS] = {
+    [INPUT_SCREEN_QUIT_CONFIRMATION] = {
+        [KEY(SDLK_y)]       = {INPUT_ACTION_QUIT, 0},
+        [KEY(SDLK_n)]       = {INPUT_ACTION_CANCEL_QUIT, 0},
+    },
+    [INPUT_SCREEN_MENU] = {
+        [KEY(SDLK_1)]       = {INPUT_ACTION_CHOOSE_MENU_OPTION, PLAYER_CHOSE_START},
+        [KEY(SDLK_KP_1)]    = {INPUT_ACTION_CHOOSE_MENU_OPTION, PLAYER_CHOSE_START},
+        [KEY(SDLK_2)]       = {INPUT_ACTION_CHOOSE_MENU_OPTION, PLAYER_CHOSE_TUTORIAL},
+        [KEY(SDLK_KP_2)]    = {INPUT_ACTION_CHOOSE_MENU_OPTION, PLAYER_CHOSE_TUTORIAL},
+        [KEY(SDLK_3)]       = {INPUT_ACTION_CHOOSE_MENU_OPTION, PLAYER_CHOSE_EXIT},
+        [KEY(SDLK_KP_3)]    = {INPUT_ACTION_CHOOSE_MENU_OPTION, PLAYER_CHOSE_EXIT},
+        [KEY(SDLK_a)]       = {INPUT_ACTION_CHOOSE_MENU_OPTION, PLAYER_CHOSE_ABOUT},
+        [KEY(SDLK_RETURN)]  = {INPUT_ACTION_CONFIRM_MENU_CHOICE, 0},
+    },
+    [INPUT_SCREEN_TUTORIAL] = {
+        [KEY(SDLK_RIGHT)]   = {INPUT_ACTION_NEXT_PAGE, 0},
+        [KEY(SDLK_LEFT)]    = {INPUT_ACTION_PREVIOUS_PAGE, 0},
+        [KEY(SDLK_m)]       = {INPUT_ACTION_OPEN_MENU, 0},
+        [KEY(SDLK_1)]       = {INPUT_ACTION_OPEN_GAME, 0},
+        [KEY(SDLK_x)]       = {INPUT_ACTION_ASK_TO_QUIT, 0},
+    },
+    [INPUT_SCREEN_ABOUT] = {
+        [KEY(SDLK_m)]       = {INPUT_ACTION_OPEN_MENU, 0},
+    },
+    [INPUT_SCREEN_FOOD_INPUT] = {
+        [KEY(SDLK_2)]       = {INPUT_ACTION_PICK_FOODS, 2},
+        [KEY(SDLK_KP_2)]    = {INPUT_ACTION_PICK_FOODS, 2},
+        [KEY(SDLK_3)]       = {INPUT_ACTION_PICK_FOODS, 3},
+        [KEY(SDLK_KP_3)]    = {INPUT_ACTION_PICK_FOODS, 3},
+        [KEY(SDLK_4)]       = {INPUT_ACTION_PICK_FOODS, 4},
+        [KEY(SDLK_KP_4)]    = {INPUT_ACTION_PICK_FOODS, 4},
+        [KEY(SDLK_5)]       = {INPUT_ACTION_PICK_FOODS, 5},
+        [KEY(SDLK_KP_5)]    = {INPUT_ACTION_PICK_FOODS, 5},
+        [KEY(SDLK_6)]       = {INPUT_ACTION_PICK_FOODS, 6},
+        [KEY(SDLK_KP_6)]    = {INPUT_ACTION_PICK_FOODS, 6},
+        [KEY(SDLK_7)]       = {INPUT_ACTION_PICK_FOODS, 7},
+        [KEY(SDLK_KP_7)]    = {INPUT_ACTION_PICK_FOODS, 7},
+        [KEY(SDLK_8)]       = {INPUT_ACTION_PICK_FOODS, 8},
+        [KEY(SDLK_KP_8)]    = {INPUT_ACTION_PICK_FOODS, 8},
+        [KEY(SDLK_9)]       = {INPUT_ACTION_PICK_FOODS, 9},
+        [KEY(SDLK_KP_9)]    = {INPUT_ACTION_PICK_FOODS, 9},
+        [KEY(SDLK_m)]       = {INPUT_ACTION_LEAVE_FOOD_INPUT, 0},
+        [KEY(SDLK_RETURN)]  = {INPUT_ACTION_START_GAME, 0},
+    },
+    [INPUT_SCREEN_GAME] = {
+        [KEY(SDLK_w)]       = {INPUT_ACTION_MOVE_PACMAN, MOVE_PACMAN_UP},
+        [KEY(SDLK_a)]       = {INPUT_ACTION_MOVE_PACMAN, MOVE_PACMAN_LEFT},
+        [KEY(SDLK_s)]       = {INPUT_ACTION_MOVE_PACMAN, MOVE_PACMAN_DOWN},
+        [KEY(SDLK_d)]       = {INPUT_ACTION_MOVE_PACMAN, MOVE_PACMAN_RIGHT},
+        [KEY(SDLK_h)]       = {INPUT_ACTION_SHOW_HINT, 0},
+        [KEY(SDLK_m)]       = {INPUT_ACTION_LEAVE_GAME, 0},
+        [KEY(SDLK_x)]       = {INPUT_ACTION_ASK_TO_QUIT, 0},
+    },
+    // Winning and every way of losing show the same prompts
+    [INPUT_SCREEN_GAME_OVER] = {
+        [KEY(SDLK_r)]       = {INPUT_ACTION_PLAY_AGAIN, 0},
+        [KEY(SDLK_m)]       = {INPUT_ACTION_LEAVE_GAME, 0},
+        [KEY(SDLK_x)]       = {INPUT_ACTION_ASK_TO_QUIT, 0},
+    },
+};
+
+#define SCREEN(screen) (1u << (screen))
+
+// The screens every action may be bound on, which `check_input_actions`
+// holds the table to
+static const unsigned int INPUT_ACTION_SCREENS[NUMBER_OF_INPUT_ACTIONS] = {
+    [INPUT_ACTION_WRONG_INPUT]          = SCREEN(NUMBER_OF_INPUT_SCREENS) - 1,
+    [INPUT_ACTION_QUIT]                 = SCREEN(INPUT_SCREEN_QUIT_CONFIRMATION),
+    [INPUT_ACTION_CANCEL_QUIT]          = SCREEN(INPUT_SCREEN_QUIT_CONFIRMATION),
+    [INPUT_ACTION_ASK_TO_QUIT]          = SCREEN(INPUT_SCREEN_TUTORIAL) | SCREEN(INPUT_SCREEN_GAME) |
+                                          SCREEN(INPUT_SCREEN_GAME_OVER),
+    [INPUT_ACTION_CHOOSE_MENU_OPTION]   = SCREEN(INPUT_SCREEN_MENU),
+    [INPUT_ACTION_CONFIRM_MENU_CHOICE]  = SCREEN(INPUT_SCREEN_MENU),
+    [INPUT_ACTION_NEXT_PAGE]            = SCREEN(INPUT_SCREEN_TUTORIAL),
+    [INPUT_ACTION_PREVIOUS_PAGE]        = SCREEN(INPUT_SCREEN_TUTORIAL),
+    [INPUT_ACTION_OPEN_MENU]            = SCREEN(INPUT_SCREEN_TUTORIAL) | SCREEN(INPUT_SCREEN_ABOUT),
+    [INPUT_ACTION_OPEN_GAME]            = SCREEN(INPUT_SCREEN_TUTORIAL),
+    [INPUT_ACTION_PICK_FOODS]           = SCREEN(INPUT_SCREEN_FOOD_INPUT),
+    [INPUT_ACTION_START_GAME]           = SCREEN(INPUT_SCREEN_FOOD_INPUT),
+    [INPUT_ACTION_LEAVE_FOOD_INPUT]     = SCREEN(INPUT_SCREEN_FOOD_INPUT),
+    [INPUT_ACTION_MOVE_PACMAN]          = SCREEN(INPUT_SCREEN_GAME),
+    [INPUT_ACTION_SHOW_HINT]            = SCREEN(INPUT_SCREEN_GAME),
+    [INPUT_ACTION_PLAY_AGAIN]           = SCREEN(INPUT_SCREEN_GAME_OVER),
+    [INPUT_ACTION_LEAVE_GAME]           = SCREEN(INPUT_SCREEN_GAME) | SCREEN(INPUT_SCREEN_GAME_OVER),
+};
+
+static enum InputScreen get_input_screen(const States *states) {
+    /*
+     * A helper function that returns the screen that handles the keys.
+     */
+
+    if (states->show_quit_confirmation)
+        return INPUT_SCREEN_QUIT_CONFIRMATION;
+
+    switch (states->player_state) {
+        case PLAYER_IN_MENU:
+            return INPUT_SCREEN_MENU;
+        case PLAYER_IN_TUTORIAL:
+            return INPUT_SCREEN_TUTORIAL;
+        case PLAYER_IN_ABOUT:
+            return INPUT_SCREEN_ABOUT;
+        case PLAYER_IN_GAME:
+            break;
+    }
+
+    switch (states->game_state) {
+        case GAME_IN_FOOD_NUMBER_INPUT:
+            return INPUT_SCREEN_FOOD_INPUT;
+        case GAME_IN_PROGRESS:
+            return INPUT_SCREEN_GAME;
+        default:
+            return INPUT_SCREEN_GAME_OVER;
+    }
+}
+
+static InputAction get_input_action(enum InputScreen screen, SDL_Keycode key) {
+    /*
+     * A helper function that looks up what a key does on a screen. The keys
+     * that have no index, such as letters of other alphabets, are never
+     * bound.
+     */
+
+    if (key < 0 || (!(key & SDLK_SCANCODE_MASK) && key >= NUMBER_OF_CHARACTER_KEYS) ||
+        ((key & SDLK_SCANCODE_MASK) && (key & ~SDLK_SCANCODE_MASK) >= SDL_NUM_SCANCODES)) {
+        InputAction wrong_input = {.type=INPUT_ACTION_WRONG_INPUT, .argument=0};
+        return wrong_input;
+    }
+    return INPUT_ACTIONS[screen][INPUT_KEY_INDEX(key)];
+}
+
+static void confirm_menu_choice(States *states, Assets *assets) {
+    /*
+     * A helper function that opens the option chosen in the menu. This
+     * allows the player to change the chosen option, even after pressing
+     * some other number previously.
+     */
+
+    switch (states->current_menu_choice) {
+        case PLAYER_CHOSE_ABOUT:
+            play_sound(assets, SOUND_OPEN_ABOUT_GAME);
+            states->player_state = PLAYER_IN_ABOUT;
+            break;
+        case PLAYER_CHOSE_TUTORIAL:
+            play_sound(assets, SOUND_OPTION_CONFIRM);
+            states->player_state = PLAYER_IN_TUTORIAL;
+            break;
+        case PLAYER_CHOSE_START:
+            play_sound(assets, SOUND_OPTION_CONFIRM);
+            states->player_state = PLAYER_IN_GAME;
+            break;
+        case PLAYER_CHOSE_EXIT:
+            states->show_quit_confirmation = true;
+            break;
+        case PLAYER_CHOSE_NONE:
+            break;
+    }
+    // Reset menu choice selection
+    states->current_menu_choice = PLAYER_CHOSE_NONE;
+}
+
+static void start_game(States *states, Board *board, Assets *assets) {
+    /*
+     * A helper function that starts a game with the number of foods the
+     * player picked. Pressing enter without picking one, or when no board
+     * could be generated, shows the wrong input reminder instead.
+     */
+
+    if (states->current_number_of_foods_picked != 1 && init_board(board, assets, states)) {
+        states->game_state = GAME_IN_PROGRESS;
+        play_sound(assets, SOUND_START_GAME);
+    } else {
+        states->wrong_input_state = WRONG_INPUT_IN_FOOD_INPUT;
+        states->wrong_input_time = SDL_GetTicks();
+        play_sound(assets, SOUND_GAME_NOTIFICATION);
+    }
+    // Reset the number of current foods picked
+    states->current_number_of_foods_picked = 1;
 }
 
 void process_keypress(SDL_Event event, States *states, Board* board, Assets* assets) {
@@ -189,295 +424,290 @@ void process_keypress(SDL_Event event, States *states, Board* board, Assets* ass
      *       Assets *assets
      *             A pointer to the struct `Assets`, which holds all the images or sounds
      *             used in the game.
+     *
+     *   NOTE:
+     *       What every key does on every screen is looked up in INPUT_ACTIONS,
+     *       so a key is handled with a single lookup, however many keys and
+     *       screens there are.
      */
-    bool is_not_on_the_last_slide   = states->current_tutorial_page != NUMBER_OF_PAGES_IN_TUTORIAL - 1;
-    bool is_not_on_the_first_slide  = states->current_tutorial_page != 0;
 
-    enum PlayerState player_state               = states->player_state;
-    enum GameState game_state                   = states->game_state;
-    enum MenuChoiceState current_menu_choice    = states->current_menu_choice;
+    enum InputScreen screen = get_input_screen(states);
+    InputAction action = get_input_action(screen, event.key.keysym.sym);
+    const InputScreenSettings *settings = &INPUT_SCREEN_SETTINGS[screen];
+
+    switch ((enum InputActionType) action.type) {
+        case INPUT_ACTION_WRONG_INPUT:
+            if (settings->plays_wrong_input_sound)
+                play_sound(assets, SOUND_GAME_NOTIFICATION);
+            if (settings->wrong_input != WRONG_INPUT_NONE) {
+                states->wrong_input_state = settings->wrong_input;
+                states->wrong_input_time = SDL_GetTicks();
+            }
+            break;
+        case INPUT_ACTION_QUIT:
+            states->player_wants_to_quit = true;
+            break;
+        case INPUT_ACTION_CANCEL_QUIT:
+            states->show_quit_confirmation = false;
+            break;
+        case INPUT_ACTION_ASK_TO_QUIT:
+            play_sound(assets, SOUND_QUIT);
+            states->show_quit_confirmation = true;
+            break;
+        case INPUT_ACTION_CHOOSE_MENU_OPTION:
+            play_sound(assets, SOUND_OPTION_SELECT);
+            states->current_menu_choice = (enum MenuChoiceState) action.argument;
+            break;
+        case INPUT_ACTION_CONFIRM_MENU_CHOICE:
+            confirm_menu_choice(states, assets);
+            break;
+        case INPUT_ACTION_NEXT_PAGE:
+            // The step is heard even on the last page
+            if (states->current_tutorial_page != NUMBER_OF_PAGES_IN_TUTORIAL - 1)
+                states->current_tutorial_page += 1;
+            play_sound(assets, SOUND_PACMAN_STEP);
+            break;
+        case INPUT_ACTION_PREVIOUS_PAGE:
+            if (states->current_tutorial_page != 0)
+                states->current_tutorial_page -= 1;
+            play_sound(assets, SOUND_PACMAN_STEP);
+            break;
+        case INPUT_ACTION_OPEN_MENU:
+            play_sound(assets, SOUND_OPTION_CONFIRM);
+            states->player_state = PLAYER_IN_MENU;
+            break;
+        case INPUT_ACTION_OPEN_GAME:
+            play_sound(assets, SOUND_OPTION_CONFIRM);
+            states->player_state = PLAYER_IN_GAME;
+            break;
+        case INPUT_ACTION_PICK_FOODS:
+            play_sound(assets, SOUND_OPTION_SELECT);
+            states->current_number_of_foods_picked = action.argument;
+            break;
+        case INPUT_ACTION_START_GAME:
+            start_game(states, board, assets);
+            break;
+        case INPUT_ACTION_LEAVE_FOOD_INPUT:
+            play_sound(assets, SOUND_OPTION_CONFIRM);
+            states->player_state = PLAYER_IN_MENU;
+            states->current_number_of_foods_picked = 1;
+            break;
+        case INPUT_ACTION_MOVE_PACMAN:
+            move_pacman((enum PacmanMove) action.argument, assets, board, states);
+            break;
+        case INPUT_ACTION_SHOW_HINT:
+            if (show_hint(board, states))
+                play_sound(assets, SOUND_OPTION_SELECT);
+            else
+                play_sound(assets, SOUND_GAME_NOTIFICATION);
+            break;
+        case INPUT_ACTION_PLAY_AGAIN:
+            play_sound(assets, SOUND_OPTION_SELECT);
+            states->player_state = PLAYER_IN_GAME;
+            states->game_state = GAME_IN_FOOD_NUMBER_INPUT;
+            break;
+        case INPUT_ACTION_LEAVE_GAME:
+            play_sound(assets, SOUND_OPTION_SELECT);
+            states->player_state = PLAYER_IN_MENU;
+            states->game_state = GAME_IN_FOOD_NUMBER_INPUT;
+            break;
+        case NUMBER_OF_INPUT_ACTIONS:
+            break;
+    }
 
-    SDL_Keycode player_keypress     = event.key.keysym.sym;
+    if (settings->resets_tutorial_page)
+        states->current_tutorial_page = 0;
+}
 
-    // The following if-statement handles the state when the exit prompt is
-    // shown in the screen.
-    if (states->show_quit_confirmation) {
-        switch (player_keypress) {
-            case SDLK_n:
-                states->show_quit_confirmation = false;
-                break;
-            case SDLK_y:
-                states->player_wants_to_quit = true;
-                break;
+static bool is_input_argument_valid(InputAction action) {
+    switch ((enum InputActionType) action.type) {
+        case INPUT_ACTION_CHOOSE_MENU_OPTION:
+            return action.argument < PLAYER_CHOSE_NONE;
+        case INPUT_ACTION_PICK_FOODS:
+            return action.argument >= MIN_NUMBER_OF_FOOD && action.argument <= MAX_NUMBER_OF_FOOD;
+        case INPUT_ACTION_MOVE_PACMAN:
+            return action.argument <= MOVE_PACMAN_RIGHT;
+        default:
+            return action.argument == 0;
+    }
+}
+
+static bool is_input_action_bound(enum InputScreen screen, enum InputActionType type, int argument) {
+    for (int key=0; key<NUMBER_OF_INPUT_KEYS; key++) {
+        if (INPUT_ACTIONS[screen][key].type == type && INPUT_ACTIONS[screen][key].argument == argument)
+            return true;
+    }
+    return false;
+}
+
+bool check_input_actions(void) {
+    /*
+     * A function that checks that the table of input actions is consistent,
+     * i.e. every action is only bound on the screens it is meant for, with
+     * a valid argument, and complete, i.e. every number of foods, move and
+     * menu option has a key, and the quit confirmation can be answered.
+     *
+     * returns
+     *      false if the table has a mistake, which is printed
+     */
+
+    bool is_valid = true;
+    for (int screen=0; screen<NUMBER_OF_INPUT_SCREENS; screen++) {
+        for (int key=0; key<NUMBER_OF_INPUT_KEYS; key++) {
+            InputAction action = INPUT_ACTIONS[screen][key];
+            if (action.type >= NUMBER_OF_INPUT_ACTIONS || !(INPUT_ACTION_SCREENS[action.type] & SCREEN(screen))) {
+                printf("Error in the input actions: action %d is bound on screen %d, key %d\n", action.type, screen, key);
+                is_valid = false;
+            } else if (!is_input_argument_valid(action)) {
+                printf("Error in the input actions: action %d on screen %d, key %d has the argument %d\n",
+                       action.type, screen, key, action.argument);
+                is_valid = false;
+            }
         }
-        // Early return ensures that the application will ignore every other 
-        // keypress aside from `n` and `y` when the quit confirmation prompt
-        // is shown in the screen.
-        return;
     }
 
-    // NOTE:
-    // SDLK_`x` refers to a keypress on the key `x`, while SDLK_KP_`x` refers
-    // to a keypress on the key `x` that is located on the "keypad". This is
-    // the reason why there is a double case to the switch statements
-    // when the player is on the food input prompt.
+    bool is_complete = is_input_action_bound(INPUT_SCREEN_QUIT_CONFIRMATION, INPUT_ACTION_QUIT, 0) &&
+                       is_input_action_bound(INPUT_SCREEN_QUIT_CONFIRMATION, INPUT_ACTION_CANCEL_QUIT, 0) &&
+                       is_input_action_bound(INPUT_SCREEN_FOOD_INPUT, INPUT_ACTION_START_GAME, 0) &&
+                       is_input_action_bound(INPUT_SCREEN_MENU, INPUT_ACTION_CONFIRM_MENU_CHOICE, 0);
+    for (int foods=MIN_NUMBER_OF_FOOD; foods<=MAX_NUMBER_OF_FOOD; foods++) {
+        is_complete &= is_input_action_bound(INPUT_SCREEN_FOOD_INPUT, INPUT_ACTION_PICK_FOODS, foods);
+    }
+    for (int move=MOVE_PACMAN_UP; move<=MOVE_PACMAN_RIGHT; move++) {
+        is_complete &= is_input_action_bound(INPUT_SCREEN_GAME, INPUT_ACTION_MOVE_PACMAN, move);
+    }
+    for (int choice=PLAYER_CHOSE_START; choice<PLAYER_CHOSE_NONE; choice++) {
+        is_complete &= is_input_action_bound(INPUT_SCREEN_MENU, INPUT_ACTION_CHOOSE_MENU_OPTION, choice);
+    }
+    if (!is_complete) {
+        printf("Error in the input actions: a number of foods, a move, a menu option or an answer has no key\n");
+        is_valid = false;
+    }
+    return is_valid;
+}
 
-    // NOTE:
-    // The copious amount of switch statements were due to the fact that the application
-    // had to take into consideration the different `states` that occur throughout the runtime
-    // of the application. These `states` listen to different keys, so there is a need
-    // to separate them.
+static Sprite* get_reminder_sprite(States *states, Assets *assets) {
+    /*
+     * A helper function that returns the reminder shown for the current
+     * wrong input, or NULL if there is none.
+     */
 
-    switch (player_state) {
-        case PLAYER_IN_GAME:
-            switch (game_state) {
-                case GAME_IN_FOOD_NUMBER_INPUT:
-                    // This case specifies that the player inputs a number from 2 to 9
-                    // as the desired number of food pieces on the game. An option to return
-                    // to menu is also offered by pressing 'M'. Otherwise, a wrong input
-                    // reminder will be shown.
-                    switch (player_keypress) {
-                        case SDLK_2:
-                        case SDLK_KP_2:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 2;
-                            break;
-                        case SDLK_3:
-                        case SDLK_KP_3:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 3;
-                            break;
-                        case SDLK_4:
-                        case SDLK_KP_4:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 4;
-                            break;
-                        case SDLK_5:
-                        case SDLK_KP_5:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 5;
-                            break;
-                        case SDLK_6:
-                        case SDLK_KP_6:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 6;
-                            break;
-                        case SDLK_7:
-                        case SDLK_KP_7:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 7;
-                            break;
-                        case SDLK_8:
-                        case SDLK_KP_8:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 8;
-                            break;
-                        case SDLK_9:
-                        case SDLK_KP_9:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->current_number_of_foods_picked = 9;
-                            break;
-                        case SDLK_m:
-                            Mix_PlayChannel(1, assets->sounds.option_confirm, 0);
-                            states->player_state = PLAYER_IN_MENU;
-                            states->current_number_of_foods_picked = 1;
-                            break;
-                        case SDLK_RETURN:
-                            // The following if-else statement handles when the
-                            // user presses enter without entering their desired food number.
-                            if (states->current_number_of_foods_picked != 1) {
-
-                                init_board(board, assets, states->current_number_of_foods_picked);
-                                states->game_state = GAME_IN_PROGRESS;
-                                Mix_PlayChannel(1, assets->sounds.start_game, 0);
-
-                            } else {
-
-                                states->wrong_input_state = WRONG_INPUT_IN_FOOD_INPUT;
-                                states->wrong_input_time = SDL_GetTicks();
-                                Mix_PlayChannel(-1, assets->sounds.game_notification, 0);
-                            }
-                            // Reset the number of current foods picked
-                            states->current_number_of_foods_picked = 1;
-                            break;
-                        default:
-                            // Play the wrong input sound and register a wrong key state
-                            Mix_PlayChannel(-1, assets->sounds.game_notification, 0);
-                            states->wrong_input_state = WRONG_INPUT_IN_FOOD_INPUT;
-                            states->wrong_input_time = SDL_GetTicks();
-                            break;
-                    }
-                    break;
-                case GAME_IN_PROGRESS:
-                    // This case is associated with the accepted keypresses during the actual game.
-                    // That is, 'W' to move up, 'S' to move down, 'A' to move left, and 'D' to move
-                    // right. Also, options to return to menu and to exit the game can be done by
-                    // pressing 'M' or pressing 'X' respectively. Keypresses other than these would
-                    // trigger a wrong input reminder.
-                    switch (player_keypress) {
-                        case SDLK_w:
-                            move_pacman(MOVE_PACMAN_UP, assets, board, states);
-                            break;
-                        case SDLK_a:
-                            move_pacman(MOVE_PACMAN_LEFT, assets, board, states);
-                            break;
-                        case SDLK_s:
-                            move_pacman(MOVE_PACMAN_DOWN, assets, board, states);
-                            break;
-                        case SDLK_d:
-                            move_pacman(MOVE_PACMAN_RIGHT, assets, board, states);
-                            break;
-                        case SDLK_m:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->player_state = PLAYER_IN_MENU;
-                            states->game_state = GAME_IN_FOOD_NUMBER_INPUT;
-                            break;
-                        case SDLK_x:
-                            Mix_PlayChannel(0, assets->sounds.quit_sound, 0);
-                            states->show_quit_confirmation = true;
-                            break;
-                        default:
-                            Mix_PlayChannel(0, assets->sounds.game_notification, 0);
-                            states->wrong_input_state = WRONG_INPUT_IN_GAME;
-                            states->wrong_input_time = SDL_GetTicks();
-                            break;
-                        }
-                    break;
-                // The following `game_states` all listen to the same
-                // keypresses, that's why they are grouped to avoid
-                // code duplication.
-                case GAME_LOST_INSUFFICIENT_FOOD:
-                case GAME_LOST_HIT_BORDER:
-                case GAME_LOST_HIT_BLOCK:
-                case GAME_WON:
-                    switch (player_keypress) {
-                        case SDLK_r:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->player_state = PLAYER_IN_GAME;
-                            states->game_state = GAME_IN_FOOD_NUMBER_INPUT;
-                            break;
-                        case SDLK_m:
-                            Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                            states->player_state = PLAYER_IN_MENU;
-                            states->game_state = GAME_IN_FOOD_NUMBER_INPUT;
-                            break;
-                        case SDLK_x:
-                            states->show_quit_confirmation = true;
-                            Mix_PlayChannel(0, assets->sounds.quit_sound, 0);
-                            break;
-                        default:
-                            states->wrong_input_state = WRONG_INPUT_IN_GAME_PROMPTS;
-                            states->wrong_input_time = SDL_GetTicks();
-                            break;
-                        }
-                        break;
-                    break;
-            };
+    switch (states->wrong_input_state) {
+        case WRONG_INPUT_IN_ABOUT_GAME:
+            return &assets->reminders.wrong_input_in_about_game;
+        case WRONG_INPUT_IN_GAME:
+            return &assets->reminders.wrong_input_in_game;
+        case WRONG_INPUT_IN_TUTORIAL:
+            return &assets->reminders.wrong_input_in_tutorial;
+        case WRONG_INPUT_IN_FOOD_INPUT:
+            return &assets->reminders.wrong_input_in_food_input;
+        case WRONG_INPUT_IN_MENU:
+            return &assets->reminders.wrong_input_in_menu;
+        case WRONG_INPUT_IN_GAME_PROMPTS:
+            return &assets->reminders.wrong_input_in_game_prompts;
+        case WRONG_INPUT_NONE:
             break;
+    }
+    return NULL;
+}
+
+void prefetch_next_screens(States *states, Assets *assets) {
+    /*
+     * A function that asks for the images of the screens the player is likely
+     * to open next to be loaded ahead of time, so that opening them does not
+     * wait for their atlas pages.
+     *
+     * params
+     *      States *states
+     *            A pointer to the struct `States`, which handles the different states of the
+     *            game.
+     *      Assets *assets
+     *            A pointer to the struct `Assets`, which holds the sprites.
+     */
+
+    switch (states->player_state) {
         case PLAYER_IN_MENU:
-            switch (player_keypress) {
-                case SDLK_1:
-                case SDLK_KP_1:
-                    Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                    states->current_menu_choice = PLAYER_CHOSE_START;
-                    break;
-                case SDLK_a:
-                    Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                    states->current_menu_choice = PLAYER_CHOSE_ABOUT;
-                    break;
-                case SDLK_2:
-                case SDLK_KP_2:
-                    Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                    states->current_menu_choice = PLAYER_CHOSE_TUTORIAL;
+            // The highlighted option is the one that is likely to be chosen
+            switch (states->current_menu_choice) {
+                case PLAYER_CHOSE_START:
+                    prefetch_sprite(&assets->misc.food_input_prompts[0]);
                     break;
-                case SDLK_3:
-                case SDLK_KP_3:
-                    Mix_PlayChannel(0, assets->sounds.option_select, 0);
-                    states->current_menu_choice = PLAYER_CHOSE_EXIT;
+                case PLAYER_CHOSE_TUTORIAL:
+                    prefetch_sprite(&assets->misc.tutorial_pages[0]);
                     break;
-                case SDLK_RETURN:
-                    // A separate switch is created for pressing 'Enter'. This allows the
-                    // user to change the chosen option, even after pressing some other
-                    // number previously. Once 'Enter' is pressed, the game state will be
-                    // changed to GAME_IN_PROGRESS, which is the actual game proper.
-                    switch (states->current_menu_choice) {
-                        case PLAYER_CHOSE_ABOUT:
-                            // Play confirmation sound
-                            Mix_PlayChannel(1, assets->sounds.open_about_game, 0);
-                            states->player_state = PLAYER_IN_ABOUT;
-                            break;
-                        case PLAYER_CHOSE_TUTORIAL:
-                            // Play confirmation sound
-                            Mix_PlayChannel(1, assets->sounds.option_confirm, 0);
-                            states->player_state = PLAYER_IN_TUTORIAL;
-                            break;
-                        case PLAYER_CHOSE_START:
-                            // Play confirmation sound
-                            Mix_PlayChannel(1, assets->sounds.option_confirm, 0);
-                            states->player_state = PLAYER_IN_GAME;
-                            break;
-                        case PLAYER_CHOSE_EXIT:
-                            states->show_quit_confirmation = true;
-                            break;
-                        case PLAYER_CHOSE_NONE:
-                            break;
-                    }
-                    // Reset menu choice selection
-                    states->current_menu_choice = PLAYER_CHOSE_NONE;
+                case PLAYER_CHOSE_ABOUT:
+                    prefetch_sprite(&assets->misc.about_screen);
                     break;
-                default:
-                    Mix_PlayChannel(-1, assets->sounds.game_notification, 0);
-                    states->wrong_input_state = WRONG_INPUT_IN_MENU;
-                    states->wrong_input_time = SDL_GetTicks();
+                case PLAYER_CHOSE_EXIT:
+                case PLAYER_CHOSE_NONE:
                     break;
-            };
-            // Reset tutorial slide
-            states->current_tutorial_page = 0;
+            }
             break;
         case PLAYER_IN_TUTORIAL:
-            switch (player_keypress) {
-                case SDLK_RIGHT:
-                    if (is_not_on_the_last_slide) 
-                        states->current_tutorial_page += 1;
-                        Mix_PlayChannel(-1, assets->sounds.pacman_step, 0);
-                    break;
-                case SDLK_LEFT:
-                    if (is_not_on_the_first_slide)  
-                        states->current_tutorial_page -= 1;
-                        Mix_PlayChannel(-1, assets->sounds.pacman_step, 0);
-                    break;
-                case SDLK_m:
-                    Mix_PlayChannel(1, assets->sounds.option_confirm, 0);
-                    states->player_state = PLAYER_IN_MENU;
-                    break;
-                case SDLK_1:
-                    Mix_PlayChannel(1, assets->sounds.option_confirm, 0);
-                    states->player_state = PLAYER_IN_GAME;
+            if (states->current_tutorial_page + 1 < NUMBER_OF_PAGES_IN_TUTORIAL)
+                prefetch_sprite(&assets->misc.tutorial_pages[states->current_tutorial_page + 1]);
+            else
+                prefetch_sprite(&assets->misc.food_input_prompts[0]);
+            break;
+        case PLAYER_IN_ABOUT:
+            prefetch_sprite(&assets->menu.player_chose_none);
+            break;
+        case PLAYER_IN_GAME:
+            switch (states->game_state) {
+                case GAME_IN_FOOD_NUMBER_INPUT:
+                    prefetch_sprite(&assets->game.main);
+                    prefetch_sprite(&assets->game.pacman);
                     break;
-                case SDLK_x:
-                    Mix_PlayChannel(0, assets->sounds.quit_sound, 0);
-                    states->show_quit_confirmation = true;
+                case GAME_IN_PROGRESS:
+                    prefetch_sprite(&assets->prompt.game_won);
+                    prefetch_sprite(&assets->prompt.game_lost_hit_block);
                     break;
                 default:
-                    Mix_PlayChannel(-1, assets->sounds.game_notification, 0);
-                    states->wrong_input_state = WRONG_INPUT_IN_TUTORIAL;
-                    states->wrong_input_time = SDL_GetTicks();
+                    // The result prompts lead back to a new game, or to the menu
+                    prefetch_sprite(&assets->misc.food_input_prompts[0]);
+                    prefetch_sprite(&assets->menu.player_chose_none);
                     break;
             }
             break;
-        case PLAYER_IN_ABOUT:
-            switch (player_keypress) {
-                case SDLK_m:
-                    Mix_PlayChannel(1, assets->sounds.option_confirm, 0);
-                    states->player_state = PLAYER_IN_MENU;
-                    break;
-                default:
-                    Mix_PlayChannel(0, assets->sounds.game_notification, 0);
-                    states->wrong_input_state = WRONG_INPUT_IN_ABOUT_GAME;
-                    states->wrong_input_time = SDL_GetTicks();
-                }
-        default:
-            break;
     }
-    return;
+}
+
+bool is_scene_animated(States *states, Assets *assets) {
+    /*
+     * A function that checks whether the screen changes on its own, even
+     * when the player does not press anything.
+     *
+     * params
+     *      States *states
+     *            A pointer to the struct `States`, which handles the different states of the
+     *            game.
+     *      Assets *assets
+     *            A pointer to the struct `Assets`, which holds the reminders.
+     * returns
+     *      true if the next frame may look different from the current one
+     *
+     * NOTE:
+     *  Only Pacman and the food pieces are animated, and only during a game.
+     *  The menu, the tutorial, the about screen and the result prompts are
+     *  static images, so they only have to be drawn again after a keypress.
+     */
+
+    if (states->player_state == PLAYER_IN_GAME && states->game_state == GAME_IN_PROGRESS)
+        return true;
+
+    // The loading indicator counts up while the assets are loading
+    if (!are_all_assets_loaded(assets))
+        return true;
+
+    // A reminder slides up, stays for a while and then slides down, out of
+    // the window
+    Sprite *reminder = get_reminder_sprite(states, assets);
+    if (reminder && !states->show_quit_confirmation) {
+        bool is_shown = SDL_GetTicks() <= states->wrong_input_time + REMINDER_DURATION;
+        bool is_sliding_down = reminder->rect.y < WINDOW_HEIGHT;
+        if (is_shown || is_sliding_down)
+            return true;
+    }
+
+    return false;
 }
@@ -6,5 +6,8 @@
 
 void render_state(States *states, Board* board, Assets *assets);
 void process_keypress(SDL_Event event, States *states, Board* board, Assets *assets);
+bool check_input_actions(void);
+bool is_scene_animated(States *states, Assets *assets);
+void prefetch_next_screens(States *states, Assets *assets);
 
 #endif
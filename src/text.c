@@ -0,0 +1,119 @@
+/*
+ *  This file, `text.c`, contains a tiny bitmap font that draws short lines of
+ *  text, such as numbers, with filled rectangles.
+ *
+ *  NOTE:
+ *   All other text in the game is part of its images. This font is only for
+ *   values that are not known ahead of time, like the par of a board.
+ */
+
+#include "ctype.h"
+#include "string.h"
+
+#include "render_queue.h"
+#include "text.h"
+#include "declarations.h"
+
+#include "SDL2/SDL.h"
+
+/*
+ * Glyph is a character of the font. Each of its rows is 3 bits wide, with
+ * the leftmost pixel in the highest bit.
+ */
+typedef struct Glyph {
+    char            character;
+    unsigned char   rows[TEXT_GLYPH_HEIGHT];
+} Glyph;
+
+static const Glyph FONT[] = {
+    {'0', {7, 5, 5, 5, 7}}, {'1', {2, 6, 2, 2, 7}}, {'2', {7, 1, 7, 4, 7}},
+    {'3', {7, 1, 7, 1, 7}}, {'4', {5, 5, 7, 1, 1}}, {'5', {7, 4, 7, 1, 7}},
+    {'6', {7, 4, 7, 5, 7}}, {'7', {7, 1, 1, 1, 1}}, {'8', {7, 5, 7, 5, 7}},
+    {'9', {7, 5, 7, 1, 7}},
+    {'A', {2, 5, 7, 5, 5}}, {'B', {6, 5, 6, 5, 6}}, {'C', {3, 4, 4, 4, 3}},
+    {'D', {6, 5, 5, 5, 6}}, {'E', {7, 4, 6, 4, 7}}, {'F', {7, 4, 6, 4, 4}},
+    {'G', {3, 4, 5, 5, 3}}, {'H', {5, 5, 7, 5, 5}}, {'I', {7, 2, 2, 2, 7}},
+    {'J', {1, 1, 1, 5, 2}}, {'K', {5, 5, 6, 5, 5}}, {'L', {4, 4, 4, 4, 7}},
+    {'M', {5, 7, 7, 5, 5}}, {'N', {6, 5, 5, 5, 5}}, {'O', {2, 5, 5, 5, 2}},
+    {'P', {6, 5, 6, 4, 4}}, {'Q', {2, 5, 5, 6, 3}}, {'R', {6, 5, 6, 5, 5}},
+    {'S', {3, 4, 2, 1, 6}}, {'T', {7, 2, 2, 2, 2}}, {'U', {5, 5, 5, 5, 7}},
+    {'V', {5, 5, 5, 5, 2}}, {'W', {5, 5, 7, 7, 5}}, {'X', {5, 5, 2, 5, 5}},
+    {'Y', {5, 5, 2, 2, 2}}, {'Z', {7, 1, 2, 4, 7}},
+    {'.', {0, 0, 0, 0, 2}}, {':', {0, 2, 0, 2, 0}}, {'/', {1, 1, 2, 4, 4}},
+    {'-', {0, 0, 7, 0, 0}}, {'%', {5, 1, 2, 4, 5}}, {'_', {0, 0, 0, 0, 7}},
+};
+
+static const Glyph* find_glyph(char character) {
+    /*
+     * A helper function that returns the glyph of `character`, or NULL if
+     * the font does not have it. Lowercase letters are drawn as uppercase.
+     */
+
+    character = (char) toupper((unsigned char) character);
+    for (size_t i=0; i<sizeof(FONT) / sizeof(FONT[0]); i++) {
+        if (FONT[i].character == character)
+            return &FONT[i];
+    }
+    return NULL;
+}
+
+int measure_text_width(const char *text, int scale) {
+    /*
+     * A function that returns the width of `text` in screen pixels, when
+     * drawn with `render_text`.
+     */
+
+    int length = (int) strlen(text);
+    if (length == 0)
+        return 0;
+    return (length * (TEXT_GLYPH_WIDTH + TEXT_GLYPH_SPACING) - TEXT_GLYPH_SPACING) * scale;
+}
+
+void render_text(RenderQueue *render_queue, enum RenderLayer layer, const char *text, int x, int y, int scale, SDL_Color color) {
+    /*
+     * A function that queues a line of text to be drawn.
+     *
+     * params
+     *      RenderQueue *render_queue
+     *          The queue to draw through
+     *      enum RenderLayer layer
+     *          The layer to draw the text on
+     *      const char *text
+     *          The text to draw. Characters missing from the font, such as
+     *          spaces, are left blank.
+     *      int x, int y
+     *          The top left corner of the text, in screen pixels
+     *      int scale
+     *          The size of a font pixel, in screen pixels
+     *      SDL_Color color
+     *          The color of the text
+     *
+     * NOTE:
+     *  Font pixels next to each other on a row are queued as one rectangle.
+     */
+
+    for (const char *character=text; *character; character++) {
+        const Glyph *glyph = find_glyph(*character);
+
+        if (glyph) {
+            for (int row=0; row<TEXT_GLYPH_HEIGHT; row++) {
+                int col = 0;
+                while (col < TEXT_GLYPH_WIDTH) {
+                    if (!(glyph->rows[row] & (1 << (TEXT_GLYPH_WIDTH - 1 - col)))) {
+                        col++;
+                        continue;
+                    }
+
+                    int run_start = col;
+                    while (col < TEXT_GLYPH_WIDTH && (glyph->rows[row] & (1 << (TEXT_GLYPH_WIDTH - 1 - col))))
+                        col++;
+
+                    SDL_Rect run = {.x=x + run_start * scale, .y=y + row * scale, .w=(col - run_start) * scale, .h=scale};
+                    queue_filled_rect(render_queue, layer, run, color);
+                }
+            }
+        }
+
+        x += (TEXT_GLYPH_WIDTH + TEXT_GLYPH_SPACING) * scale;
+    }
+}
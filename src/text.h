@@ -0,0 +1,22 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include "declarations.h"
+
+// The size of a character, in font pixels, before scaling
+#define TEXT_GLYPH_WIDTH 3
+#define TEXT_GLYPH_HEIGHT 5
+#define TEXT_GLYPH_SPACING 1
+
+void render_text(RenderQueue *render_queue,
+                 enum RenderLayer layer,
+                 const char *text,
+                 int x,
+                 int y,
+                 int scale,
+                 SDL_Color color
+                );
+
+int measure_text_width(const char *text, int scale);
+
+#endif // !TEXT_H
@@ -0,0 +1,268 @@
+/*
+ *  This file, `texture_cache.c`, contains the cache of the atlas pages. A page
+ *  is only loaded into a texture when one of its sprites is first drawn, and
+ *  the pages that were drawn the longest time ago are released whenever the
+ *  loaded pages use more memory than the budget.
+ *
+ *  NOTE:
+ *      Most players never open the tutorial or the about screen, so their
+ *      pages are never loaded. To avoid loading a page in the middle of a
+ *      frame, the screens the player is likely to open next are requested
+ *      ahead of time, and loaded one page at a time between frames by
+ *      `prefetch_atlas_page`.
+ */
+
+#include "stdio.h"
+#include "stdbool.h"
+
+#include "atlas.h"
+#include "declarations.h"
+#include "texture_cache.h"
+#include "trace.h"
+
+static bool is_page_loaded(const TextureCache *cache, int page) {
+    return cache->atlas->pages[page] != NULL;
+}
+
+static size_t get_evictable_bytes(const TextureCache *cache) {
+    /*
+     * A helper function that returns the memory used by the loaded pages
+     * that were not drawn in the current frame, i.e. that could be released.
+     */
+
+    size_t bytes = 0;
+    for (int page=0; page<cache->atlas->number_of_pages; page++) {
+        if (is_page_loaded(cache, page) && cache->last_used[page] < cache->current_frame)
+            bytes += cache->page_bytes[page];
+    }
+    return bytes;
+}
+
+static void evict_atlas_pages(TextureCache *cache) {
+    /*
+     * A helper function that releases the least recently drawn pages until
+     * the loaded pages fit in the budget.
+     *
+     * NOTE:
+     *  The pages drawn in the current frame are kept even if they do not fit,
+     *  so the budget may be exceeded until the next frame.
+     */
+
+    while (cache->bytes_used > cache->budget) {
+        int oldest = -1;
+        for (int page=0; page<cache->atlas->number_of_pages; page++) {
+            if (!is_page_loaded(cache, page) || cache->last_used[page] >= cache->current_frame)
+                continue;
+            if (oldest < 0 || cache->last_used[page] < cache->last_used[oldest])
+                oldest = page;
+        }
+        if (oldest < 0)
+            return;
+
+        SDL_DestroyTexture(cache->atlas->pages[oldest]);
+        cache->atlas->pages[oldest] = NULL;
+        cache->bytes_used -= cache->page_bytes[oldest];
+        cache->stats.evictions++;
+    }
+}
+
+void init_texture_cache(TextureCache *cache, SDL_Renderer *renderer, const AssetPack *pack, Atlas *atlas, size_t budget) {
+    /*
+     * A function that sets up an empty cache of the atlas pages.
+     *
+     * params
+     *      TextureCache *cache
+     *          A pointer to the struct TextureCache
+     *      SDL_Renderer *renderer
+     *          A pointer to the struct SDL_Renderer which the pages are drawn with
+     *      const AssetPack *pack
+     *          A pointer to the struct AssetPack, which holds the decoded pages
+     *      Atlas *atlas
+     *          A pointer to the struct Atlas, prepared by `prepare_atlas`,
+     *          which receives the loaded pages
+     *      size_t budget
+     *          The most memory, in bytes, the loaded pages may use
+     */
+
+    cache->atlas = atlas;
+    cache->pack = pack;
+    cache->renderer = renderer;
+    cache->budget = budget;
+    cache->bytes_used = 0;
+    cache->current_frame = 1;
+    cache->stats = (TextureCacheStats) {0, 0, 0, 0};
+
+    for (int page=0; page<MAX_ATLAS_PAGES; page++) {
+        cache->page_bytes[page] = 0;
+        cache->last_used[page] = 0;
+        cache->is_prefetch_requested[page] = false;
+    }
+}
+
+void begin_texture_cache_frame(TextureCache *cache) {
+    /*
+     * A function that starts a new frame. The pages drawn in the previous
+     * frames may be released from now on.
+     */
+
+    cache->current_frame++;
+}
+
+bool insert_atlas_page(TextureCache *cache, int page, SDL_Surface *surface) {
+    /*
+     * A function that uploads a decoded page into the cache, and releases
+     * other pages if it does not fit in the budget.
+     *
+     * params
+     *      TextureCache *cache
+     *          A pointer to the struct TextureCache
+     *      int page
+     *          The index of the page
+     *      SDL_Surface *surface
+     *          The pixels returned by `decode_atlas_page`, which are not released
+     * returns
+     *      false if the page could not be uploaded
+     */
+
+    if (is_page_loaded(cache, page))
+        return true;
+
+    if (!upload_atlas_page(cache->renderer, cache->atlas, page, surface))
+        return false;
+
+    cache->page_bytes[page] = (size_t) surface->pitch * (size_t) surface->h;
+    cache->bytes_used += cache->page_bytes[page];
+    cache->last_used[page] = cache->current_frame;
+    cache->is_prefetch_requested[page] = false;
+
+    evict_atlas_pages(cache);
+    return true;
+}
+
+static bool load_atlas_page(TextureCache *cache, int page) {
+    /*
+     * A helper function that decodes and uploads a page right away.
+     *
+     * NOTE:
+     *  A page that cannot be loaded is marked as unavailable, so that its
+     *  sprites are loaded from their own images instead.
+     */
+
+    TraceZone zone = begin_trace_zone("load_atlas_page");
+    SDL_Surface *surface = decode_atlas_page(cache->pack, page);
+    bool is_loaded = surface && insert_atlas_page(cache, page, surface);
+    if (surface)
+        SDL_FreeSurface(surface);
+
+    if (!is_loaded)
+        cache->atlas->is_page_available[page] = false;
+    end_trace_zone(zone);
+    return is_loaded;
+}
+
+SDL_Texture* use_atlas_page(TextureCache *cache, int page) {
+    /*
+     * A function that returns the texture of a page that is about to be
+     * drawn, loading it first if it is not loaded.
+     *
+     * params
+     *      TextureCache *cache
+     *          A pointer to the struct TextureCache
+     *      int page
+     *          The index of the page
+     * returns
+     *      the texture of the page, or NULL if it cannot be loaded
+     */
+
+    if (page < 0 || page >= cache->atlas->number_of_pages || !cache->atlas->is_page_available[page])
+        return NULL;
+
+    if (is_page_loaded(cache, page)) {
+        cache->stats.hits++;
+    } else {
+        cache->stats.misses++;
+        if (!load_atlas_page(cache, page))
+            return NULL;
+    }
+
+    cache->last_used[page] = cache->current_frame;
+    return cache->atlas->pages[page];
+}
+
+void request_atlas_page(TextureCache *cache, int page) {
+    /*
+     * A function that asks for a page to be loaded ahead of time, since it
+     * is likely to be drawn soon. See `prefetch_atlas_page`.
+     */
+
+    if (page < 0 || page >= cache->atlas->number_of_pages || !cache->atlas->is_page_available[page])
+        return;
+
+    if (!is_page_loaded(cache, page))
+        cache->is_prefetch_requested[page] = true;
+}
+
+bool has_atlas_page_requests(const TextureCache *cache) {
+    /*
+     * A function that checks whether a requested page is still waiting to
+     * be loaded.
+     */
+
+    for (int page=0; page<cache->atlas->number_of_pages; page++) {
+        if (cache->is_prefetch_requested[page])
+            return true;
+    }
+    return false;
+}
+
+bool prefetch_atlas_page(TextureCache *cache) {
+    /*
+     * A function that loads one of the requested pages. It is called between
+     * frames, so that no frame waits for more than one page.
+     *
+     * returns
+     *      true if a page was loaded
+     *
+     * NOTE:
+     *  A page is not prefetched if it only fits in the budget by releasing
+     *  a page that is on the screen, since that page would then be loaded
+     *  again on the next frame.
+     */
+
+    for (int page=0; page<cache->atlas->number_of_pages; page++) {
+        if (!cache->is_prefetch_requested[page])
+            continue;
+        cache->is_prefetch_requested[page] = false;
+
+        if (is_page_loaded(cache, page) || !cache->atlas->is_page_available[page])
+            continue;
+
+        SDL_Surface *surface = decode_atlas_page(cache->pack, page);
+        if (!surface) {
+            cache->atlas->is_page_available[page] = false;
+            continue;
+        }
+
+        size_t bytes = (size_t) surface->pitch * (size_t) surface->h;
+        bool fits = cache->bytes_used - get_evictable_bytes(cache) + bytes <= cache->budget;
+        bool is_loaded = fits && insert_atlas_page(cache, page, surface);
+        SDL_FreeSurface(surface);
+
+        if (is_loaded) {
+            cache->stats.prefetches++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void print_texture_cache_stats(const TextureCache *cache) {
+    /*
+     * A function that reports how the atlas pages were found, and how much
+     * memory the loaded pages use.
+     */
+
+    printf("Texture cache: %lu hits, %lu misses, %lu evictions, %lu prefetches, %.1f of %.1f MB used\n",
+           cache->stats.hits, cache->stats.misses, cache->stats.evictions, cache->stats.prefetches,
+           (double) cache->bytes_used / (1024.0 * 1024.0), (double) cache->budget / (1024.0 * 1024.0));
+}
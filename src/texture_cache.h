@@ -0,0 +1,22 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "declarations.h"
+
+void init_texture_cache(TextureCache *cache, SDL_Renderer *renderer, const AssetPack *pack, Atlas *atlas, size_t budget);
+
+void begin_texture_cache_frame(TextureCache *cache);
+
+SDL_Texture* use_atlas_page(TextureCache *cache, int page);
+
+bool insert_atlas_page(TextureCache *cache, int page, SDL_Surface *surface);
+
+void request_atlas_page(TextureCache *cache, int page);
+
+bool has_atlas_page_requests(const TextureCache *cache);
+
+bool prefetch_atlas_page(TextureCache *cache);
+
+void print_texture_cache_stats(const TextureCache *cache);
+
+#endif // !TEXTURE_CACHE_H
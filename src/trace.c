@@ -0,0 +1,144 @@
+/*
+ *  This file, `trace.c`, contains the tracer, which records how long the
+ *  zones of the game take, e.g. loading a sprite or rendering a frame, and
+ *  writes them as a Chrome trace that chrome://tracing or Perfetto can show.
+ *
+ *  usage
+ *      TraceZone zone = begin_trace_zone("render_state");
+ *      ...
+ *      end_trace_zone(zone);
+ *
+ *  NOTE:
+ *      Unlike the rest of the game, the tracer is not passed around, since
+ *      its zones are in functions that are given nothing else to hold it,
+ *      such as `init_SDL`. While the game is not traced, a zone only costs
+ *      a check of `is_tracing_enabled`, so the zones stay in every build.
+ *      The zones may be recorded from any thread, e.g. by the asset workers.
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdbool.h"
+
+#include "declarations.h"
+#include "trace.h"
+
+#include "SDL2/SDL.h"
+
+bool is_tracing_enabled = false;
+
+static Tracer tracer;
+
+bool start_tracing(const char *filename) {
+    /*
+     * A function that starts recording the zones, which are written to a
+     * file by `write_trace` or `stop_tracing`.
+     *
+     * params
+     *      const char *filename
+     *          The file the trace is written to
+     * returns
+     *      false if the ring buffer cannot be allocated
+     *
+     * NOTE:
+     *  It must be called before any other thread records a zone.
+     */
+
+    tracer.events = calloc(TRACE_BUFFER_SIZE, sizeof(TraceEvent));
+    if (!tracer.events) {
+        printf("Error starting the trace: out of memory\n");
+        return false;
+    }
+
+    SDL_AtomicSet(&tracer.number_of_events, 0);
+    tracer.start = SDL_GetPerformanceCounter();
+    tracer.filename = filename;
+    is_tracing_enabled = true;
+    return true;
+}
+
+void record_trace_zone(TraceZone zone, Uint64 end) {
+    /*
+     * A function that records a zone that was left, overwriting the oldest
+     * zone if the ring buffer is full. It is called by `end_trace_zone`.
+     */
+
+    int index = SDL_AtomicAdd(&tracer.number_of_events, 1);
+    TraceEvent *event = &tracer.events[index % TRACE_BUFFER_SIZE];
+
+    // Mark the event as being written, so that it is skipped if the trace
+    // is written in the meantime
+    SDL_AtomicSet(&event->sequence, 0);
+    event->name = zone.name;
+    event->thread = (unsigned long) SDL_ThreadID();
+    event->start = zone.start;
+    event->duration = end - zone.start;
+    SDL_AtomicSet(&event->sequence, index + 1);
+}
+
+bool write_trace(void) {
+    /*
+     * A function that writes the zones in the ring buffer to the trace file,
+     * in the JSON format of Chrome traces. The zones keep being recorded.
+     *
+     * returns
+     *      false if the game is not traced, or the file cannot be written
+     */
+
+    if (!is_tracing_enabled)
+        return false;
+
+    FILE *file = fopen(tracer.filename, "w");
+    if (!file) {
+        printf("Error writing the trace to %s\n", tracer.filename);
+        return false;
+    }
+
+    int number_of_events = SDL_AtomicGet(&tracer.number_of_events);
+    int first = number_of_events > TRACE_BUFFER_SIZE ? number_of_events - TRACE_BUFFER_SIZE : 0;
+    double ticks_per_us = (double) SDL_GetPerformanceFrequency() / 1000000.0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    int number_written = 0;
+    for (int index=first; index<number_of_events; index++) {
+        TraceEvent *event = &tracer.events[index % TRACE_BUFFER_SIZE];
+
+        // Skip the zones that were being written while they were copied
+        if (SDL_AtomicGet(&event->sequence) != index + 1)
+            continue;
+        TraceEvent copy = *event;
+        if (SDL_AtomicGet(&event->sequence) != index + 1)
+            continue;
+
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+                number_written == 0 ? "" : ",\n", copy.name, copy.thread,
+                (double) (copy.start - tracer.start) / ticks_per_us,
+                (double) copy.duration / ticks_per_us);
+        number_written++;
+    }
+    fprintf(file, "\n]}\n");
+
+    bool is_written = !ferror(file);
+    fclose(file);
+
+    if (is_written)
+        printf("Wrote %d trace zones to %s\n", number_written, tracer.filename);
+    return is_written;
+}
+
+void stop_tracing(void) {
+    /*
+     * A function that writes the trace and stops recording the zones.
+     *
+     * NOTE:
+     *  It must be called once no other thread records a zone.
+     */
+
+    if (!is_tracing_enabled)
+        return;
+
+    write_trace();
+    is_tracing_enabled = false;
+    free(tracer.events);
+    tracer.events = NULL;
+}
@@ -0,0 +1,34 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "stdbool.h"
+
+#include "declarations.h"
+
+#include "SDL2/SDL.h"
+
+// Whether the zones are recorded, which is only changed by `start_tracing`
+// and `stop_tracing`
+extern bool is_tracing_enabled;
+
+bool start_tracing(const char *filename);
+
+void record_trace_zone(TraceZone zone, Uint64 end);
+
+bool write_trace(void);
+
+void stop_tracing(void);
+
+static inline TraceZone begin_trace_zone(const char *name) {
+    TraceZone zone = {name, 0};
+    if (is_tracing_enabled)
+        zone.start = SDL_GetPerformanceCounter();
+    return zone;
+}
+
+static inline void end_trace_zone(TraceZone zone) {
+    if (zone.start != 0)
+        record_trace_zone(zone, SDL_GetPerformanceCounter());
+}
+
+#endif // !TRACE_H
@@ -7,16 +7,27 @@
 #include "stdbool.h"
 #include "stdio.h"
 
+#include "atlas.h"
+#include "render_queue.h"
+#include "texture_cache.h"
+#include "trace.h"
 #include "utils.h"
 #include "declarations.h"
 
 #include "SDL2/SDL_mixer.h"
 
-void init_SDL() {
+void init_SDL(int audio_chunk_size) {
     /*
      *  A helper function that handles the initialization of SDL
+     *
+     *  params
+     *      int audio_chunk_size
+     *          The samples the audio device mixes at a time. A smaller
+     *          buffer is heard sooner, but may crackle on a slow machine.
      */
 
+    TraceZone zone = begin_trace_zone("init_SDL");
+
     // Turn on anti-aliasing by default
     SDL_SetHint( SDL_HINT_RENDER_SCALE_QUALITY, "1" );
 
@@ -30,7 +41,10 @@ void init_SDL() {
     }  
 
     // Initialize SDL audio system and mixer
-    Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT , 2, 2048);
+    if (Mix_OpenAudio(AUDIO_FREQUENCY, AUDIO_FORMAT, AUDIO_CHANNELS, audio_chunk_size) != 0)
+        printf("Error opening the audio device: %s\n", Mix_GetError());
+
+    end_trace_zone(zone);
 }
 
 
@@ -57,7 +71,7 @@ SDL_Window* create_window() {
     return window;
 }
 
-SDL_Renderer* create_renderer(SDL_Window *window) {
+SDL_Renderer* create_renderer(SDL_Window *window, bool vsync) {
     /*
      *  A function that creates a renderer, which manages the graphics hardware. 
      *  A `renderer` is a variable defined in SDL that handles the rendering
@@ -66,10 +80,15 @@ SDL_Renderer* create_renderer(SDL_Window *window) {
      *  params
      *      SDL_Window *window
      *           A pointer to the struct SDL_Window
+     *      bool vsync
+     *           Whether presenting a frame should wait for the display
      *
      */
 
-    Uint32 render_flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+    Uint32 render_flags = SDL_RENDERER_ACCELERATED;
+    if (vsync)
+        render_flags |= SDL_RENDERER_PRESENTVSYNC;
+
     SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, render_flags);
 
     if (!renderer) {
@@ -80,6 +99,66 @@ SDL_Renderer* create_renderer(SDL_Window *window) {
     return renderer;
 }
 
+static void load_sprite_from_own_image(Sprite *sprite) {
+    /*
+     * A helper function that loads the image of a sprite into a texture of
+     * its own, when the atlas page it is on could not be loaded.
+     */
+
+    int page = sprite->atlas_page;
+    sprite->atlas_page = -1;
+
+    for (int i=0; i<NUMBER_OF_ATLAS_ENTRIES; i++) {
+        const AtlasEntry *entry = &ATLAS_ENTRIES[i];
+        if (entry->page != page || !SDL_RectEquals(&entry->rect, &sprite->source))
+            continue;
+
+        SDL_Surface *image_surface = IMG_Load(entry->filename);
+        if (!image_surface) {
+            printf("Error loading %s\n", entry->filename);
+            return;
+        }
+        sprite->texture = SDL_CreateTextureFromSurface(sprite->renderer, image_surface);
+        if (!sprite->texture)
+            printf("Error creating texture: %s\n", SDL_GetError());
+        sprite->source = (SDL_Rect) {0, 0, image_surface->w, image_surface->h};
+        SDL_FreeSurface(image_surface);
+        return;
+    }
+}
+
+static SDL_Texture* get_sprite_texture(Sprite *sprite) {
+    /*
+     * A helper function that returns the texture a sprite is drawn from,
+     * loading its atlas page if needed.
+     */
+
+    if (sprite->atlas_page < 0)
+        return sprite->texture;
+
+    SDL_Texture *page = use_atlas_page(sprite->texture_cache, sprite->atlas_page);
+    if (page)
+        return page;
+
+    if (!sprite->texture_cache->atlas->is_page_available[sprite->atlas_page])
+        load_sprite_from_own_image(sprite);
+    return sprite->texture;
+}
+
+void prefetch_sprite(Sprite *sprite) {
+    /*
+     * A function that asks for the atlas page of a sprite to be loaded ahead
+     * of time, since the sprite is likely to be drawn soon.
+     *
+     * params
+     *      Sprite *sprite
+     *          A pointer to the struct Sprite
+     */
+
+    if (sprite->atlas_page >= 0)
+        request_atlas_page(sprite->texture_cache, sprite->atlas_page);
+}
+
 void render_sprite(Sprite *sprite) {
     /*
      * This function handles the rendering of `sprites` in the screen
@@ -93,6 +172,7 @@ void render_sprite(Sprite *sprite) {
      */
 
     bool is_sprite_static = sprite->total_frames == 1;
+    SDL_Texture *texture = get_sprite_texture(sprite);
 
     // NOTE:
     // The following if-else statement handles, (a) when the sprite is static, meaning it 
@@ -101,8 +181,9 @@ void render_sprite(Sprite *sprite) {
     if (is_sprite_static) {
 
         // NOTE:
-        // SDL_RenderCopy is an SDL defined function that displays an image into the screen
-        SDL_RenderCopy(sprite->renderer, sprite->texture, NULL, &sprite->rect);
+        // The sprite is queued, and drawn together with the other sprites
+        // that share its texture once the frame is complete.
+        queue_texture(sprite->render_queue, sprite->layer, texture, sprite->source, sprite->rect, 0, SDL_FLIP_NONE);
     } else {
 
         // NOTE:
@@ -117,13 +198,17 @@ void render_sprite(Sprite *sprite) {
         Uint32 current_frame_index = ( ticks/ SPRITE_UPDATE_DELAY  + sprite->current_frame) % sprite->total_frames;
 
         // clip_rect defines a rectangle that contains the current frame being displayed
-        SDL_Rect clip_rect = { current_frame_index * sprite->frame_size, 0, sprite->rect.w, sprite->rect.h };
+        SDL_Rect clip_rect = {
+            sprite->source.x + current_frame_index * sprite->frame_size,
+            sprite->source.y,
+            sprite->rect.w,
+            sprite->rect.h
+        };
 
         // NOTE:
-        // SDL_RenderCopyEx differs with SDL_RenderCopyEx insofar as, SDL_RenderCopyEx has extra parameters which 
-                // ?
-        // can be used to rotate or flip the image displayed in the screen.
-        SDL_RenderCopyEx(sprite->renderer, sprite->texture, &clip_rect, &sprite->rect, sprite->rotation, NULL, sprite->flip);
+        // Unlike static sprites, animated sprites can be rotated or flipped, e.g. to
+        // turn Pacman towards the direction it moves in.
+        queue_texture(sprite->render_queue, sprite->layer, texture, clip_rect, sprite->rect, sprite->rotation, sprite->flip);
 
         // NOTE:
         // If the reader is interested, a better explanation for animating images using SDL
@@ -132,15 +217,17 @@ void render_sprite(Sprite *sprite) {
 
 }
 
-Sprite load_sprite(SDL_Renderer *renderer, char* filename, int sprite_frame_size, int total_frames, SDL_Rect rect) {
+Sprite load_sprite(RenderQueue *render_queue, TextureCache *texture_cache, char* filename, int sprite_frame_size, int total_frames, SDL_Rect rect) {
 
     /*
      * A function that handles the loading of images into memory.
      *
      * params
-     *      SDL_Renderer *renderer
-     *          A pointer to the struct SDL_Renderer which handles the rendering of every element
-     *          in the screen.
+     *      RenderQueue *render_queue
+     *          A pointer to the struct RenderQueue which the sprite is drawn through. Its
+     *          renderer handles the rendering of every element in the screen.
+     *      TextureCache *texture_cache
+     *          A pointer to the struct TextureCache which the atlas pages are loaded through
      *      char *filename
      *          A string which encodes the filename of the image which will be
      *          loaded into memory.
@@ -155,12 +242,42 @@ Sprite load_sprite(SDL_Renderer *renderer, char* filename, int sprite_frame_size
      *      A struct Sprite
      *
      * example
-     *      Sprite image = load_sprite(renderer, image_filename, 0, 1, image_rect);
+     *      Sprite image = load_sprite(render_queue, &assets.texture_cache, image_filename, 0, 1, image_rect);
      *      Then you will be able to render the `image` by doing
      *      render_sprite(&image);
      *
+     * NOTE:
+     *  When the image was packed into the atlas, the sprite points to its
+     *  part of an atlas page and nothing is loaded. The page is loaded when
+     *  the sprite is first drawn. Otherwise, the image is loaded into a
+     *  texture of its own.
      */
 
+    TraceZone zone = begin_trace_zone("load_sprite");
+    SDL_Renderer *renderer = render_queue->renderer;
+
+    Sprite sprite;
+    sprite.renderer = renderer;
+    sprite.render_queue = render_queue;
+    sprite.layer = RENDER_LAYER_SCREEN;
+    sprite.flip = SDL_FLIP_NONE;
+    sprite.rotation = 0;
+    sprite.frame_size = sprite_frame_size;
+    sprite.total_frames = total_frames;
+    sprite.current_frame = 0;
+    sprite.rect = rect;
+
+    sprite.texture_cache = texture_cache;
+
+    const AtlasEntry *entry = find_atlas_entry(texture_cache->atlas, filename);
+    if (entry) {
+        sprite.texture = NULL;
+        sprite.source = entry->rect;
+        sprite.atlas_page = entry->page;
+        end_trace_zone(zone);
+        return sprite;
+    }
+
     SDL_Surface* image_surface = IMG_Load(filename);
     if (!image_surface) {
         printf("Error creating surface\n");
@@ -170,36 +287,19 @@ Sprite load_sprite(SDL_Renderer *renderer, char* filename, int sprite_frame_size
         printf("Error creating texture: %s\n", SDL_GetError());
 
     }
-    SDL_FreeSurface(image_surface);
-
 
-    Sprite sprite;
-    sprite.renderer = renderer;
-    sprite.frame_size = sprite_frame_size;
-    sprite.total_frames = total_frames;
     sprite.texture = image_texture;
-    sprite.current_frame = 0;
-    sprite.rect = rect;
+    sprite.source = (SDL_Rect) {0, 0, 0, 0};
+    sprite.atlas_page = -1;
+    if (image_surface) {
+        sprite.source.w = image_surface->w;
+        sprite.source.h = image_surface->h;
+    }
+    SDL_FreeSurface(image_surface);
+    end_trace_zone(zone);
     return sprite;
 }
 
-int gen_random_num(int min, int max) {
-    /* 
-     * A function that generates a random number with a minimum or maximum
-     * 
-     * params:
-     *      int max
-     *          the maximum number that will be generated
-     *      int min
-     *          the minimum number that will be generated
-     * returns:
-     *      a random number generated in the range [min, max]
-     */
-
-    return rand() % (max + 1 - min) + min;
-}
-
-
 void render_reminder(Sprite* sprite, States* states, Uint32 duration, int maximum_height, int move_speed){
     /* 
      * A function that handles the rendering of a reminder. This
@@ -3,12 +3,13 @@
 
 #include "declarations.h"
 
-void init_SDL();
+void init_SDL(int audio_chunk_size);
 
-SDL_Renderer* create_renderer(SDL_Window* window);
+SDL_Renderer* create_renderer(SDL_Window* window, bool vsync);
 SDL_Window* create_window();
 
-Sprite load_sprite(SDL_Renderer *renderer,
+Sprite load_sprite(RenderQueue *render_queue,
+                   TextureCache *texture_cache,
                    char* filename,
                    int sprite_frame_size, 
                    int total_frames,
@@ -17,7 +18,7 @@ Sprite load_sprite(SDL_Renderer *renderer,
 
 void render_sprite(Sprite *sprite);
 
-int gen_random_num(int min, int max);
+void prefetch_sprite(Sprite *sprite);
 
 void render_reminder(Sprite* sprite, 
                      States* states,
@@ -0,0 +1,296 @@
+/*
+ *  This file, `voices.c`, contains the voice manager, which decides on which
+ *  mixer channel every sound effect is played.
+ *
+ *  NOTE:
+ *      Every sound effect has a priority, a limit on how many copies of it
+ *      play at once, and a window in which playing it again is skipped. When
+ *      every channel is busy, the least important sound effect that started
+ *      the longest time ago is cut off, unless it is more important than the
+ *      new one. Since there are only NUMBER_OF_VOICES channels, the mixer
+ *      never mixes more sounds than that, however fast the keys are pressed.
+ */
+
+#include "stdio.h"
+#include "stdbool.h"
+
+#include "declarations.h"
+#include "voices.h"
+
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_mixer.h"
+
+/*
+ * SoundSettings tells how a sound effect may be played.
+ */
+typedef struct SoundSettings {
+    // A sound effect only cuts off the ones whose priority is not higher
+    int     priority;
+    // The most copies of the sound effect that play at once. Playing it
+    // again restarts the copy that started first.
+    int     max_instances;
+    // Playing the sound effect again within this many milliseconds is skipped
+    Uint32  coalesce_window;
+} SoundSettings;
+
+static const SoundSettings SOUND_SETTINGS[NUMBER_OF_SOUND_EFFECTS] = {
+    [SOUND_PACMAN_MUNCH]        = {.priority=1, .max_instances=1, .coalesce_window=30},
+    [SOUND_PACMAN_STEP]         = {.priority=0, .max_instances=2, .coalesce_window=60},
+    [SOUND_OPTION_SELECT]       = {.priority=1, .max_instances=1, .coalesce_window=30},
+    [SOUND_OPTION_CONFIRM]      = {.priority=2, .max_instances=1, .coalesce_window=30},
+    [SOUND_QUIT]                = {.priority=2, .max_instances=1, .coalesce_window=0},
+    [SOUND_OPEN_ABOUT_GAME]     = {.priority=2, .max_instances=1, .coalesce_window=0},
+    [SOUND_START_GAME]          = {.priority=3, .max_instances=1, .coalesce_window=0},
+    [SOUND_GAME_NOTIFICATION]   = {.priority=2, .max_instances=1, .coalesce_window=100},
+    [SOUND_GAME_WIN]            = {.priority=4, .max_instances=1, .coalesce_window=0},
+    [SOUND_GAME_OVER]           = {.priority=4, .max_instances=1, .coalesce_window=0},
+};
+
+static Mix_Chunk* get_sound_chunk(const Assets *assets, enum SoundEffect sound) {
+    switch (sound) {
+        case SOUND_PACMAN_MUNCH:        return assets->sounds.pacman_munch;
+        case SOUND_PACMAN_STEP:         return assets->sounds.pacman_step;
+        case SOUND_OPTION_SELECT:       return assets->sounds.option_select;
+        case SOUND_OPTION_CONFIRM:      return assets->sounds.option_confirm;
+        case SOUND_QUIT:                return assets->sounds.quit_sound;
+        case SOUND_OPEN_ABOUT_GAME:     return assets->sounds.open_about_game;
+        case SOUND_START_GAME:          return assets->sounds.start_game;
+        case SOUND_GAME_NOTIFICATION:   return assets->sounds.game_notification;
+        case SOUND_GAME_WIN:            return assets->sounds.game_win;
+        case SOUND_GAME_OVER:           return assets->sounds.game_over;
+        default:                        return NULL;
+    }
+}
+
+static int find_voice(VoiceManager *manager, enum SoundEffect sound) {
+    /*
+     * A helper function that picks the channel a sound effect is played on.
+     *
+     * returns
+     *      the channel, or -1 if every channel plays a more important sound
+     *      effect
+     */
+
+    const SoundSettings *settings = &SOUND_SETTINGS[sound];
+
+    // Free the channels that finished playing
+    for (int channel=0; channel<NUMBER_OF_VOICES; channel++) {
+        if (manager->voices[channel].sound >= 0 && !Mix_Playing(channel))
+            manager->voices[channel].sound = -1;
+    }
+
+    // Restart the oldest copy of the sound effect if there are too many
+    int instances = 0, oldest_instance = -1;
+    for (int channel=0; channel<NUMBER_OF_VOICES; channel++) {
+        const Voice *voice = &manager->voices[channel];
+        if (voice->sound != (int) sound)
+            continue;
+        instances++;
+        if (oldest_instance < 0 || voice->started_at < manager->voices[oldest_instance].started_at)
+            oldest_instance = channel;
+    }
+    if (instances >= settings->max_instances) {
+        manager->stats.stolen++;
+        return oldest_instance;
+    }
+
+    for (int channel=0; channel<NUMBER_OF_VOICES; channel++) {
+        if (manager->voices[channel].sound < 0)
+            return channel;
+    }
+
+    // Every channel is busy, so cut off the least important sound effect
+    int victim = -1;
+    for (int channel=0; channel<NUMBER_OF_VOICES; channel++) {
+        const Voice *voice = &manager->voices[channel];
+        if (voice->priority > settings->priority)
+            continue;
+        if (victim < 0 || voice->priority < manager->voices[victim].priority ||
+            (voice->priority == manager->voices[victim].priority &&
+             voice->started_at < manager->voices[victim].started_at))
+            victim = channel;
+    }
+    if (victim >= 0)
+        manager->stats.stolen++;
+    return victim;
+}
+
+static void measure_latency(void *data, Uint8 *stream, int length) {
+    /*
+     * A helper function, called by SDL_mixer on the audio thread whenever it
+     * mixed a buffer, that finishes measuring the latency of the sound
+     * effect played last.
+     *
+     * NOTE:
+     *  The buffer is only heard once the audio device played it, so the
+     *  time it takes to play is added to the latency.
+     */
+
+    (void) stream;
+    AudioLatency *latency = data;
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    SDL_AtomicLock(&latency->lock);
+    if (latency->played_at != 0 && latency->frame_size > 0) {
+        Uint64 output = (Uint64) (length / latency->frame_size) * SDL_GetPerformanceFrequency() / (Uint64) latency->frequency;
+        Uint64 measured = now - latency->played_at + output;
+        latency->measurements++;
+        latency->total += measured;
+        if (measured > latency->max)
+            latency->max = measured;
+        latency->played_at = 0;
+    }
+    SDL_AtomicUnlock(&latency->lock);
+}
+
+void init_voice_manager(VoiceManager *manager) {
+    /*
+     * A function that sets up the mixer channels of the sound effects, none
+     * of which plays anything yet, and starts measuring their latency.
+     *
+     * NOTE:
+     *  The manager must not move until `stop_voice_manager` is called.
+     */
+
+    Mix_AllocateChannels(NUMBER_OF_VOICES);
+
+    for (int channel=0; channel<NUMBER_OF_VOICES; channel++) {
+        manager->voices[channel] = (Voice) {.sound=-1, .priority=0, .started_at=0};
+    }
+    for (int sound=0; sound<NUMBER_OF_SOUND_EFFECTS; sound++) {
+        manager->last_played[sound] = 0;
+        manager->was_played[sound] = false;
+    }
+    manager->stats = (VoiceStats) {0, 0, 0, 0};
+    manager->latency = (AudioLatency) {0};
+    manager->key_pressed_at = 0;
+
+    int frequency, channels;
+    Uint16 format;
+    if (Mix_QuerySpec(&frequency, &format, &channels)) {
+        manager->latency.frequency = frequency;
+        manager->latency.frame_size = SDL_AUDIO_BITSIZE(format) / 8 * channels;
+        Mix_SetPostMix(measure_latency, &manager->latency);
+    }
+}
+
+void stop_voice_manager(VoiceManager *manager) {
+    /*
+     * A function that stops measuring the latency of the sound effects.
+     */
+
+    if (manager->latency.frame_size > 0)
+        Mix_SetPostMix(NULL, NULL);
+}
+
+void begin_key_sounds(VoiceManager *manager, Uint32 timestamp) {
+    /*
+     * A function that makes the sound effects played until `end_key_sounds`
+     * measure their latency from when a key was pressed.
+     *
+     * params
+     *      VoiceManager *manager
+     *          A pointer to the struct VoiceManager
+     *      Uint32 timestamp
+     *          The timestamp of the event of the key, in ms
+     *
+     * NOTE:
+     *  The timestamp is from `SDL_GetTicks`, so it is moved onto the
+     *  performance counter by how long ago it was.
+     */
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 age = (Uint64) (Uint32) (SDL_GetTicks() - timestamp) * SDL_GetPerformanceFrequency() / 1000;
+    manager->key_pressed_at = age < now ? now - age : now;
+}
+
+void end_key_sounds(VoiceManager *manager) {
+    /*
+     * A function that makes the sound effects measure their latency from
+     * when they are played again.
+     */
+
+    manager->key_pressed_at = 0;
+}
+
+void play_sound(Assets *assets, enum SoundEffect sound) {
+    /*
+     * A function that plays a sound effect once, unless it was just played
+     * or every channel plays a more important one.
+     *
+     * params
+     *      Assets *assets
+     *          A pointer to the struct Assets that holds the sounds and the
+     *          voice manager
+     *      enum SoundEffect sound
+     *          The sound effect to be played. It is skipped if it was not
+     *          loaded yet.
+     */
+
+    VoiceManager *manager = &assets->voices;
+    Mix_Chunk *chunk = get_sound_chunk(assets, sound);
+    if (!chunk)
+        return;
+
+    Uint32 now = SDL_GetTicks();
+    if (manager->was_played[sound] && now - manager->last_played[sound] < SOUND_SETTINGS[sound].coalesce_window) {
+        manager->stats.coalesced++;
+        return;
+    }
+
+    int channel = find_voice(manager, sound);
+    if (channel < 0 || Mix_PlayChannel(channel, chunk, 0) < 0) {
+        manager->stats.dropped++;
+        return;
+    }
+
+    manager->voices[channel] = (Voice) {.sound=sound, .priority=SOUND_SETTINGS[sound].priority, .started_at=now};
+    manager->last_played[sound] = now;
+    manager->was_played[sound] = true;
+    manager->stats.played++;
+
+    // Measure from the key, or from now, until the sound effect is mixed,
+    // unless another one is already waiting to be
+    SDL_AtomicLock(&manager->latency.lock);
+    if (manager->latency.played_at == 0)
+        manager->latency.played_at = manager->key_pressed_at != 0 ? manager->key_pressed_at : SDL_GetPerformanceCounter();
+    SDL_AtomicUnlock(&manager->latency.lock);
+}
+
+void print_audio_stats(Assets *assets) {
+    /*
+     * A function that reports what happened to the sound effects that were
+     * played, how much memory their samples use, and how long they took to
+     * be heard.
+     *
+     * NOTE:
+     *  The samples of the sounds in the asset pack are not copied, so they
+     *  use the memory the pack is mapped into.
+     */
+
+    VoiceManager *manager = &assets->voices;
+    printf("Sound effects: %lu played, %lu coalesced, %lu stolen, %lu dropped, %d voices\n",
+           manager->stats.played, manager->stats.coalesced, manager->stats.stolen,
+           manager->stats.dropped, NUMBER_OF_VOICES);
+
+    size_t bytes = 0, copied_bytes = 0;
+    for (int sound=0; sound<NUMBER_OF_SOUND_EFFECTS; sound++) {
+        const Mix_Chunk *chunk = get_sound_chunk(assets, sound);
+        if (!chunk)
+            continue;
+        bytes += chunk->alen;
+        if (chunk->allocated)
+            copied_bytes += chunk->alen;
+    }
+    printf("Sound memory: %.1f KB, of which %.1f KB was loaded from files outside the asset pack\n",
+           (double) bytes / 1024.0, (double) copied_bytes / 1024.0);
+
+    SDL_AtomicLock(&manager->latency.lock);
+    AudioLatency latency = manager->latency;
+    SDL_AtomicUnlock(&manager->latency.lock);
+    double ticks_per_ms = (double) SDL_GetPerformanceFrequency() / 1000.0;
+    if (latency.measurements > 0)
+        printf("Key-to-sound latency: %.1f ms on average, %.1f ms at most, over %lu sounds\n",
+               (double) latency.total / (double) latency.measurements / ticks_per_ms,
+               (double) latency.max / ticks_per_ms, latency.measurements);
+}
@@ -0,0 +1,18 @@
+#ifndef VOICES_H
+#define VOICES_H
+
+#include "declarations.h"
+
+void init_voice_manager(VoiceManager *manager);
+
+void stop_voice_manager(VoiceManager *manager);
+
+void begin_key_sounds(VoiceManager *manager, Uint32 timestamp);
+
+void end_key_sounds(VoiceManager *manager);
+
+void play_sound(Assets *assets, enum SoundEffect sound);
+
+void print_audio_stats(Assets *assets);
+
+#endif // !VOICES_H
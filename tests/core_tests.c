@@ -0,0 +1,288 @@
+/*
+ * This file, 'core_tests.c', checks the fast parts of the game core against
+ * the plain ones they replaced, on many random boards:
+ *
+ *      - a BitBoard holds the same game as its Board, counts the same
+ *        impassable neighbors, and resolves every move the same way;
+ *      - the solver finds the same par as a breadth-first search over every
+ *        position and set of eaten food pieces, and `is_board_solvable`
+ *        agrees with both.
+ *
+ * usage
+ *      ghostless-pacman-core-tests [<number of boards>]
+ *
+ *      It prints the first mistake it finds and exits with status 1, or
+ *      exits with status 0 when every check passed. It needs no SDL, so it
+ *      is built with the game core alone.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "core/bitboard.h"
+#include "core/board.h"
+#include "core/random.h"
+#include "core/solver.h"
+
+// The boards checked by default, of every number of foods
+#define DEFAULT_NUMBER_OF_BOARDS 2000
+
+// The most random moves played on each board
+#define MAX_MOVES_PER_BOARD 64
+
+// The most blocks on the boards that are placed without the rules of
+// `generate_board`, so that many of them cannot be won
+#define MAX_RANDOM_BLOCKS 40
+
+#define NUMBER_OF_CELLS (BOARD_SIZE * BOARD_SIZE)
+
+static int number_of_failures = 0;
+
+static void fail(const char *check, uint64_t seed, int step) {
+    /*
+     * A helper function that reports a check that did not pass.
+     *
+     * params
+     *      const char *check
+     *          What was checked
+     *      uint64_t seed
+     *          The seed of the board, so that it can be checked again
+     *      int step
+     *          The number of moves made on the board so far
+     */
+
+    if (number_of_failures < 10)
+        printf("FAILED %s, on the board with seed %llu, after %d moves\n", check, (unsigned long long) seed, step);
+    number_of_failures++;
+}
+
+static bool boards_are_equal(const Board *a, const Board *b) {
+    /*
+     * A helper function that compares the parts of two boards a BitBoard
+     * keeps.
+     */
+
+    return memcmp(a->array, b->array, sizeof(a->array)) == 0 &&
+           a->pacman_position.row == b->pacman_position.row &&
+           a->pacman_position.col == b->pacman_position.col &&
+           a->number_of_foods == b->number_of_foods &&
+           a->total_player_score == b->total_player_score;
+}
+
+static void check_bitboard(const Board *board, uint64_t seed, int step) {
+    /*
+     * A helper function that checks that a BitBoard built from `board` turns
+     * back into the same board, and counts the same impassable neighbors.
+     */
+
+    BitBoard bitboard;
+    bitboard_from_board(&bitboard, board);
+
+    Board round_trip = *board;
+    bitboard_to_board(&bitboard, &round_trip);
+    if (!boards_are_equal(board, &round_trip) || round_trip.number_of_blocks != board->number_of_blocks)
+        fail("bitboard round trip", seed, step);
+
+    for (int row=0; row<BOARD_SIZE; row++) {
+        for (int col=0; col<BOARD_SIZE; col++) {
+            if (count_impassable_neighbors(board, row, col) != bitboard_count_impassable_neighbors(&bitboard, row, col)) {
+                fail("impassable neighbors", seed, step);
+                return;
+            }
+        }
+    }
+}
+
+static int find_par(const Board *board) {
+    /*
+     * A helper function that finds the par of a board by brute force, with a
+     * breadth-first search over every position of Pacman and set of eaten
+     * food pieces, which follows the rules of `resolve_move` directly.
+     *
+     * returns
+     *      the least number of moves needed to win, or BOARD_UNSOLVABLE
+     */
+
+    int food_index[NUMBER_OF_CELLS];
+    int number_of_foods = 0;
+    for (int cell=0; cell<NUMBER_OF_CELLS; cell++) {
+        food_index[cell] = board->array[cell / BOARD_SIZE][cell % BOARD_SIZE] == FOOD ? number_of_foods++ : -1;
+    }
+    int all_eaten = (1 << number_of_foods) - 1;
+
+    static int distances[NUMBER_OF_CELLS << MAX_NUMBER_OF_FOOD];
+    static int queue[NUMBER_OF_CELLS << MAX_NUMBER_OF_FOOD];
+    int number_of_states = NUMBER_OF_CELLS << number_of_foods;
+    for (int state=0; state<number_of_states; state++) {
+        distances[state] = -1;
+    }
+
+    static const int row_steps[4] = {-1, 1, 0, 0};
+    static const int col_steps[4] = {0, 0, -1, 1};
+
+    // A state is the eaten food pieces, times the number of cells, plus the
+    // cell of Pacman
+    int start = board->pacman_position.row * BOARD_SIZE + board->pacman_position.col;
+    int head = 0, tail = 0;
+    distances[start] = 0;
+    queue[tail++] = start;
+
+    while (head < tail) {
+        int state = queue[head++];
+        int cell = state % NUMBER_OF_CELLS;
+        int eaten = state / NUMBER_OF_CELLS;
+
+        for (int move=0; move<4; move++) {
+            int row = cell / BOARD_SIZE + row_steps[move];
+            int col = cell % BOARD_SIZE + col_steps[move];
+            if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE)
+                continue;
+
+            int next_cell = row * BOARD_SIZE + col;
+            int next_eaten = eaten;
+            switch (board->array[row][col]) {
+                case BLOCK:
+                    continue;
+                case EXIT:
+                    // States are taken in order of distance, so the first
+                    // win is the shortest
+                    if (eaten == all_eaten)
+                        return distances[state] + 1;
+                    continue;
+                case FOOD:
+                    next_eaten |= 1 << food_index[next_cell];
+                    break;
+                default:
+                    break;
+            }
+
+            int next_state = next_eaten * NUMBER_OF_CELLS + next_cell;
+            if (distances[next_state] < 0) {
+                distances[next_state] = distances[state] + 1;
+                queue[tail++] = next_state;
+            }
+        }
+    }
+    return BOARD_UNSOLVABLE;
+}
+
+static void check_solver(const Board *board, uint64_t seed, int step) {
+    /*
+     * A helper function that checks the solver and `is_board_solvable`
+     * against the brute force search.
+     */
+
+    int par = find_par(board);
+
+    BoardSolution solution;
+    bool is_solved = solve_board(board, &solution);
+    if (is_solved != (par != BOARD_UNSOLVABLE) || (is_solved && solution.par != par))
+        fail("solver par", seed, step);
+    if (is_board_solvable(board) != (par != BOARD_UNSOLVABLE))
+        fail("is_board_solvable", seed, step);
+}
+
+static void place_random_board(Board *board, RandomGenerator *generator, int number_of_foods) {
+    /*
+     * A helper function that places up to MAX_RANDOM_BLOCKS blocks, the exit
+     * and the foods anywhere on the board, without the rules of
+     * `generate_board`, so that many of the boards cannot be won.
+     */
+
+    memset(board, 0, sizeof(Board));
+    board->array[0][0] = PACMAN;
+    board->number_of_foods = number_of_foods;
+
+    int number_of_blocks = gen_random_num(generator, 0, MAX_RANDOM_BLOCKS);
+    int elements = number_of_blocks + 1 + number_of_foods;
+    for (int i=0; i<elements; i++) {
+        int cell;
+        do {
+            cell = gen_random_num(generator, 0, NUMBER_OF_CELLS - 1);
+        } while (board->array[cell / BOARD_SIZE][cell % BOARD_SIZE] != EMPTY);
+
+        enum BoardElement element = i < number_of_blocks ? BLOCK : i == number_of_blocks ? EXIT : FOOD;
+        board->array[cell / BOARD_SIZE][cell % BOARD_SIZE] = element;
+    }
+    board->number_of_blocks = number_of_blocks;
+}
+
+static void play_random_moves(Board *board, RandomGenerator *generator, uint64_t seed) {
+    /*
+     * A helper function that plays random moves on a board and on its
+     * BitBoard side by side, until the game is over, and checks that both
+     * resolve every move the same way. Every position on the way is checked
+     * as well.
+     */
+
+    BitBoard bitboard;
+    bitboard_from_board(&bitboard, board);
+
+    for (int step=0; step<MAX_MOVES_PER_BOARD; step++) {
+        check_bitboard(board, seed, step);
+        check_solver(board, seed, step);
+
+        enum PacmanMove move = (enum PacmanMove) gen_random_num(generator, MOVE_PACMAN_UP, MOVE_PACMAN_RIGHT);
+        MoveResult expected = resolve_move(board, move);
+        MoveResult result = bitboard_resolve_move(&bitboard, move);
+
+        if (result.game_state != expected.game_state || result.events != expected.events ||
+            result.next_position.row != expected.next_position.row ||
+            result.next_position.col != expected.next_position.col) {
+            fail("move result", seed, step);
+            return;
+        }
+
+        Board moved = *board;
+        bitboard_to_board(&bitboard, &moved);
+        if (!boards_are_equal(board, &moved)) {
+            fail("board after a move", seed, step);
+            return;
+        }
+
+        if (expected.game_state != GAME_IN_PROGRESS)
+            return;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int number_of_boards = argc > 1 ? atoi(argv[1]) : DEFAULT_NUMBER_OF_BOARDS;
+    if (number_of_boards <= 0) {
+        printf("usage: %s [<number of boards>]\n", argv[0]);
+        return 1;
+    }
+
+    int number_of_unsolvable = 0;
+    for (int i=0; i<number_of_boards; i++) {
+        uint64_t seed = (uint64_t) i;
+        int number_of_foods = MIN_NUMBER_OF_FOOD + i % (MAX_NUMBER_OF_FOOD - MIN_NUMBER_OF_FOOD + 1);
+
+        RandomGenerator generator;
+        seed_random_generator(&generator, seed);
+
+        // Every other board follows the rules of the game, and can be won
+        Board board;
+        if (i % 2 == 0) {
+            if (generate_board(&board, number_of_foods, seed) < 0) {
+                fail("generate_board", seed, 0);
+                continue;
+            }
+        } else {
+            place_random_board(&board, &generator, number_of_foods);
+            if (!is_board_solvable(&board))
+                number_of_unsolvable++;
+        }
+
+        play_random_moves(&board, &generator, seed);
+    }
+
+    if (number_of_failures > 0) {
+        printf("%d checks failed\n", number_of_failures);
+        return 1;
+    }
+    printf("Checked %d boards, %d of which cannot be won, and the moves played on them\n",
+           number_of_boards, number_of_unsolvable);
+    return 0;
+}
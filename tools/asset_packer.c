@@ -0,0 +1,375 @@
+/*
+ *  This file, `asset_packer.c`, contains the build tool that writes the asset
+ *  pack: the atlas pages as run-length encoded RGBA pixels, the sounds as raw
+ *  samples in the format the game opens the audio device with, without the
+ *  silence around them, and the music as it is.
+ *
+ *  usage
+ *      asset_packer <pack file> <sound or music>...
+ *
+ *      It must run from the bin/ folder, after `atlas_packer`, since the
+ *      pages and the sounds are found there just like the game finds them.
+ *      The list of pages comes from the atlas table this tool is compiled
+ *      with. Every file that is not a WAV file is packed as music.
+ *
+ *  NOTE:
+ *      The music is not decoded, since it is streamed while it plays, so
+ *      decoding it ahead of time would only make the pack larger.
+ *
+ *      The pages are mostly transparent, so runs of the same pixel shrink
+ *      them about eight times, while decoding them is hardly slower than
+ *      copying them.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_image.h"
+
+#include "atlas.h"
+#include "asset_pack.h"
+#include "declarations.h"
+
+/*
+ * PackedAsset is an asset that was decoded, waiting to be written.
+ */
+typedef struct PackedAsset {
+    AssetPackEntry  entry;
+    void            *data;
+} PackedAsset;
+
+static uint64_t encode_runs(const uint32_t *pixels, uint64_t number_of_pixels, unsigned char *runs) {
+    /*
+     * A helper function that run-length encodes pixels, in the format that
+     * `unpack_asset_image` decodes.
+     *
+     * params
+     *      unsigned char *runs
+     *          Room for at least `number_of_pixels` * 4 bytes, plus one byte
+     *          for every ASSET_RLE_MAX_PIXELS of them
+     * returns
+     *      The number of bytes written to `runs`
+     */
+
+    uint64_t size = 0;
+    uint64_t i = 0;
+    while (i < number_of_pixels) {
+        uint64_t length = 1;
+        while (i + length < number_of_pixels && length < ASSET_RLE_MAX_PIXELS && pixels[i + length] == pixels[i])
+            length++;
+
+        if (length > 1) {
+            runs[size++] = (unsigned char) (ASSET_RLE_REPEAT | (length - 1));
+            memcpy(runs + size, &pixels[i], 4);
+            size += 4;
+            i += length;
+            continue;
+        }
+
+        // Different pixels go on until the next one that repeats
+        length = 0;
+        while (i + length < number_of_pixels && length < ASSET_RLE_MAX_PIXELS &&
+               (i + length + 1 == number_of_pixels || pixels[i + length + 1] != pixels[i + length]))
+            length++;
+
+        runs[size++] = (unsigned char) (length - 1);
+        memcpy(runs + size, &pixels[i], length * 4);
+        size += length * 4;
+        i += length;
+    }
+    return size;
+}
+
+static void compress_image(PackedAsset *asset) {
+    /*
+     * A helper function that run-length encodes the pixels of an image, if
+     * that makes it smaller.
+     */
+
+    uint64_t number_of_pixels = asset->entry.size / 4;
+    unsigned char *runs = malloc(asset->entry.size + number_of_pixels / ASSET_RLE_MAX_PIXELS + 1);
+    if (!runs)
+        return;
+
+    uint64_t size = encode_runs(asset->data, number_of_pixels, runs);
+    if (size >= asset->entry.size) {
+        free(runs);
+        return;
+    }
+
+    free(asset->data);
+    asset->data = runs;
+    asset->entry.size = size;
+    asset->entry.compression = ASSET_COMPRESSION_RLE;
+}
+
+static bool decode_image(const char *filename, PackedAsset *asset) {
+    /*
+     * A helper function that decodes an image into RGBA pixels.
+     */
+
+    SDL_Surface *loaded = IMG_Load(filename);
+    if (!loaded) {
+        printf("Error loading %s: %s\n", filename, IMG_GetError());
+        return false;
+    }
+
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!converted) {
+        printf("Error converting %s: %s\n", filename, SDL_GetError());
+        return false;
+    }
+
+    // Drop the padding at the end of the rows, if any
+    uint32_t pitch = (uint32_t) converted->w * 4;
+    asset->entry.type = ASSET_IMAGE;
+    asset->entry.width = (uint32_t) converted->w;
+    asset->entry.height = (uint32_t) converted->h;
+    asset->entry.pitch = pitch;
+    asset->entry.pixel_format = SDL_PIXELFORMAT_RGBA32;
+    asset->entry.size = (uint64_t) pitch * converted->h;
+    asset->data = malloc(asset->entry.size);
+
+    if (asset->data) {
+        SDL_LockSurface(converted);
+        for (int row=0; row<converted->h; row++) {
+            memcpy((unsigned char *) asset->data + row * pitch,
+                   (unsigned char *) converted->pixels + row * converted->pitch, pitch);
+        }
+        SDL_UnlockSurface(converted);
+    }
+
+    SDL_FreeSurface(converted);
+    if (!asset->data)
+        return false;
+
+    compress_image(asset);
+    return true;
+}
+
+// Samples quieter than this, about -60 dB, are silent
+#define SILENCE_THRESHOLD 32
+
+static uint64_t trim_silence(Uint8 *samples, uint64_t size) {
+    /*
+     * A helper function that removes the silence at the start and at the end
+     * of a sound, so that it is heard as soon as it plays and takes no more
+     * memory than it needs.
+     *
+     * params
+     *      Uint8 *samples
+     *          The samples, in AUDIO_FORMAT and AUDIO_CHANNELS, which are
+     *          moved to the start of the buffer
+     *      uint64_t size
+     *          The size of the samples, in bytes
+     * returns
+     *      the size of the trimmed samples, in bytes
+     *
+     * NOTE:
+     *  Only 16 bit samples are trimmed, which the audio device is opened with.
+     */
+
+    const Sint16 *frames = (const Sint16 *) samples;
+    uint64_t number_of_frames = size / (sizeof(Sint16) * AUDIO_CHANNELS);
+    if (AUDIO_FORMAT != AUDIO_S16SYS || number_of_frames == 0)
+        return size;
+
+    uint64_t first = number_of_frames, last = 0;
+    for (uint64_t frame=0; frame<number_of_frames; frame++) {
+        for (int channel=0; channel<AUDIO_CHANNELS; channel++) {
+            int sample = frames[frame * AUDIO_CHANNELS + channel];
+            if (sample > SILENCE_THRESHOLD || sample < -SILENCE_THRESHOLD) {
+                if (first == number_of_frames)
+                    first = frame;
+                last = frame;
+            }
+        }
+    }
+
+    // Keep a single frame of a sound that is silent throughout
+    if (first == number_of_frames)
+        first = last = 0;
+
+    size_t frame_size = sizeof(Sint16) * AUDIO_CHANNELS;
+    uint64_t trimmed_size = (last - first + 1) * frame_size;
+    memmove(samples, samples + first * frame_size, (size_t) trimmed_size);
+    return trimmed_size;
+}
+
+static bool decode_sound(const char *filename, PackedAsset *asset) {
+    /*
+     * A helper function that decodes a WAV file, converts its samples to
+     * AUDIO_FORMAT, AUDIO_CHANNELS and AUDIO_FREQUENCY, and trims its silence.
+     */
+
+    SDL_AudioSpec spec;
+    Uint8 *samples;
+    Uint32 length;
+    if (!SDL_LoadWAV(filename, &spec, &samples, &length)) {
+        printf("Error loading %s: %s\n", filename, SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioCVT converter;
+    if (SDL_BuildAudioCVT(&converter, spec.format, spec.channels, spec.freq,
+                          AUDIO_FORMAT, AUDIO_CHANNELS, AUDIO_FREQUENCY) < 0) {
+        printf("Error converting %s: %s\n", filename, SDL_GetError());
+        SDL_FreeWAV(samples);
+        return false;
+    }
+
+    converter.len = (int) length;
+    converter.buf = malloc((size_t) length * converter.len_mult);
+    if (!converter.buf) {
+        SDL_FreeWAV(samples);
+        return false;
+    }
+    memcpy(converter.buf, samples, length);
+    SDL_FreeWAV(samples);
+
+    if (converter.needed && SDL_ConvertAudio(&converter) < 0) {
+        printf("Error converting %s: %s\n", filename, SDL_GetError());
+        free(converter.buf);
+        return false;
+    }
+
+    asset->entry.type = ASSET_SOUND;
+    asset->entry.frequency = AUDIO_FREQUENCY;
+    asset->entry.channels = AUDIO_CHANNELS;
+    asset->entry.audio_format = AUDIO_FORMAT;
+    uint64_t size = (uint64_t) (converter.needed ? converter.len_cvt : converter.len);
+    asset->entry.size = trim_silence(converter.buf, size);
+    asset->data = converter.buf;
+    return true;
+}
+
+static bool copy_music(const char *filename, PackedAsset *asset) {
+    /*
+     * A helper function that reads a music file as it is.
+     */
+
+    SDL_RWops *file = SDL_RWFromFile(filename, "rb");
+    if (!file) {
+        printf("Error loading %s: %s\n", filename, SDL_GetError());
+        return false;
+    }
+
+    Sint64 size = SDL_RWsize(file);
+    asset->data = size > 0 ? malloc((size_t) size) : NULL;
+    bool is_read = asset->data && SDL_RWread(file, asset->data, 1, (size_t) size) == (size_t) size;
+    SDL_RWclose(file);
+
+    if (!is_read) {
+        printf("Error reading %s\n", filename);
+        return false;
+    }
+
+    asset->entry.type = ASSET_MUSIC;
+    asset->entry.size = (uint64_t) size;
+    return true;
+}
+
+static bool is_wav_file(const char *filename) {
+    size_t length = strlen(filename);
+    return length >= 4 && SDL_strcasecmp(filename + length - 4, ".wav") == 0;
+}
+
+static bool write_pack(PackedAsset *assets, int number_of_assets, const char *pack_filename) {
+    /*
+     * A helper function that writes the header, the entries and the data of
+     * every asset.
+     */
+
+    FILE *pack = fopen(pack_filename, "wb");
+    if (!pack) {
+        printf("Error writing %s\n", pack_filename);
+        return false;
+    }
+
+    // Place the data of every asset after the entries, aligned
+    uint64_t offset = sizeof(AssetPackHeader) + sizeof(AssetPackEntry) * (uint64_t) number_of_assets;
+    for (int i=0; i<number_of_assets; i++) {
+        offset = (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+        assets[i].entry.offset = offset;
+        offset += assets[i].entry.size;
+    }
+
+    AssetPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+    header.version = ASSET_PACK_VERSION;
+    header.number_of_entries = (uint32_t) number_of_assets;
+    fwrite(&header, sizeof(header), 1, pack);
+
+    for (int i=0; i<number_of_assets; i++) {
+        fwrite(&assets[i].entry, sizeof(AssetPackEntry), 1, pack);
+    }
+
+    static const unsigned char padding[ASSET_PACK_ALIGNMENT] = {0};
+    for (int i=0; i<number_of_assets; i++) {
+        long position = ftell(pack);
+        fwrite(padding, 1, (size_t) (assets[i].entry.offset - (uint64_t) position), pack);
+        fwrite(assets[i].data, 1, (size_t) assets[i].entry.size, pack);
+    }
+
+    bool written = !ferror(pack);
+    fclose(pack);
+    return written;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 2) {
+        printf("usage: %s <pack file> <sound or music>...\n", argv[0]);
+        return 1;
+    }
+
+    const char *pack_filename = argv[1];
+    int number_of_sounds = argc - 2;
+    int number_of_assets = NUMBER_OF_ATLAS_PAGES + number_of_sounds;
+
+    PackedAsset *assets = calloc(number_of_assets, sizeof(PackedAsset));
+    if (!assets)
+        return 1;
+
+    IMG_Init(IMG_INIT_PNG);
+
+    int status = 0;
+    for (int i=0; status == 0 && i<number_of_assets; i++) {
+        const char *filename = i < NUMBER_OF_ATLAS_PAGES ? ATLAS_PAGE_FILENAMES[i] : argv[2 + i - NUMBER_OF_ATLAS_PAGES];
+
+        if (strlen(filename) >= MAX_ASSET_NAME_LENGTH) {
+            printf("Error packing %s: its name is too long\n", filename);
+            status = 1;
+            break;
+        }
+        snprintf(assets[i].entry.name, MAX_ASSET_NAME_LENGTH, "%s", filename);
+
+        bool decoded;
+        if (i < NUMBER_OF_ATLAS_PAGES)
+            decoded = decode_image(filename, &assets[i]);
+        else if (is_wav_file(filename))
+            decoded = decode_sound(filename, &assets[i]);
+        else
+            decoded = copy_music(filename, &assets[i]);
+        if (!decoded)
+            status = 1;
+    }
+
+    if (status == 0 && !write_pack(assets, number_of_assets, pack_filename))
+        status = 1;
+
+    if (status == 0)
+        printf("Packed %d atlas pages and %d sounds into %s\n", NUMBER_OF_ATLAS_PAGES, number_of_sounds, pack_filename);
+
+    for (int i=0; i<number_of_assets; i++) {
+        free(assets[i].data);
+    }
+    free(assets);
+    IMG_Quit();
+    return status;
+}
@@ -0,0 +1,392 @@
+/*
+ *  This file, `atlas_packer.c`, contains the build tool that packs the images
+ *  of the game into a few large images, called atlas pages, and generates the
+ *  table that tells the game where each image was placed.
+ *
+ *  usage
+ *      atlas_packer <assets folder> <pages folder> <table file> <image>...
+ *
+ *      Every <image> is a path relative to the assets folder. The pages are
+ *      saved as atlas_0.png, atlas_1.png and so on, and the table is a C file
+ *      that is compiled into the game.
+ *
+ *  NOTE:
+ *      The images are sorted from the tallest to the shortest and placed on
+ *      shelves, left to right. A new shelf is started when an image does not
+ *      fit on the current one, and a new page when a shelf does not fit on
+ *      the current page.
+ *
+ *      The game loads a page only when one of its images is drawn, so the
+ *      images of a folder that fills a large part of a page, such as the
+ *      tutorial pages, are placed on pages of their own. The images of the
+ *      smaller folders share pages.
+ */
+
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_image.h"
+
+#include "declarations.h"
+
+// The largest width and height of an atlas page. Every renderer the game runs
+// on supports textures of at least this size.
+#define ATLAS_PAGE_SIZE 2048
+
+// The empty pixels between two images on a page
+#define ATLAS_PADDING 2
+
+// The number of times the border pixels of an image are repeated around it,
+// so that smoothly scaled sprites never blend with their neighbours
+#define ATLAS_EXTRUSION 1
+
+// The share of a page that the images of a folder must fill to be placed on
+// pages of their own
+#define ATLAS_OWN_PAGE_FRACTION 4
+
+#define MAX_GROUP_NAME_LENGTH 64
+
+// The folders that the game loads the images and the pages from, relative to
+// its working directory
+#define ASSETS_RUNTIME_FOLDER "../assets/"
+#define PAGES_RUNTIME_FOLDER "atlas/"
+
+/*
+ * PackedImage is an image and where it was placed in the atlas.
+ */
+typedef struct PackedImage {
+    const char      *filename;
+    // The folder of the image, if its images are placed on pages of their
+    // own, or "" if they share pages with other folders
+    char            group[MAX_GROUP_NAME_LENGTH];
+    SDL_Surface     *surface;
+    int             page;
+    SDL_Rect        rect;
+} PackedImage;
+
+static int compare_heights(const void *a, const void *b) {
+    /*
+     * A helper function that sorts the images by their group, and then from
+     * the tallest to the shortest, and from the widest to the narrowest.
+     */
+
+    const PackedImage *first = a;
+    const PackedImage *second = b;
+
+    int group = strcmp(first->group, second->group);
+    if (group != 0)
+        return group;
+
+    if (first->surface->h != second->surface->h)
+        return second->surface->h - first->surface->h;
+    if (first->surface->w != second->surface->w)
+        return second->surface->w - first->surface->w;
+    return strcmp(first->filename, second->filename);
+}
+
+static int compare_filenames(const void *a, const void *b) {
+    /*
+     * A helper function that sorts the images by their filename, so that the
+     * generated table does not depend on how the images were packed.
+     */
+
+    const PackedImage *first = a;
+    const PackedImage *second = b;
+    return strcmp(first->filename, second->filename);
+}
+
+static void get_folder(const char *filename, char *folder) {
+    /*
+     * A helper function that copies the top folder of a filename which is
+     * relative to the assets folder, or "" if there is none.
+     */
+
+    const char *slash = strchr(filename, '/');
+    size_t length = slash ? (size_t) (slash - filename) : 0;
+    if (length >= MAX_GROUP_NAME_LENGTH)
+        length = MAX_GROUP_NAME_LENGTH - 1;
+    memcpy(folder, filename, length);
+    folder[length] = '\0';
+}
+
+static void group_images(PackedImage *images, int number_of_images) {
+    /*
+     * A helper function that decides which folders are placed on pages of
+     * their own: the ones whose images fill at least 1/ATLAS_OWN_PAGE_FRACTION
+     * of a page.
+     */
+
+    for (int i=0; i<number_of_images; i++) {
+        char folder[MAX_GROUP_NAME_LENGTH];
+        get_folder(images[i].filename, folder);
+
+        long area = 0;
+        for (int j=0; j<number_of_images; j++) {
+            char other_folder[MAX_GROUP_NAME_LENGTH];
+            get_folder(images[j].filename, other_folder);
+            if (strcmp(folder, other_folder) == 0)
+                area += (long) images[j].surface->w * images[j].surface->h;
+        }
+
+        bool has_own_pages = folder[0] != '\0' &&
+                             area * ATLAS_OWN_PAGE_FRACTION >= (long) ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE;
+        snprintf(images[i].group, MAX_GROUP_NAME_LENGTH, "%s", has_own_pages ? folder : "");
+    }
+}
+
+static int pack_images(PackedImage *images, int number_of_images, SDL_Rect *page_sizes) {
+    /*
+     * A helper function that places every image on a page.
+     *
+     * params
+     *      PackedImage *images
+     *          The images to be placed, sorted by `compare_heights`
+     *      int number_of_images
+     *          The number of images
+     *      SDL_Rect *page_sizes
+     *          Receives the width and height each page needs
+     * returns
+     *      the number of pages used, or -1 if an image does not fit
+     */
+
+    int page = 0;
+    int shelf_x = 0;
+    int shelf_y = 0;
+    int shelf_height = 0;
+
+    page_sizes[0] = (SDL_Rect) {0, 0, 0, 0};
+
+    for (int i=0; i<number_of_images; i++) {
+        int slot_width  = images[i].surface->w + 2 * ATLAS_EXTRUSION;
+        int slot_height = images[i].surface->h + 2 * ATLAS_EXTRUSION;
+
+        if (slot_width > ATLAS_PAGE_SIZE || slot_height > ATLAS_PAGE_SIZE) {
+            printf("Error packing %s: it is larger than an atlas page\n", images[i].filename);
+            return -1;
+        }
+
+        // Start a new shelf when the image does not fit on the current one
+        bool starts_group = i > 0 && strcmp(images[i].group, images[i - 1].group) != 0;
+        if (!starts_group && shelf_x + slot_width > ATLAS_PAGE_SIZE) {
+            shelf_y += shelf_height + ATLAS_PADDING;
+            shelf_x = 0;
+            shelf_height = 0;
+        }
+
+        // Start a new page when the shelf does not fit on the current one,
+        // or when the image is the first of a group
+        if (starts_group || shelf_y + slot_height > ATLAS_PAGE_SIZE) {
+            page++;
+            if (page == MAX_ATLAS_PAGES) {
+                printf("Error packing %s: the images need more than %d atlas pages\n", images[i].filename, MAX_ATLAS_PAGES);
+                return -1;
+            }
+            page_sizes[page] = (SDL_Rect) {0, 0, 0, 0};
+            shelf_x = 0;
+            shelf_y = 0;
+            shelf_height = 0;
+        }
+
+        images[i].page = page;
+        images[i].rect = (SDL_Rect) {
+            shelf_x + ATLAS_EXTRUSION,
+            shelf_y + ATLAS_EXTRUSION,
+            images[i].surface->w,
+            images[i].surface->h
+        };
+
+        shelf_x += slot_width + ATLAS_PADDING;
+        if (slot_height > shelf_height)
+            shelf_height = slot_height;
+
+        if (shelf_x > page_sizes[page].w)
+            page_sizes[page].w = shelf_x;
+        if (shelf_y + slot_height > page_sizes[page].h)
+            page_sizes[page].h = shelf_y + slot_height;
+    }
+
+    return page + 1;
+}
+
+static void extrude_image(SDL_Surface *page, SDL_Rect rect) {
+    /*
+     * A helper function that repeats the border pixels of the image placed
+     * at `rect` on `page` into the ATLAS_EXTRUSION pixels around it.
+     *
+     * NOTE:
+     *  The page must be locked and its pixels must be 32 bits each.
+     */
+
+    Uint32 *pixels = page->pixels;
+    int stride = page->pitch / 4;
+
+    for (int i=1; i<=ATLAS_EXTRUSION; i++) {
+        // The rows above and below, including the corners
+        for (int x=rect.x - i; x<rect.x + rect.w + i; x++) {
+            int source_x = x < rect.x ? rect.x : (x >= rect.x + rect.w ? rect.x + rect.w - 1 : x);
+            pixels[(rect.y - i) * stride + x] = pixels[rect.y * stride + source_x];
+            pixels[(rect.y + rect.h - 1 + i) * stride + x] = pixels[(rect.y + rect.h - 1) * stride + source_x];
+        }
+        // The columns to the left and to the right
+        for (int y=rect.y; y<rect.y + rect.h; y++) {
+            pixels[y * stride + rect.x - i] = pixels[y * stride + rect.x];
+            pixels[y * stride + rect.x + rect.w - 1 + i] = pixels[y * stride + rect.x + rect.w - 1];
+        }
+    }
+}
+
+static bool save_page(PackedImage *images, int number_of_images, int page, SDL_Rect size, const char *pages_folder) {
+    /*
+     * A helper function that draws the images placed on `page` and saves it
+     * as a PNG file.
+     */
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, size.w, size.h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+        printf("Error creating atlas page: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // The new surface is fully transparent. Its pixels are replaced, rather
+    // than blended with, the pixels of the images.
+    for (int i=0; i<number_of_images; i++) {
+        if (images[i].page != page)
+            continue;
+        SDL_Rect destination = images[i].rect;
+        SDL_SetSurfaceBlendMode(images[i].surface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(images[i].surface, NULL, surface, &destination);
+    }
+
+    SDL_LockSurface(surface);
+    for (int i=0; i<number_of_images; i++) {
+        if (images[i].page == page)
+            extrude_image(surface, images[i].rect);
+    }
+    SDL_UnlockSurface(surface);
+
+    char filename[1024];
+    snprintf(filename, sizeof(filename), "%s/atlas_%d.png", pages_folder, page);
+
+    bool saved = IMG_SavePNG(surface, filename) == 0;
+    if (!saved)
+        printf("Error saving %s: %s\n", filename, SDL_GetError());
+
+    SDL_FreeSurface(surface);
+    return saved;
+}
+
+static bool write_table(PackedImage *images, int number_of_images, int number_of_pages, const char *table_filename) {
+    /*
+     * A helper function that writes the C file which holds where every image
+     * was placed.
+     */
+
+    FILE *table = fopen(table_filename, "w");
+    if (!table) {
+        printf("Error writing %s\n", table_filename);
+        return false;
+    }
+
+    fprintf(table, "/*\n");
+    fprintf(table, " *  This file was generated by `tools/atlas_packer.c`. Do not edit it.\n");
+    fprintf(table, " */\n\n");
+    fprintf(table, "#include \"atlas.h\"\n\n");
+
+    fprintf(table, "const int NUMBER_OF_ATLAS_PAGES = %d;\n\n", number_of_pages);
+    fprintf(table, "const char *const ATLAS_PAGE_FILENAMES[] = {\n");
+    for (int page=0; page<number_of_pages; page++) {
+        fprintf(table, "    \"%satlas_%d.png\",\n", PAGES_RUNTIME_FOLDER, page);
+    }
+    fprintf(table, "};\n\n");
+
+    fprintf(table, "const int NUMBER_OF_ATLAS_ENTRIES = %d;\n\n", number_of_images);
+    fprintf(table, "const AtlasEntry ATLAS_ENTRIES[] = {\n");
+    for (int i=0; i<number_of_images; i++) {
+        fprintf(table, "    { \"%s%s\", %d, { %d, %d, %d, %d } },\n",
+                ASSETS_RUNTIME_FOLDER, images[i].filename, images[i].page,
+                images[i].rect.x, images[i].rect.y, images[i].rect.w, images[i].rect.h);
+    }
+    fprintf(table, "};\n");
+
+    bool written = !ferror(table);
+    fclose(table);
+    return written;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 4) {
+        printf("usage: %s <assets folder> <pages folder> <table file> <image>...\n", argv[0]);
+        return 1;
+    }
+
+    const char *assets_folder = argv[1];
+    const char *pages_folder = argv[2];
+    const char *table_filename = argv[3];
+    int number_of_images = argc - 4;
+
+    PackedImage *images = calloc(number_of_images > 0 ? number_of_images : 1, sizeof(PackedImage));
+    if (!images)
+        return 1;
+
+    IMG_Init(IMG_INIT_PNG);
+
+    int status = 0;
+    for (int i=0; i<number_of_images; i++) {
+        char filename[1024];
+        snprintf(filename, sizeof(filename), "%s/%s", assets_folder, argv[i + 4]);
+
+        SDL_Surface *loaded = IMG_Load(filename);
+        if (!loaded) {
+            printf("Error loading %s: %s\n", filename, IMG_GetError());
+            status = 1;
+            break;
+        }
+
+        // Every page is RGBA, so convert the images before placing them
+        images[i].filename = argv[i + 4];
+        images[i].surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if (!images[i].surface) {
+            printf("Error converting %s: %s\n", filename, SDL_GetError());
+            status = 1;
+            break;
+        }
+    }
+
+    SDL_Rect page_sizes[MAX_ATLAS_PAGES];
+    int number_of_pages = 0;
+
+    if (status == 0) {
+        group_images(images, number_of_images);
+        qsort(images, number_of_images, sizeof(PackedImage), compare_heights);
+        number_of_pages = pack_images(images, number_of_images, page_sizes);
+        if (number_of_pages < 0)
+            status = 1;
+    }
+
+    for (int page=0; status == 0 && page<number_of_pages; page++) {
+        if (!save_page(images, number_of_images, page, page_sizes[page], pages_folder))
+            status = 1;
+    }
+
+    if (status == 0) {
+        qsort(images, number_of_images, sizeof(PackedImage), compare_filenames);
+        if (!write_table(images, number_of_images, number_of_pages, table_filename))
+            status = 1;
+    }
+
+    if (status == 0)
+        printf("Packed %d images into %d atlas pages\n", number_of_images, number_of_pages);
+
+    for (int i=0; i<number_of_images; i++) {
+        if (images[i].surface)
+            SDL_FreeSurface(images[i].surface);
+    }
+    free(images);
+    IMG_Quit();
+    return status;
+}